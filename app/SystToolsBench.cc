@@ -0,0 +1,554 @@
+#include "systematicstools/interface/EventResponsePool.hh"
+
+#include "systematicstools/interpreters/BinnedLikelihood.hh"
+#include "systematicstools/interpreters/EventSplineCacheHelper.hh"
+#include "systematicstools/interpreters/InterpolationSchemes.hh"
+#include "systematicstools/interpreters/ParamHeaderHelper.hh"
+#include "systematicstools/interpreters/PolyResponse.hh"
+#include "systematicstools/interpreters/ResponseModel.hh"
+#include "systematicstools/interpreters/SplineResponse.hh"
+#include "systematicstools/interpreters/ValidatedResponseView.hh"
+
+#include "systematicstools/utility/AllocationCounter.hh"
+#include "systematicstools/utility/SyntheticResponseGenerator.hh"
+
+#ifdef SYSTTOOLS_BENCH_HAVE_CLHEP
+#include "systematicstools/utility/CovMatThrower.hh"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace systtools;
+
+// Microbenchmark suite for the interpreter layer, results are written as JSON
+// so that they can be compared across releases.
+
+size_t NEventUnits = 10000;
+size_t NSplineParams = 10;
+size_t NDiscreteParams = 2;
+size_t NKnots = 7;
+size_t NThrows = 100;
+double ParamOccupancy = 1;
+size_t NRepeats = 5;
+std::string OutputFile = "";
+
+volatile double gSink = 0;
+
+void SayUsage(char const *argv[]) {
+  std::cout
+      << "[USAGE]: " << argv[0] << "\n"
+      << "\t-n <NEventUnits=10000>   : Number of synthetic event units.\n"
+      << "\t-p <NSplineParams=10>    : Number of spline parameters.\n"
+      << "\t-d <NDiscreteParams=2>   : Number of multisim parameters.\n"
+      << "\t-k <NKnots=7>            : Number of knots per spline.\n"
+      << "\t-t <NThrows=100>         : Number of throws per multisim.\n"
+      << "\t-f <ParamOccupancy=1>    : Fraction of parameters with a "
+         "response in\n"
+      << "\t                           each event unit.\n"
+      << "\t-r <NRepeats=5>          : Report the best of NRepeats runs.\n"
+      << "\t-o <output.json>         : Write JSON results to a file rather "
+         "than stdout."
+      << std::endl;
+}
+
+void HandleOpts(int argc, char const *argv[]) {
+  for (int opt_it = 1; opt_it < argc; ++opt_it) {
+    std::string arg = argv[opt_it];
+    if ((arg == "-?") || (arg == "--help")) {
+      SayUsage(argv);
+      exit(0);
+    }
+    if ((opt_it + 1) >= argc) {
+      std::cout << "[ERROR]: Option " << arg << " expects a value."
+                << std::endl;
+      SayUsage(argv);
+      exit(1);
+    }
+    std::string val = argv[++opt_it];
+    if (arg == "-o") {
+      OutputFile = val;
+    } else if (arg == "-n") {
+      NEventUnits = std::stoul(val);
+    } else if (arg == "-p") {
+      NSplineParams = std::stoul(val);
+    } else if (arg == "-d") {
+      NDiscreteParams = std::stoul(val);
+    } else if (arg == "-k") {
+      NKnots = std::stoul(val);
+    } else if (arg == "-t") {
+      NThrows = std::stoul(val);
+    } else if (arg == "-f") {
+      ParamOccupancy = std::stod(val);
+    } else if (arg == "-r") {
+      NRepeats = std::stoul(val);
+    } else {
+      std::cout << "[ERROR]: Unknown option: " << arg << std::endl;
+      SayUsage(argv);
+      exit(1);
+    }
+  }
+}
+
+struct BenchResult {
+  std::string name;
+  size_t NOps;
+  size_t NEvents;
+  double ns;
+  size_t NAllocs;
+  size_t NBytes;
+};
+
+std::vector<BenchResult> Results;
+std::vector<std::pair<std::string, MemoryBreakdown>> Footprints;
+
+///\brief Runs f NRepeats times, keeping the fastest. f performs NOps
+/// operations covering NEvents event units.
+template <typename F>
+void Measure(std::string const &name, size_t NOps, size_t NEvents, F &&f) {
+  BenchResult best{name, NOps, NEvents, std::numeric_limits<double>::max(), 0,
+                   0};
+  for (size_t r_it = 0; r_it < std::max(NRepeats, size_t(1)); ++r_it) {
+    AllocationCounts allocs = GetAllocationCounts();
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    allocs = GetAllocationCounts() - allocs;
+    if (elapsed.count() < best.ns) {
+      best.ns = elapsed.count();
+      best.NAllocs = allocs.NAllocations;
+      best.NBytes = allocs.NBytesAllocated;
+    }
+  }
+  std::cerr << "[INFO]: " << name << ": " << (best.ns / double(best.NOps))
+            << " ns/op" << std::endl;
+  Results.push_back(best);
+}
+
+void WriteJSON(std::ostream &os) {
+  os << "{\n  \"benchmark\": \"systtools_bench\",\n"
+     << "  \"config\": {\"NEventUnits\": " << NEventUnits
+     << ", \"NSplineParams\": " << NSplineParams
+     << ", \"NDiscreteParams\": " << NDiscreteParams
+     << ", \"NKnots\": " << NKnots << ", \"NThrows\": " << NThrows
+     << ", \"ParamOccupancy\": " << ParamOccupancy
+     << ", \"NRepeats\": " << NRepeats << "},\n"
+     << "  \"results\": [\n";
+  for (size_t r_it = 0; r_it < Results.size(); ++r_it) {
+    BenchResult const &r = Results[r_it];
+    double NOps = double(std::max(r.NOps, size_t(1)));
+    os << "    {\"name\": \"" << r.name << "\", \"ops\": " << r.NOps
+       << ", \"ns_per_op\": " << (r.ns / NOps)
+       << ", \"allocs_per_op\": " << (double(r.NAllocs) / NOps)
+       << ", \"bytes_allocated_per_op\": " << (double(r.NBytes) / NOps)
+       << ", \"events_per_s\": "
+       << (r.ns > 0 ? (double(r.NEvents) * 1E9 / r.ns) : 0) << "}"
+       << ((r_it + 1) < Results.size() ? "," : "") << "\n";
+  }
+  os << "  ],\n  \"memory_footprints\": [\n";
+  for (size_t f_it = 0; f_it < Footprints.size(); ++f_it) {
+    MemoryBreakdown const &mb = Footprints[f_it].second;
+    os << "    {\"name\": \"" << Footprints[f_it].first << "\"";
+    for (auto const &c : mb.Components) {
+      os << ", \"" << c.first << "\": " << c.second;
+    }
+    os << ", \"total\": " << mb.Total() << "}"
+       << ((f_it + 1) < Footprints.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n}" << std::endl;
+}
+
+///\brief Times ParamHeaderHelperT::GetTotalResponse at the care level of
+/// phh, which may be fixed at compile time.
+template <typename VP>
+void BenchGetTotalResponse(std::string const &suffix,
+                           ParamHeaderHelperT<VP> &phh,
+                           EventResponse const &er,
+                           param_value_list_t const &vals,
+                           ParamValidationAndErrorResponse chkerr) {
+  chkerr.SetCareLevel(phh.GetCareLevel());
+  phh.SetChkErr(chkerr);
+  Measure("ParamHeaderHelper::GetTotalResponse/" + suffix, er.size(),
+          er.size(), [&]() {
+            double sum = 0;
+            for (auto const &eur : er) {
+              sum += phh.GetTotalResponse(vals, eur);
+            }
+            gSink = sum;
+          });
+}
+
+struct BenchEventUnit {
+  size_t index;
+};
+
+template <ParamValidationAndErrorResponse::CareLevel CL>
+void BenchEventSplineCache(std::string const &suffix,
+                           param_header_map_t const &headers,
+                           EventResponse const &er,
+                           ParamValidationAndErrorResponse const &chkerr) {
+  std::vector<BenchEventUnit> events;
+  for (size_t eu_it = 0; eu_it < er.size(); ++eu_it) {
+    events.push_back({eu_it});
+  }
+
+  EventSplineCache<BenchEventUnit, CL> cache;
+  Measure("EventSplineCache::CacheEvents/" + suffix, er.size(), er.size(),
+          [&]() {
+            cache = EventSplineCache<BenchEventUnit, CL>();
+            cache.SetHeaders(headers);
+            cache.SetChkErr(chkerr);
+            cache.CacheEvents(events, er);
+          });
+  for (paramId_t pid = 0; pid < NSplineParams; ++pid) {
+    cache.DeclareUsingParameter(pid, 0.5);
+  }
+  Footprints.emplace_back("EventSplineCache/" + suffix,
+                          cache.MemoryFootprint());
+  Measure("EventSplineCache::GetTotalEventWeightResponse/" + suffix,
+          er.size(), er.size(), [&]() {
+            double sum = 0;
+            for (eventId_t eid = 0; eid < er.size(); ++eid) {
+              sum += cache.GetTotalEventWeightResponse(eid);
+            }
+            gSink = sum;
+          });
+
+  // A flat data histogram, with event units spread evenly between its bins.
+  size_t const NBins = 50;
+  std::vector<int> bins(er.size());
+  for (eventId_t eid = 0; eid < er.size(); ++eid) {
+    bins[eid] = int(eid % NBins);
+  }
+  std::vector<double> data(NBins, double(er.size()) / double(NBins));
+  BinnedLikelihood llh(cache, bins, data, headers, cache.GetWeightParameters());
+  Footprints.emplace_back("BinnedLikelihood/" + suffix, llh.MemoryFootprint());
+  std::vector<double> x(llh.GetParameters().size(), 0.5);
+  std::vector<double> gradient;
+  Measure("BinnedLikelihood::Evaluate/" + suffix, er.size(), er.size(),
+          [&]() { gSink = llh.Evaluate(x); });
+  Measure("BinnedLikelihood::EvaluateWithGradient/" + suffix, er.size(),
+          er.size(), [&]() { gSink = llh.Evaluate(x, gradient); });
+}
+
+int main(int argc, char const *argv[]) {
+  HandleOpts(argc, argv);
+
+  // Keep the pedantry low so that warnings aren't written in timed loops.
+  ParamValidationAndErrorResponse chkerr;
+  chkerr.SetPedantLevel(ParamValidationAndErrorResponse::kAnythingGoes);
+  chkerr.SetCareLevel(ParamValidationAndErrorResponse::kFrog);
+
+  SyntheticHeaderConfig hdr_cfg;
+  hdr_cfg.NSplineParams = NSplineParams;
+  hdr_cfg.NMultisimParams = NDiscreteParams;
+  hdr_cfg.NCorrectionParams = 0;
+  hdr_cfg.NGlobalParams = 0;
+  hdr_cfg.NKnots = NKnots;
+  hdr_cfg.NThrows = NThrows;
+  param_header_map_t headers = BuildSyntheticParameterHeaders(hdr_cfg);
+
+  SyntheticResponseConfig resp_cfg;
+  resp_cfg.ParamOccupancy = ParamOccupancy;
+  EventResponse er =
+      SyntheticResponseGenerator(headers, resp_cfg).Generate(NEventUnits);
+
+  param_value_list_t vals;
+  for (paramId_t pid = 0; pid < NSplineParams; ++pid) {
+    vals.push_back({pid, 0.5});
+  }
+
+  ParamHeaderHelper phh(headers, chkerr);
+  size_t NUnits = er.size();
+
+  Footprints.emplace_back("ParamHeaderHelper", phh.MemoryFootprint());
+  Footprints.emplace_back("EventResponse", MemoryFootprint(er));
+
+  if (NSplineParams) {
+    Measure("ParamHeaderHelper::GetSpline", NUnits * NSplineParams, NUnits,
+            [&]() {
+              double sum = 0;
+              for (auto const &eur : er) {
+                for (paramId_t pid = 0; pid < NSplineParams; ++pid) {
+                  sum += phh.GetSpline(pid, eur).GetNp();
+                }
+              }
+              gSink = sum;
+            });
+    Measure("ParamHeaderHelper::GetParameterResponse", NUnits * NSplineParams,
+            NUnits, [&]() {
+              double sum = 0;
+              for (auto const &eur : er) {
+                for (paramId_t pid = 0; pid < NSplineParams; ++pid) {
+                  sum += phh.GetParameterResponse(pid, 0.5, eur);
+                }
+              }
+              gSink = sum;
+            });
+    Measure("ParamHeaderHelper::GetTotalResponse", NUnits, NUnits, [&]() {
+      double sum = 0;
+      for (auto const &eur : er) {
+        sum += phh.GetTotalResponse(vals, eur);
+      }
+      gSink = sum;
+    });
+
+    // The cost of the usage checks at each care level, set at runtime, and
+    // fixed at compile time so that the checks are compiled out.
+    ParamHeaderHelper rt_phh(headers, chkerr);
+    rt_phh.SetCareLevel(ParamValidationAndErrorResponse::kTortoise);
+    BenchGetTotalResponse("Runtime/kTortoise", rt_phh, er, vals, chkerr);
+    rt_phh.SetCareLevel(ParamValidationAndErrorResponse::kHare);
+    BenchGetTotalResponse("Runtime/kHare", rt_phh, er, vals, chkerr);
+    StaticParamHeaderHelper<ParamValidationAndErrorResponse::kTortoise>
+        tortoise_phh(headers);
+    BenchGetTotalResponse("Static/kTortoise", tortoise_phh, er, vals, chkerr);
+    StaticParamHeaderHelper<ParamValidationAndErrorResponse::kFrog> frog_phh(
+        headers);
+    BenchGetTotalResponse("Static/kFrog", frog_phh, er, vals, chkerr);
+    StaticParamHeaderHelper<ParamValidationAndErrorResponse::kHare> hare_phh(
+        headers);
+    BenchGetTotalResponse("Static/kHare", hare_phh, er, vals, chkerr);
+  }
+
+  for (paramId_t pid = NSplineParams; pid < (NSplineParams + NDiscreteParams);
+       ++pid) {
+    Measure("ParamHeaderHelper::GetAllDiscreteResponses/" +
+                headers.at(pid).Header.prettyName,
+            NUnits, NUnits, [&]() {
+              auto resps = phh.GetAllDiscreteResponses(pid, er);
+              gSink = double(resps.size());
+            });
+  }
+
+  if (NSplineParams) {
+    // The cache only holds splined responses.
+    EventResponse spline_er(NUnits);
+    for (size_t eu_it = 0; eu_it < NUnits; ++eu_it) {
+      for (auto const &pr : er[eu_it]) {
+        if (pr.pid < NSplineParams) {
+          spline_er[eu_it].push_back(pr);
+        }
+      }
+    }
+    BenchEventSplineCache<ParamValidationAndErrorResponse::kFrog>(
+        "kFrog", headers, spline_er, chkerr);
+    BenchEventSplineCache<ParamValidationAndErrorResponse::kHare>(
+        "kHare", headers, spline_er, chkerr);
+
+    std::unique_ptr<ValidatedResponseView> view;
+    Measure("ValidatedResponseView::Construct", NUnits, NUnits, [&]() {
+      view = std::make_unique<ValidatedResponseView>(headers, er, chkerr);
+    });
+    Footprints.emplace_back("ValidatedResponseView", view->MemoryFootprint());
+    ValidatedResponseView::resolved_param_value_list_t rvals =
+        view->Resolve(vals);
+    Measure("ValidatedResponseView::GetTotalResponse", NUnits, NUnits, [&]() {
+      double sum = 0;
+      for (size_t eu_it = 0; eu_it < NUnits; ++eu_it) {
+        sum += view->GetTotalResponse(rvals, eu_it);
+      }
+      gSink = sum;
+    });
+    std::vector<double> weights(NUnits);
+    Measure("ValidatedResponseView::GetTotalResponses", NUnits, NUnits, [&]() {
+      view->GetTotalResponses(rvals, weights.data());
+      gSink = weights.back();
+    });
+
+    // A scan of the first spline parameter across its knot range.
+    std::vector<double> scan_vals;
+    for (size_t v_it = 0; v_it < 21; ++v_it) {
+      scan_vals.push_back(-3 + 0.3 * double(v_it));
+    }
+    std::vector<double> scan(NUnits * scan_vals.size());
+    Measure("ValidatedResponseView::ScanParameterResponse",
+            NUnits * scan_vals.size(), NUnits, [&]() {
+              view->ScanParameterResponse(0, scan_vals.data(),
+                                          scan_vals.size(), scan.data());
+              gSink = scan.back();
+            });
+  }
+
+  {
+    // Each event unit is treated as a framework event, whose response is
+    // built, then discarded once it would have been written.
+    auto FillEvent = [](event_unit_response_t const &from, EventResponse &to,
+                        EventResponsePool *pool) {
+      for (ParamResponses const &pr : from) {
+        if (pool) {
+          pool->AddParamResponses(to.front(), pr.pid) = pr.responses;
+        } else {
+          to.front().push_back({pr.pid, pr.responses});
+        }
+      }
+    };
+    Measure("EventResponse::Allocate", NUnits, NUnits, [&]() {
+      size_t sum = 0;
+      for (auto const &eur : er) {
+        auto event_er = std::make_unique<EventResponse>(1);
+        FillEvent(eur, *event_er, nullptr);
+        sum += event_er->front().size();
+      }
+      gSink = double(sum);
+    });
+    EventResponsePool pool;
+    auto PooledEvents = [&]() {
+      size_t sum = 0;
+      for (auto const &eur : er) {
+        auto event_er = pool.Acquire(1);
+        FillEvent(eur, *event_er, &pool);
+        sum += event_er->front().size();
+        pool.Release(std::move(event_er));
+      }
+      gSink = double(sum);
+    };
+    PooledEvents(); // Warm up
+    EventResponsePool::Counters warm = pool.GetCounters();
+    Measure("EventResponsePool::AcquireRelease", NUnits, NUnits, PooledEvents);
+    EventResponsePool::Counters const &steady = pool.GetCounters();
+    std::cerr << "[INFO]: EventResponsePool created "
+              << (steady.NEventUnitsCreated - warm.NEventUnitsCreated)
+              << " event units and "
+              << (steady.NResponseBuffersCreated -
+                  warm.NResponseBuffersCreated)
+              << " response buffers after warm up." << std::endl;
+    Footprints.emplace_back("EventResponsePool", pool.MemoryFootprint());
+  }
+
+  if (NKnots > 2) {
+    // Interval lookup on the synthetic headers' evenly spaced knots, by index
+    // arithmetic, and by the binary search used for irregular knots.
+    std::vector<double> knots;
+    for (size_t k_it = 0; k_it < NKnots; ++k_it) {
+      knots.push_back(-3 + (6 * double(k_it) / double(NKnots - 1)));
+    }
+    SplineKnots uniform(knots);
+    std::mt19937_64 rng(4);
+    std::uniform_real_distribution<double> val(-3.5, 3.5);
+    std::vector<double> vals(NUnits);
+    for (double &v : vals) {
+      v = val(rng);
+    }
+    Measure("SplineKnots::Find/uniform", NUnits, NUnits, [&]() {
+      size_t sum = 0;
+      for (double v : vals) {
+        sum += uniform.Find(v);
+      }
+      gSink = double(sum);
+    });
+    Measure("SplineKnots::Find/binary", NUnits, NUnits, [&]() {
+      size_t sum = 0;
+      for (double v : vals) {
+        sum += FindSplineKnot(knots.data(), knots.size(), v);
+      }
+      gSink = double(sum);
+    });
+
+    // Evaluation with each interpolation scheme, instantiated per scheme.
+    std::vector<double> responses;
+    for (double k : knots) {
+      responses.push_back(1 + (0.1 * k) + (0.02 * k * k));
+    }
+    for (InterpolationScheme scheme :
+         {InterpolationScheme::kCubicSpline, InterpolationScheme::kLinear,
+          InterpolationScheme::kMonotoneCubic, InterpolationScheme::kAkima}) {
+      DispatchInterpolationScheme(scheme, [&](auto policy) {
+        InterpolatedResponse<decltype(policy)> resp(knots, responses);
+        Measure("InterpolatedResponse::Eval/" + to_str(scheme), NUnits, NUnits,
+                [&]() {
+                  double sum = 0;
+                  for (double v : vals) {
+                    sum += resp.Eval(v);
+                  }
+                  gSink = sum;
+                });
+      });
+    }
+
+    // The polynomial response models that ResponseModelSelector weighs
+    // against interpolation.
+    for (size_t order : {size_t(2), kMaxResponsePolyOrder}) {
+      ResponsePolynomial poly(knots.data(), responses.data(), knots.size(),
+                              order);
+      Measure("ResponsePolynomial::Eval/" +
+                  to_str(GetPolyResponseModel(order)),
+              NUnits, NUnits, [&]() {
+                double sum = 0;
+                for (double v : vals) {
+                  sum += poly.Eval(v);
+                }
+                gSink = sum;
+              });
+    }
+  }
+
+  {
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> coeff(-0.1, 0.1);
+    std::vector<PolyResponse<3>> polys;
+    for (size_t eu_it = 0; eu_it < NUnits; ++eu_it) {
+      polys.emplace_back(std::array<double, 4>{
+          {1, coeff(rng), coeff(rng), coeff(rng)}});
+    }
+    Measure("PolyResponse<3>::eval", NUnits, NUnits, [&]() {
+      double sum = 0;
+      for (auto const &p : polys) {
+        sum += p.eval(0.5);
+      }
+      gSink = sum;
+    });
+  }
+
+#ifdef SYSTTOOLS_BENCH_HAVE_CLHEP
+  {
+    // A random, well-conditioned covariance matrix.
+    size_t NRows = std::max(NSplineParams, size_t(1));
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> elem(-0.5, 0.5);
+    TMatrixD A(int(NRows), int(NRows));
+    for (size_t i = 0; i < NRows; ++i) {
+      for (size_t j = 0; j < NRows; ++j) {
+        A[i][j] = elem(rng);
+      }
+    }
+    TMatrixDSym covmat(int(NRows));
+    for (size_t i = 0; i < NRows; ++i) {
+      for (size_t j = 0; j < NRows; ++j) {
+        double v = (i == j) ? double(NRows) : 0;
+        for (size_t k = 0; k < NRows; ++k) {
+          v += A[i][k] * A[j][k];
+        }
+        covmat[i][j] = v;
+      }
+    }
+    CovarianceThrower thrower(covmat, 1);
+    Measure("CovarianceThrower::Throw", NThrows, 0, [&]() {
+      double sum = 0;
+      for (size_t t_it = 0; t_it < NThrows; ++t_it) {
+        sum += (*thrower.Throw())[0][0];
+      }
+      gSink = sum;
+    });
+  }
+#endif
+
+  if (OutputFile.size()) {
+    std::ofstream ofs(OutputFile);
+    if (!ofs) {
+      std::cout << "[ERROR]: Failed to open " << OutputFile << " for writing."
+                << std::endl;
+      return 1;
+    }
+    WriteJSON(ofs);
+  } else {
+    WriteJSON(std::cout);
+  }
+}
@@ -0,0 +1,386 @@
+#include "systematicstools/interface/EncodedEventResponse.hh"
+#include "systematicstools/interface/EventResponseIndex.hh"
+#include "systematicstools/interface/ISystProviderTool.hh"
+#include "systematicstools/interface/Profiler.hh"
+
+#include "systematicstools/interpreters/PrecalculatedResponseReader.hh"
+
+#include "systematicstools/systproviders/ExampleISystProvider_tool.hh"
+
+#include "systematicstools/utility/EventUnitReader.hh"
+#include "systematicstools/utility/ParameterAndProviderConfigurationUtility.hh"
+#include "systematicstools/utility/SystProviderToolFactory.hh"
+#include "systematicstools/utility/TTreeEventUnitReader.hh"
+#include "systematicstools/utility/string_parsers.hh"
+
+#include "fhiclcpp/make_ParameterSet.h"
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace systtools;
+
+NEW_SYSTTOOLS_EXCEPT(invalid_output_file);
+NEW_SYSTTOOLS_EXCEPT(unsupported_output_format);
+
+// Runs a set of providers, configured from a parameter headers document, over
+// an input of event units on a number of threads, and writes the responses.
+
+std::string ParameterHeadersFile = "";
+std::string ProvidersKey = "syst_providers";
+std::string InputFile = "";
+std::string TreeName = "events";
+std::vector<std::string> Variables;
+std::string OutputFile = "";
+std::string OutputFormat = "";
+size_t NThreads = 0;
+size_t BatchSize = 10000;
+size_t MaxEventUnits = IEventUnitReader::kUnknownNEventUnits;
+double ProgressInterval = 10;
+
+// The order of the polynomial responses written in the tree format.
+constexpr size_t kPolyOrder = 3;
+
+typedef std::vector<std::unique_ptr<ISystProviderTool>> provider_list_t;
+typedef std::chrono::duration<double> seconds_t;
+
+bool EndsWith(std::string const &str, std::string const &suffix) {
+  return (str.size() >= suffix.size()) &&
+         std::equal(suffix.rbegin(), suffix.rend(), str.rbegin());
+}
+
+void SayUsage(char const *argv[]) {
+  std::cout
+      << "[USAGE]: " << argv[0] << "\n"
+      << "\t-c <ParameterHeaders.fcl> : Parameter headers document "
+         "describing\n"
+      << "\t                            the providers to run.\n"
+      << "\t-k <key=syst_providers>   : Key of the provider list in the "
+         "document.\n"
+      << "\t-i <input>                : Event unit input, a ROOT file if it "
+         "ends\n"
+      << "\t                            in .root, otherwise the native "
+         "binary\n"
+      << "\t                            format, see utility/EventUnitReader.hh"
+         ".\n"
+      << "\t-t <tree=events>          : Input TTree name, for ROOT inputs.\n"
+      << "\t-v <var1,var2,...>        : Variables to read, for ROOT inputs.\n"
+      << "\t-o <output>               : Output file, an index of the written "
+         "event\n"
+      << "\t                            units is written to <output>.idx.\n"
+      << "\t-f <tree|native>          : Output format, the default is tree "
+         "for\n"
+      << "\t                            outputs ending in .root, otherwise "
+         "native.\n"
+      << "\t-j <NThreads>             : Worker threads, the default is the "
+         "number\n"
+      << "\t                            of hardware threads.\n"
+      << "\t-b <BatchSize=10000>      : Event units read per batch.\n"
+      << "\t-n <MaxEventUnits>        : Stop after MaxEventUnits event "
+         "units.\n"
+      << "\t-p <ProgressInterval=10>  : Seconds between progress reports, 0 "
+         "to\n"
+      << "\t                            disable."
+      << std::endl;
+}
+
+void HandleOpts(int argc, char const *argv[]) {
+  for (int opt_it = 1; opt_it < argc; ++opt_it) {
+    std::string arg = argv[opt_it];
+    if ((arg == "-?") || (arg == "--help")) {
+      SayUsage(argv);
+      exit(0);
+    }
+    if ((opt_it + 1) >= argc) {
+      std::cout << "[ERROR]: Option " << arg << " expects a value."
+                << std::endl;
+      SayUsage(argv);
+      exit(1);
+    }
+    std::string val = argv[++opt_it];
+    if (arg == "-c") {
+      ParameterHeadersFile = val;
+    } else if (arg == "-k") {
+      ProvidersKey = val;
+    } else if (arg == "-i") {
+      InputFile = val;
+    } else if (arg == "-t") {
+      TreeName = val;
+    } else if (arg == "-v") {
+      Variables = ParseToVect<std::string>(val, ",");
+    } else if (arg == "-o") {
+      OutputFile = val;
+    } else if (arg == "-f") {
+      OutputFormat = val;
+    } else if (arg == "-j") {
+      NThreads = std::stoul(val);
+    } else if (arg == "-b") {
+      BatchSize = std::stoul(val);
+    } else if (arg == "-n") {
+      MaxEventUnits = std::stoul(val);
+    } else if (arg == "-p") {
+      ProgressInterval = std::stod(val);
+    } else {
+      std::cout << "[ERROR]: Unknown option: " << arg << std::endl;
+      SayUsage(argv);
+      exit(1);
+    }
+  }
+
+  if (!ParameterHeadersFile.size() || !InputFile.size() ||
+      !OutputFile.size()) {
+    std::cout << "[ERROR]: Options -c, -i, and -o are required." << std::endl;
+    SayUsage(argv);
+    exit(1);
+  }
+  if (!OutputFormat.size()) {
+    OutputFormat = EndsWith(OutputFile, ".root") ? "tree" : "native";
+  }
+  if ((OutputFormat != "tree") && (OutputFormat != "native")) {
+    std::cout << "[ERROR]: Unknown output format: " << std::quoted(OutputFormat)
+              << std::endl;
+    SayUsage(argv);
+    exit(1);
+  }
+  if (!NThreads) {
+    NThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  BatchSize = std::max(BatchSize, size_t(1));
+}
+
+///\brief Writes the responses of each batch of event units, in order.
+class IResponseSink {
+public:
+  virtual void Write(std::vector<EventUnitRecord> const &batch,
+                     EventResponse &er) = 0;
+  virtual void Close() = 0;
+  virtual ~IResponseSink() {}
+};
+
+///\brief Writes fitted polynomial responses with the existing
+/// PrecalculatedResponseReader tree writer.
+class TreeResponseSink : public IResponseSink {
+public:
+  TreeResponseSink(param_header_map_t const &headers) {
+    for (auto const &hdr_it : headers) {
+      SystParamHeader const &hdr = hdr_it.second.Header;
+      if (hdr.differsEventByEvent && !hdr.isResponselessParam &&
+          !hdr.isSplineable) {
+        throw unsupported_output_format()
+            << "[ERROR]: The tree output format stores polynomial fits to "
+               "the responses, but parameter "
+            << std::quoted(hdr.prettyName)
+            << " is not splineable, use the native output format.";
+      }
+    }
+    fFile = TFile::Open(OutputFile.c_str(), "RECREATE");
+    if (!fFile || !fFile->IsOpen()) {
+      throw invalid_output_file() << "[ERROR]: Failed to open output file: "
+                                  << std::quoted(OutputFile);
+    }
+    fTree = new TTree("syst_responses", "");
+    fTree->SetDirectory(fFile);
+    fWriter = PrecalculatedResponseReader<kPolyOrder>::MakeTreeWriter(
+        headers, fTree);
+  }
+
+  void Write(std::vector<EventUnitRecord> const &batch, EventResponse &er) {
+    for (size_t eu_it = 0; eu_it < batch.size(); ++eu_it) {
+      fWriter->AddEventResponses(std::move(er[eu_it]), batch[eu_it].key);
+    }
+  }
+
+  void Close() {
+    fWriter->BuildIndex(OutputFile).Save(OutputFile + ".idx");
+    fFile->cd();
+    fTree->Write();
+    fFile->Close();
+    delete fFile;
+  }
+
+private:
+  TFile *fFile;
+  TTree *fTree;
+  std::unique_ptr<PrecalculatedResponseReader<kPolyOrder>> fWriter;
+};
+
+///\brief Writes the responses in the native EncodedEventResponse format, one
+/// record per batch.
+class NativeResponseSink : public IResponseSink {
+public:
+  NativeResponseSink(param_header_map_t const &headers)
+      : fOS(OutputFile, std::ios::binary), fEncoded(headers),
+        fWriter(fOS, fEncoded.GetEncodingSpecs()), fIndex("") {
+    if (!fOS) {
+      throw invalid_output_file()
+          << "[ERROR]: Failed to open output file: "
+          << std::quoted(OutputFile);
+    }
+    fFileIdx = fIndex.AddFile(OutputFile);
+  }
+
+  void Write(std::vector<EventUnitRecord> const &batch, EventResponse &er) {
+    fEncoded.Encode(er);
+    fWriter.Write(fEncoded);
+    for (EventUnitRecord const &eu : batch) {
+      fIndex.Add(eu.key, fFileIdx, fNWritten++);
+    }
+  }
+
+  void Close() {
+    fOS.close();
+    fIndex.Finalize();
+    fIndex.Save(OutputFile + ".idx");
+  }
+
+private:
+  std::ofstream fOS;
+  EncodedEventResponse fEncoded;
+  EncodedResponseWriter fWriter;
+  EventResponseIndex fIndex;
+  uint32_t fFileIdx;
+  uint64_t fNWritten = 0;
+};
+
+///\brief Calculates the responses of event units [begin, end) of batch into
+/// er, one provider at a time.
+void CalculateResponses(provider_list_t &providers,
+                        std::vector<EventUnitRecord> const &batch,
+                        EventResponse &er, size_t begin, size_t end) {
+  for (size_t eu_it = begin; eu_it < end; ++eu_it) {
+    er[eu_it].clear();
+  }
+  for (auto &prov : providers) {
+    ProfileScope prof("response", prov->GetFullyQualifiedName());
+    for (size_t eu_it = begin; eu_it < end; ++eu_it) {
+      ExtendEventUnitResponse(er[eu_it],
+                              prov->GetEventUnitResponse(batch[eu_it]));
+    }
+    prof.SetOutputSize(end - begin);
+  }
+}
+
+int main(int argc, char const *argv[]) {
+  HandleOpts(argc, argv);
+
+  RegisterSystProviderTool<ExampleISystProvider>("ExampleISystProvider");
+
+  std::unique_ptr<IEventUnitReader> reader;
+  if (EndsWith(InputFile, ".root")) {
+    reader =
+        std::make_unique<TTreeEventUnitReader>(InputFile, TreeName, Variables);
+  } else {
+    reader = std::make_unique<BinaryEventUnitReader>(InputFile);
+  }
+
+  // Providers may keep per-event state, so each worker gets its own set.
+  fhicl::ParameterSet ps = fhicl::make_ParameterSet(ParameterHeadersFile);
+  std::vector<provider_list_t> worker_providers;
+  for (size_t t_it = 0; t_it < NThreads; ++t_it) {
+    worker_providers.push_back(
+        ConfigureISystProvidersFromParameterHeaders<ISystProviderTool>(
+            ps, MakeSystProviderTool, ProvidersKey));
+    for (auto &prov : worker_providers.back()) {
+      prov->SetEventUnitSchema(reader->GetSchema());
+    }
+  }
+  param_header_map_t headers = BuildParameterHeaders(worker_providers.front());
+
+  std::unique_ptr<IResponseSink> sink;
+  if (OutputFormat == "tree") {
+    sink = std::make_unique<TreeResponseSink>(headers);
+  } else {
+    sink = std::make_unique<NativeResponseSink>(headers);
+  }
+
+  size_t NTotal = std::min(reader->GetNEventUnits(), MaxEventUnits);
+  size_t NRequested = 0;
+  auto ReadBatch = [&](std::vector<EventUnitRecord> &batch) {
+    size_t NMax = std::min(BatchSize, MaxEventUnits - NRequested);
+    NRequested += NMax;
+    return reader->ReadBatch(batch, NMax);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  auto last_report = start;
+  seconds_t read_time(0), wait_time(0), write_time(0);
+  size_t NProcessed = 0;
+
+  // The next batch is read while the workers process the current one.
+  std::vector<EventUnitRecord> batches[2];
+  EventResponse er;
+  size_t cur = 0;
+  size_t NRead = ReadBatch(batches[cur]);
+  read_time += std::chrono::steady_clock::now() - start;
+
+  while (NRead) {
+    std::vector<EventUnitRecord> const &batch = batches[cur];
+    er.resize(batch.size());
+
+    size_t NWorkers = std::min(NThreads, batch.size());
+    size_t NPerWorker = (batch.size() + NWorkers - 1) / NWorkers;
+    // The futures of std::async wait for their workers on destruction, so
+    // none outlive the batch if reading the next one throws.
+    std::vector<std::future<void>> workers;
+    for (size_t t_it = 0; t_it < NWorkers; ++t_it) {
+      size_t begin = std::min(batch.size(), t_it * NPerWorker);
+      size_t end = std::min(batch.size(), begin + NPerWorker);
+      workers.push_back(std::async(std::launch::async, [&, t_it, begin, end]() {
+        CalculateResponses(worker_providers[t_it], batch, er, begin, end);
+      }));
+    }
+
+    auto read_start = std::chrono::steady_clock::now();
+    size_t NNext = ReadBatch(batches[1 - cur]);
+    auto wait_start = std::chrono::steady_clock::now();
+    read_time += wait_start - read_start;
+
+    // Rethrows the first worker exception.
+    for (auto &w : workers) {
+      w.get();
+    }
+
+    auto write_start = std::chrono::steady_clock::now();
+    wait_time += write_start - wait_start;
+    sink->Write(batch, er);
+    auto now = std::chrono::steady_clock::now();
+    write_time += now - write_start;
+
+    NProcessed += batch.size();
+    if ((ProgressInterval > 0) &&
+        (seconds_t(now - last_report).count() >= ProgressInterval)) {
+      double elapsed = seconds_t(now - start).count();
+      std::cout << "[INFO]: Processed " << NProcessed;
+      if (NTotal != IEventUnitReader::kUnknownNEventUnits) {
+        std::cout << "/" << NTotal << " ("
+                  << (100 * NProcessed / std::max(NTotal, size_t(1))) << "%)";
+      }
+      std::cout << " event units, " << size_t(NProcessed / elapsed)
+                << " event units/s." << std::endl;
+      last_report = now;
+    }
+
+    cur = 1 - cur;
+    NRead = NNext;
+  }
+  sink->Close();
+
+  double elapsed = seconds_t(std::chrono::steady_clock::now() - start).count();
+  std::cout << "[INFO]: Processed " << NProcessed << " event units with "
+            << NThreads << " threads in " << elapsed << " s, "
+            << size_t(NProcessed / std::max(elapsed, 1E-9))
+            << " event units/s.\n\tReading: " << read_time.count()
+            << " s, waiting for workers: " << wait_time.count()
+            << " s, writing: " << write_time.count() << " s." << std::endl;
+}
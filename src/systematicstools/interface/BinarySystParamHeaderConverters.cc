@@ -0,0 +1,218 @@
+#include "systematicstools/interface/BinarySystParamHeaderConverters.hh"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <map>
+#include <ostream>
+
+namespace systtools {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'Y', 'S', 'T', 'P', 'H', '0', '1'};
+
+uint64_t const kNoVariations = std::numeric_limits<uint64_t>::max();
+
+enum HeaderFlags : uint8_t {
+  kIsWeightSystematicVariation = 1 << 0,
+  kUnitsAreNatural = 1 << 1,
+  kDiffersEventByEvent = 1 << 2,
+  kIsCorrection = 1 << 3,
+  kIsSplineable = 1 << 4,
+  kIsRandomlyThrown = 1 << 5,
+  kIsResponselessParam = 1 << 6,
+};
+
+template <typename T> void WritePOD(std::ostream &os, T const &v) {
+  os.write(reinterpret_cast<char const *>(&v), sizeof(T));
+}
+template <typename T> void ReadPOD(std::istream &is, T &v) {
+  if (!is.read(reinterpret_cast<char *>(&v), sizeof(T))) {
+    throw corrupt_parameter_headers_stream()
+        << "[ERROR]: Parameter headers stream ended unexpectedly.";
+  }
+}
+
+void WriteString(std::ostream &os, std::string const &s) {
+  WritePOD(os, uint64_t(s.size()));
+  os.write(s.data(), s.size());
+}
+void ReadString(std::istream &is, std::string &s) {
+  uint64_t n;
+  ReadPOD(is, n);
+  s.resize(n);
+  if (n && !is.read(&s[0], n)) {
+    throw corrupt_parameter_headers_stream()
+        << "[ERROR]: Parameter headers stream ended unexpectedly.";
+  }
+}
+
+void WriteDoubles(std::ostream &os, std::vector<double> const &v) {
+  WritePOD(os, uint64_t(v.size()));
+  os.write(reinterpret_cast<char const *>(v.data()), v.size() * sizeof(double));
+}
+void ReadDoubles(std::istream &is, std::vector<double> &v) {
+  uint64_t n;
+  ReadPOD(is, n);
+  v.resize(n);
+  if (n && !is.read(reinterpret_cast<char *>(v.data()), n * sizeof(double))) {
+    throw corrupt_parameter_headers_stream()
+        << "[ERROR]: Parameter headers stream ended unexpectedly.";
+  }
+}
+
+uint8_t GetFlags(SystParamHeader const &hdr) {
+  return (hdr.isWeightSystematicVariation ? kIsWeightSystematicVariation : 0) |
+         (hdr.unitsAreNatural ? kUnitsAreNatural : 0) |
+         (hdr.differsEventByEvent ? kDiffersEventByEvent : 0) |
+         (hdr.isCorrection ? kIsCorrection : 0) |
+         (hdr.isSplineable ? kIsSplineable : 0) |
+         (hdr.isRandomlyThrown ? kIsRandomlyThrown : 0) |
+         (hdr.isResponselessParam ? kIsResponselessParam : 0);
+}
+void SetFlags(SystParamHeader &hdr, uint8_t flags) {
+  hdr.isWeightSystematicVariation = flags & kIsWeightSystematicVariation;
+  hdr.unitsAreNatural = flags & kUnitsAreNatural;
+  hdr.differsEventByEvent = flags & kDiffersEventByEvent;
+  hdr.isCorrection = flags & kIsCorrection;
+  hdr.isSplineable = flags & kIsSplineable;
+  hdr.isRandomlyThrown = flags & kIsRandomlyThrown;
+  hdr.isResponselessParam = flags & kIsResponselessParam;
+}
+
+} // namespace
+
+void WriteParameterHeaders(std::ostream &os,
+                           param_header_map_t const &headers) {
+  // Number each distinct set of variations in order of first use.
+  std::map<std::vector<double>, uint64_t> variation_indices;
+  std::vector<std::vector<double> const *> variation_table;
+  for (auto const &hdr_it : headers) {
+    std::vector<double> const &vars = hdr_it.second.Header.paramVariations;
+    if (vars.empty()) {
+      continue;
+    }
+    auto inserted = variation_indices.emplace(vars, variation_table.size());
+    if (inserted.second) {
+      variation_table.push_back(&inserted.first->first);
+    }
+  }
+
+  os.write(kMagic, sizeof(kMagic));
+  WritePOD(os, uint64_t(variation_table.size()));
+  for (std::vector<double> const *vars : variation_table) {
+    WriteDoubles(os, *vars);
+  }
+
+  WritePOD(os, uint64_t(headers.size()));
+  for (auto const &hdr_it : headers) {
+    SystParamHeader const &hdr = hdr_it.second.Header;
+    WriteString(os, hdr_it.second.ProviderFQName);
+    WriteString(os, hdr.prettyName);
+    WritePOD(os, hdr.systParamId);
+    WritePOD(os, GetFlags(hdr));
+    WritePOD(os, hdr.centralParamValue);
+    WritePOD(os, hdr.oneSigmaShifts);
+    WritePOD(os, hdr.paramValidityRange);
+    WritePOD(os, hdr.paramVariations.empty()
+                     ? kNoVariations
+                     : variation_indices[hdr.paramVariations.get()]);
+    WritePOD(os, hdr.responseParamId);
+    WriteDoubles(os, hdr.responses);
+    WritePOD(os, uint64_t(hdr.opts.size()));
+    for (std::string const &opt : hdr.opts) {
+      WriteString(os, opt);
+    }
+  }
+}
+
+param_header_map_t ReadParameterHeaders(std::istream &is) {
+  char magic[sizeof(kMagic)];
+  if (!is.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kMagic, sizeof(kMagic))) {
+    throw corrupt_parameter_headers_stream()
+        << "[ERROR]: Parameter headers stream does not start with the "
+           "expected magic, it was not written by WriteParameterHeaders.";
+  }
+
+  uint64_t NVariations;
+  ReadPOD(is, NVariations);
+  std::vector<SharedVector<double>> variation_table;
+  for (uint64_t v_it = 0; v_it < NVariations; ++v_it) {
+    std::vector<double> vars;
+    ReadDoubles(is, vars);
+    variation_table.emplace_back(std::move(vars));
+    variation_table.back().Intern();
+  }
+
+  param_header_map_t headers;
+  uint64_t NHeaders;
+  ReadPOD(is, NHeaders);
+  for (uint64_t h_it = 0; h_it < NHeaders; ++h_it) {
+    ParamHeaderProviderName phpn;
+    SystParamHeader &hdr = phpn.Header;
+    ReadString(is, phpn.ProviderFQName);
+    ReadString(is, hdr.prettyName);
+    ReadPOD(is, hdr.systParamId);
+    uint8_t flags;
+    ReadPOD(is, flags);
+    SetFlags(hdr, flags);
+    ReadPOD(is, hdr.centralParamValue);
+    ReadPOD(is, hdr.oneSigmaShifts);
+    ReadPOD(is, hdr.paramValidityRange);
+    uint64_t variation_index;
+    ReadPOD(is, variation_index);
+    if (variation_index != kNoVariations) {
+      if (variation_index >= NVariations) {
+        throw corrupt_parameter_headers_stream()
+            << "[ERROR]: Parameter header " << std::quoted(hdr.prettyName)
+            << " refers to variations number " << variation_index
+            << ", but only " << NVariations << " are listed.";
+      }
+      hdr.paramVariations = variation_table[variation_index];
+    }
+    ReadPOD(is, hdr.responseParamId);
+    ReadDoubles(is, hdr.responses);
+    uint64_t NOpts;
+    ReadPOD(is, NOpts);
+    std::vector<std::string> opts(NOpts);
+    for (std::string &opt : opts) {
+      ReadString(is, opt);
+    }
+    hdr.opts = std::move(opts);
+
+    paramId_t pid = hdr.systParamId;
+    if (!headers.emplace(pid, std::move(phpn)).second) {
+      throw corrupt_parameter_headers_stream()
+          << "[ERROR]: Parameter headers stream contains parameter id " << pid
+          << " more than once.";
+    }
+  }
+  return headers;
+}
+
+void SaveParameterHeaders(std::string const &file_name,
+                          param_header_map_t const &headers) {
+  std::ofstream ofs(file_name, std::ios::binary);
+  if (!ofs) {
+    throw corrupt_parameter_headers_stream()
+        << "[ERROR]: Failed to open " << std::quoted(file_name)
+        << " for writing.";
+  }
+  WriteParameterHeaders(ofs, headers);
+}
+
+param_header_map_t LoadParameterHeaders(std::string const &file_name) {
+  std::ifstream ifs(file_name, std::ios::binary);
+  if (!ifs) {
+    throw corrupt_parameter_headers_stream()
+        << "[ERROR]: Failed to open parameter headers file "
+        << std::quoted(file_name) << ".";
+  }
+  return ReadParameterHeaders(ifs);
+}
+
+} // namespace systtools
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "systematicstools/interface/types.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include <iosfwd>
+#include <string>
+
+namespace systtools {
+
+///\brief Exception raised when reading a malformed binary parameter headers
+/// stream.
+NEW_SYSTTOOLS_EXCEPT(corrupt_parameter_headers_stream);
+
+///\brief Writes a set of parameter headers, and the providers that own them,
+/// to a compact binary stream.
+///
+/// The stream starts with a table of every distinct paramVariations vector,
+/// each stored once, and headers refer to their variations by index.
+/// Responseless and thrown parameters that share variations therefore cost a
+/// single index each. Values are written in host byte order.
+void WriteParameterHeaders(std::ostream &os,
+                           param_header_map_t const &headers);
+
+///\brief Reads parameter headers written by WriteParameterHeaders.
+///
+/// Headers that were written with identical variations share their storage,
+/// see SharedVector.
+///
+///\note throws corrupt_parameter_headers_stream on malformed input.
+param_header_map_t ReadParameterHeaders(std::istream &is);
+
+void SaveParameterHeaders(std::string const &file_name,
+                          param_header_map_t const &headers);
+param_header_map_t LoadParameterHeaders(std::string const &file_name);
+
+} // namespace systtools
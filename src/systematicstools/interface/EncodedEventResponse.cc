@@ -0,0 +1,598 @@
+#include "systematicstools/interface/EncodedEventResponse.hh"
+
+#include "systematicstools/utility/string_parsers.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string_view>
+
+namespace systtools {
+
+namespace {
+
+uint32_t const kNativeStreamMagic = 0x52545353; // "SSTR"
+// Version 2 stores kDouble responses unchanged, rather than as deltas.
+// Version 3 derives value offsets from the slots, rather than storing them.
+uint32_t const kNativeStreamVersion = 3;
+
+static_assert(sizeof(EncodedEventResponse::Slot) == 8,
+              "Slots are written as is, and should stay 8 bytes.");
+
+// Tight loops over raw pointers so that decoding is auto-vectorized.
+void DecodeDoubles(double const *in, size_t n, double *out) {
+  std::copy_n(in, n, out);
+}
+void DecodeFloats(float const *in, size_t n, double *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = double(in[i]) + 1.0;
+  }
+}
+void DecodeInt16s(int16_t const *in, size_t n, double quantum, double *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = double(in[i]) * quantum + 1.0;
+  }
+}
+
+bool FitsInt16(std::vector<double> const &resps, double quantum,
+               double maxabserr) {
+  for (double r : resps) {
+    double q = std::nearbyint((r - 1.0) / quantum);
+    if (!(std::fabs(q) <= std::numeric_limits<int16_t>::max())) {
+      return false;
+    }
+    if (!(std::fabs((q * quantum + 1.0) - r) <= maxabserr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FitsFloat(std::vector<double> const &resps, double maxabserr) {
+  for (double r : resps) {
+    if (!(std::fabs((double(float(r - 1.0)) + 1.0) - r) <= maxabserr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T> void WritePOD(std::ostream &os, T const &v) {
+  os.write(reinterpret_cast<char const *>(&v), sizeof(T));
+}
+template <typename T>
+void WriteVect(std::ostream &os, std::vector<T> const &v) {
+  WritePOD(os, uint64_t(v.size()));
+  os.write(reinterpret_cast<char const *>(v.data()), v.size() * sizeof(T));
+}
+template <typename T> bool ReadPOD(std::istream &is, T &v) {
+  return bool(is.read(reinterpret_cast<char *>(&v), sizeof(T)));
+}
+// The number of bytes left in a seekable stream, or the largest uint64_t if
+// the stream cannot seek.
+uint64_t GetRemainingBytes(std::istream &is) {
+  std::streampos pos = is.tellg();
+  if (pos == std::streampos(-1)) {
+    is.clear();
+    return std::numeric_limits<uint64_t>::max();
+  }
+  is.seekg(0, std::ios::end);
+  std::streampos end = is.tellg();
+  is.seekg(pos);
+  if ((end == std::streampos(-1)) || (end < pos)) {
+    is.clear();
+    is.seekg(pos);
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return uint64_t(end - pos);
+}
+
+// The element count is read from the stream, so is checked against what
+// remains before allocating. Streams that cannot seek are read in bounded
+// chunks, so a corrupt count fails at the end of the stream rather than
+// allocating it up front.
+template <typename T> void ReadVect(std::istream &is, std::vector<T> &v) {
+  uint64_t n;
+  if (!ReadPOD(is, n)) {
+    throw corrupt_encoded_response_stream()
+        << "[ERROR]: Native response stream ended mid-record.";
+  }
+  uint64_t NRemaining = GetRemainingBytes(is) / sizeof(T);
+  if (n > NRemaining) {
+    throw corrupt_encoded_response_stream()
+        << "[ERROR]: Native response stream record declares " << n
+        << " elements of size " << sizeof(T) << ", but only " << NRemaining
+        << " remain in the stream.";
+  }
+  uint64_t const kChunk = (uint64_t(1) << 20) / sizeof(T);
+  v.clear();
+  for (uint64_t NRead = 0; NRead < n;) {
+    uint64_t NChunk = std::min(n - NRead, kChunk);
+    v.resize(NRead + NChunk);
+    if (!is.read(reinterpret_cast<char *>(v.data() + NRead),
+                 NChunk * sizeof(T))) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream ended mid-record, expected "
+          << n << " elements of size " << sizeof(T) << ".";
+    }
+    NRead += NChunk;
+  }
+}
+
+} // namespace
+
+std::string to_str(ResponseEncoding enc) {
+  switch (enc) {
+  case ResponseEncoding::kDouble: {
+    return "double";
+  }
+  case ResponseEncoding::kFloat: {
+    return "float";
+  }
+  case ResponseEncoding::kInt16: {
+    return "int16";
+  }
+  }
+  return "unknown";
+}
+
+ResponseEncodingSpec GetResponseEncodingSpec(SystParamHeader const &hdr) {
+  ResponseEncodingSpec spec{ResponseEncoding::kDouble, 0};
+
+  std::string_view encstr;
+  if (!hdr.opts.FindKV(kResponseEncodingOptKey, encstr)) {
+    return spec;
+  }
+  if (encstr == "double") {
+    return spec;
+  } else if (encstr == "float") {
+    spec.encoding = ResponseEncoding::kFloat;
+  } else if (encstr == "int16") {
+    spec.encoding = ResponseEncoding::kInt16;
+  } else {
+    throw invalid_response_encoding()
+        << "[ERROR]: SystParamHeader(" << hdr.systParamId << ":"
+        << std::quoted(hdr.prettyName) << ") declares unknown "
+        << kResponseEncodingOptKey << ": " << std::quoted(encstr)
+        << ", expected one of double, float, or int16.";
+  }
+
+  std::string_view errstr;
+  if (hdr.opts.FindKV(kResponseEncodingMaxAbsErrorOptKey, errstr) &&
+      !ParseValue(errstr, spec.MaxAbsError)) {
+    spec.MaxAbsError = 0;
+  }
+  if (!(spec.MaxAbsError > 0) || !std::isfinite(spec.MaxAbsError)) {
+    throw invalid_response_encoding()
+        << "[ERROR]: SystParamHeader(" << hdr.systParamId << ":"
+        << std::quoted(hdr.prettyName) << ") declares a lossy "
+        << kResponseEncodingOptKey << " (" << encstr
+        << "), but does not declare a valid, positive "
+        << kResponseEncodingMaxAbsErrorOptKey << " (found "
+        << std::quoted(errstr) << ").";
+  }
+  return spec;
+}
+
+void SetResponseEncodingSpec(SystParamHeader &hdr,
+                             ResponseEncodingSpec const &spec) {
+  hdr.opts.EraseKV(kResponseEncodingMaxAbsErrorOptKey);
+  hdr.opts.SetKV(kResponseEncodingOptKey, to_str(spec.encoding));
+  if (spec.encoding != ResponseEncoding::kDouble) {
+    std::stringstream ss("");
+    ss << std::setprecision(std::numeric_limits<double>::max_digits10)
+       << spec.MaxAbsError;
+    hdr.opts.SetKV(kResponseEncodingMaxAbsErrorOptKey, ss.str());
+  }
+}
+
+void EncodedEventResponse::SetHeaders(param_header_map_t const &headers) {
+  fSpecs.clear();
+  for (auto const &hdr_it : headers) {
+    fSpecs[hdr_it.first] = GetResponseEncodingSpec(hdr_it.second.Header);
+  }
+}
+void EncodedEventResponse::SetHeaders(SystMetaData const &md) {
+  fSpecs.clear();
+  for (auto const &hdr : md) {
+    fSpecs[hdr.systParamId] = GetResponseEncodingSpec(hdr);
+  }
+}
+
+void EncodedEventResponse::Clear() {
+  fUnitOffsets.resize(1);
+  fUnitValueOffsets.resize(kNEncodings);
+  fSlots.clear();
+  fDoubles.clear();
+  fFloats.clear();
+  fInt16s.clear();
+  fNEscaped = 0;
+}
+
+void EncodedEventResponse::Encode(EventResponse const &er) {
+  Clear();
+  fUnitOffsets.reserve(er.size() + 1);
+  fUnitValueOffsets.reserve(kNEncodings * (er.size() + 1));
+  for (auto const &eur : er) {
+    Append(eur);
+  }
+}
+
+void EncodedEventResponse::Append(event_unit_response_t const &eur) {
+  for (auto const &pr : eur) {
+    AppendSlot(pr);
+  }
+  fUnitOffsets.push_back(fSlots.size());
+  fUnitValueOffsets.push_back(fDoubles.size());
+  fUnitValueOffsets.push_back(fFloats.size());
+  fUnitValueOffsets.push_back(fInt16s.size());
+}
+
+uint64_t EncodedEventResponse::GetValueOffset(size_t unit,
+                                              size_t slot) const {
+  Slot const *slots = fSlots.data() + fUnitOffsets[unit];
+  uint64_t offset = fUnitValueOffsets[(kNEncodings * unit) +
+                                      slots[slot].encoding];
+  for (size_t s_it = 0; s_it < slot; ++s_it) {
+    if (slots[s_it].encoding == slots[slot].encoding) {
+      offset += slots[s_it].n;
+    }
+  }
+  return offset;
+}
+
+void EncodedEventResponse::BuildValueOffsets() {
+  fUnitValueOffsets.assign(kNEncodings, 0);
+  fUnitValueOffsets.reserve(kNEncodings * fUnitOffsets.size());
+  uint64_t offsets[kNEncodings] = {0, 0, 0};
+  for (size_t u_it = 1; u_it < fUnitOffsets.size(); ++u_it) {
+    for (size_t s_it = fUnitOffsets[u_it - 1]; s_it < fUnitOffsets[u_it];
+         ++s_it) {
+      offsets[fSlots[s_it].encoding] += fSlots[s_it].n;
+    }
+    fUnitValueOffsets.insert(fUnitValueOffsets.end(), offsets,
+                             offsets + kNEncodings);
+  }
+}
+
+void EncodedEventResponse::AppendSlot(ParamResponses const &pr) {
+  ResponseEncodingSpec spec{ResponseEncoding::kDouble, 0};
+  auto const &spec_it = fSpecs.find(pr.pid);
+  if (spec_it != fSpecs.end()) {
+    spec = spec_it->second;
+  }
+
+  // Escape to a more precise encoding if the declared tolerance cannot be
+  // honoured for this response.
+  ResponseEncoding enc = spec.encoding;
+  if ((enc == ResponseEncoding::kInt16) &&
+      !FitsInt16(pr.responses, spec.Quantum(), spec.MaxAbsError)) {
+    enc = ResponseEncoding::kFloat;
+  }
+  if ((enc == ResponseEncoding::kFloat) &&
+      !FitsFloat(pr.responses, spec.MaxAbsError)) {
+    enc = ResponseEncoding::kDouble;
+  }
+  if (enc != spec.encoding) {
+    fNEscaped += pr.responses.size();
+  }
+
+  Slot slot;
+  slot.pid = pr.pid;
+  slot.n = pr.responses.size();
+  slot.encoding = uint32_t(enc);
+
+  switch (enc) {
+  case ResponseEncoding::kDouble: {
+    fDoubles.insert(fDoubles.end(), pr.responses.begin(), pr.responses.end());
+    break;
+  }
+  case ResponseEncoding::kFloat: {
+    for (double r : pr.responses) {
+      fFloats.push_back(float(r - 1.0));
+    }
+    break;
+  }
+  case ResponseEncoding::kInt16: {
+    double quantum = spec.Quantum();
+    for (double r : pr.responses) {
+      fInt16s.push_back(int16_t(std::nearbyint((r - 1.0) / quantum)));
+    }
+    break;
+  }
+  }
+  fSlots.push_back(slot);
+}
+
+void EncodedEventResponse::DecodeSlot(size_t unit, size_t slot,
+                                      double *out) const {
+  DecodeValues(GetSlot(unit, slot), GetValueOffset(unit, slot), out);
+}
+
+void EncodedEventResponse::DecodeValues(Slot const &s, uint64_t offset,
+                                        double *out) const {
+  switch (ResponseEncoding(s.encoding)) {
+  case ResponseEncoding::kDouble: {
+    DecodeDoubles(fDoubles.data() + offset, s.n, out);
+    break;
+  }
+  case ResponseEncoding::kFloat: {
+    DecodeFloats(fFloats.data() + offset, s.n, out);
+    break;
+  }
+  case ResponseEncoding::kInt16: {
+    DecodeInt16s(fInt16s.data() + offset, s.n, fSpecs.at(s.pid).Quantum(),
+                 out);
+    break;
+  }
+  }
+}
+
+void EncodedEventResponse::DecodeUnit(size_t unit,
+                                      event_unit_response_t &out) const {
+  size_t NSlots = GetNSlots(unit);
+  out.resize(NSlots);
+  uint64_t offsets[kNEncodings];
+  std::copy_n(fUnitValueOffsets.data() + (kNEncodings * unit), kNEncodings,
+              offsets);
+  for (size_t s_it = 0; s_it < NSlots; ++s_it) {
+    Slot const &s = GetSlot(unit, s_it);
+    out[s_it].pid = s.pid;
+    out[s_it].responses.resize(s.n);
+    DecodeValues(s, offsets[s.encoding], out[s_it].responses.data());
+    offsets[s.encoding] += s.n;
+  }
+}
+
+void EncodedEventResponse::Decode(EventResponse &out) const {
+  size_t NUnits = GetNUnits();
+  out.resize(NUnits);
+  for (size_t u_it = 0; u_it < NUnits; ++u_it) {
+    DecodeUnit(u_it, out[u_it]);
+  }
+}
+
+size_t EncodedEventResponse::GetEncodedSize() const {
+  return (fUnitOffsets.size() * sizeof(uint64_t)) +
+         (fSlots.size() * sizeof(Slot)) + (fDoubles.size() * sizeof(double)) +
+         (fFloats.size() * sizeof(float)) +
+         (fInt16s.size() * sizeof(int16_t));
+}
+
+MemoryBreakdown EncodedEventResponse::MemoryFootprint() const {
+  MemoryBreakdown mb;
+  mb.Add("maps", footprint::NodeBytes(fSpecs));
+  mb.Add("index", footprint::HeapBytes(fUnitOffsets) +
+                      footprint::HeapBytes(fUnitValueOffsets) +
+                      footprint::HeapBytes(fSlots));
+  mb.Add("responses", footprint::HeapBytes(fDoubles) +
+                          footprint::HeapBytes(fFloats) +
+                          footprint::HeapBytes(fInt16s));
+  return mb;
+}
+
+EncodedResponseWriter::EncodedResponseWriter(
+    std::ostream &os, std::map<paramId_t, ResponseEncodingSpec> const &specs)
+    : fOS(os) {
+  WritePOD(fOS, kNativeStreamMagic);
+  WritePOD(fOS, kNativeStreamVersion);
+  WritePOD(fOS, uint64_t(specs.size()));
+  for (auto const &spec : specs) {
+    WritePOD(fOS, spec.first);
+    WritePOD(fOS, uint8_t(spec.second.encoding));
+    WritePOD(fOS, spec.second.MaxAbsError);
+  }
+}
+
+void EncodedResponseWriter::Write(EncodedEventResponse const &enc) {
+  WriteVect(fOS, enc.fUnitOffsets);
+  WriteVect(fOS, enc.fSlots);
+  WriteVect(fOS, enc.fDoubles);
+  WriteVect(fOS, enc.fFloats);
+  WriteVect(fOS, enc.fInt16s);
+}
+
+EncodedResponseReader::EncodedResponseReader(std::istream &is) : fIS(is) {
+  uint32_t magic = 0, version = 0;
+  ReadPOD(fIS, magic);
+  ReadPOD(fIS, version);
+  if ((magic != kNativeStreamMagic) || (version != kNativeStreamVersion)) {
+    throw corrupt_encoded_response_stream()
+        << "[ERROR]: Input stream is not a native systematic response stream "
+           "(magic: "
+        << magic << ", version: " << version << ").";
+  }
+  uint64_t NSpecs = 0;
+  ReadPOD(fIS, NSpecs);
+  for (uint64_t s_it = 0; s_it < NSpecs; ++s_it) {
+    paramId_t pid;
+    uint8_t enc;
+    double maxabserr;
+    if (!ReadPOD(fIS, pid) || !ReadPOD(fIS, enc) || !ReadPOD(fIS, maxabserr)) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream ended while reading the "
+             "encoding table.";
+    }
+    if (enc > uint8_t(ResponseEncoding::kInt16)) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream encoding table declares unknown "
+             "encoding "
+          << int(enc) << " for parameter " << pid << ".";
+    }
+    fSpecs[pid] = ResponseEncodingSpec{ResponseEncoding(enc), maxabserr};
+  }
+}
+
+void EncodedResponseReader::CheckRecord(EncodedEventResponse const &enc) {
+  if (enc.fUnitOffsets.front() != 0) {
+    throw corrupt_encoded_response_stream()
+        << "[ERROR]: Native response stream record unit offsets start at "
+        << enc.fUnitOffsets.front() << ", expected 0.";
+  }
+  for (size_t u_it = 1; u_it < enc.fUnitOffsets.size(); ++u_it) {
+    if ((enc.fUnitOffsets[u_it] < enc.fUnitOffsets[u_it - 1]) ||
+        (enc.fUnitOffsets[u_it] > enc.fSlots.size())) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream record unit offset " << u_it
+          << " = " << enc.fUnitOffsets[u_it]
+          << " is decreasing, or beyond the " << enc.fSlots.size()
+          << " slots in the record.";
+    }
+  }
+  if (enc.fUnitOffsets.back() != enc.fSlots.size()) {
+    throw corrupt_encoded_response_stream()
+        << "[ERROR]: Native response stream record unit offsets cover "
+        << enc.fUnitOffsets.back() << " slots, but the record holds "
+        << enc.fSlots.size() << ".";
+  }
+
+  // The values of each encoding are those of its slots, in order.
+  uint64_t NUsed[EncodedEventResponse::kNEncodings] = {0, 0, 0};
+  uint64_t NValues[EncodedEventResponse::kNEncodings] = {
+      enc.fDoubles.size(), enc.fFloats.size(), enc.fInt16s.size()};
+  for (size_t s_it = 0; s_it < enc.fSlots.size(); ++s_it) {
+    EncodedEventResponse::Slot const &s = enc.fSlots[s_it];
+    if (s.encoding >= EncodedEventResponse::kNEncodings) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream record slot " << s_it
+          << " declares unknown encoding " << s.encoding << ".";
+    }
+    // Decoding int16 responses needs the quantum of the parameter.
+    if ((ResponseEncoding(s.encoding) == ResponseEncoding::kInt16) &&
+        !enc.fSpecs.count(s.pid)) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream record slot " << s_it
+          << " holds int16 responses for parameter " << s.pid
+          << ", which is not in the encoding table.";
+    }
+    NUsed[s.encoding] += s.n;
+    if (NUsed[s.encoding] > NValues[s.encoding]) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream record slot " << s_it
+          << " refers to " << s.n << " " << to_str(ResponseEncoding(s.encoding))
+          << " values, beyond the " << NValues[s.encoding]
+          << " that the record holds.";
+    }
+  }
+  for (size_t e_it = 0; e_it < EncodedEventResponse::kNEncodings; ++e_it) {
+    if (NUsed[e_it] != NValues[e_it]) {
+      throw corrupt_encoded_response_stream()
+          << "[ERROR]: Native response stream record holds " << NValues[e_it]
+          << " " << to_str(ResponseEncoding(e_it)) << " values, but its slots "
+          << "refer to " << NUsed[e_it] << ".";
+    }
+  }
+}
+
+bool EncodedResponseReader::Read(EncodedEventResponse &enc) {
+  if (fIS.peek() == std::char_traits<char>::eof()) {
+    return false;
+  }
+  enc.fSpecs = fSpecs;
+  enc.fNEscaped = 0;
+  ReadVect(fIS, enc.fUnitOffsets);
+  ReadVect(fIS, enc.fSlots);
+  ReadVect(fIS, enc.fDoubles);
+  ReadVect(fIS, enc.fFloats);
+  ReadVect(fIS, enc.fInt16s);
+  if (enc.fUnitOffsets.empty()) {
+    throw corrupt_encoded_response_stream()
+        << "[ERROR]: Native response stream record contains no unit offsets.";
+  }
+  CheckRecord(enc);
+  enc.BuildValueOffsets();
+  return true;
+}
+
+void ValidateResponseEncoding(EventResponse const &er,
+                              EncodedEventResponse const &enc,
+                              ResponseEncodingReport &rpt) {
+  if (er.size() != enc.GetNUnits()) {
+    throw incompatible_number_of_event_units()
+        << "[ERROR]: Attempted to validate an encoding of " << enc.GetNUnits()
+        << " event units against " << er.size() << " decoded event units.";
+  }
+
+  std::vector<double> decoded;
+  for (size_t u_it = 0; u_it < er.size(); ++u_it) {
+    event_unit_response_t const &eur = er[u_it];
+    if (eur.size() != enc.GetNSlots(u_it)) {
+      throw mismatched_encoded_response()
+          << "[ERROR]: Attempted to validate event unit " << u_it
+          << ", encoded with " << enc.GetNSlots(u_it)
+          << " parameter responses, against " << eur.size() << ".";
+    }
+    rpt.DecodedBytes += sizeof(event_unit_response_t);
+    for (size_t s_it = 0; s_it < eur.size(); ++s_it) {
+      ParamResponses const &pr = eur[s_it];
+      EncodedEventResponse::Slot const &s = enc.GetSlot(u_it, s_it);
+      if ((s.pid != pr.pid) || (s.n != pr.responses.size())) {
+        throw mismatched_encoded_response()
+            << "[ERROR]: Attempted to validate event unit " << u_it
+            << ", slot " << s_it << ", encoded with " << s.n
+            << " responses to parameter " << s.pid << ", against "
+            << pr.responses.size() << " responses to parameter " << pr.pid
+            << ".";
+      }
+
+      auto const &spec_it = enc.GetEncodingSpecs().find(pr.pid);
+      ResponseEncodingSpec spec = (spec_it == enc.GetEncodingSpecs().end())
+                                      ? ResponseEncodingSpec{
+                                            ResponseEncoding::kDouble, 0}
+                                      : spec_it->second;
+
+      auto stat_it = rpt.params
+                         .emplace(pr.pid, ResponseEncodingReport::ParamStats{
+                                              spec, 0, 0, 0})
+                         .first;
+
+      decoded.resize(s.n);
+      enc.DecodeSlot(u_it, s_it, decoded.data());
+      stat_it->second.NResponses += pr.responses.size();
+      if (ResponseEncoding(s.encoding) != spec.encoding) {
+        stat_it->second.NEscaped += s.n;
+      }
+      for (size_t r_it = 0; r_it < pr.responses.size(); ++r_it) {
+        double err = std::fabs(decoded[r_it] - pr.responses[r_it]);
+        stat_it->second.MaxAbsError =
+            std::max(stat_it->second.MaxAbsError, err);
+      }
+      rpt.DecodedBytes +=
+          sizeof(ParamResponses) + pr.responses.size() * sizeof(double);
+    }
+  }
+  rpt.NUnits += er.size();
+  rpt.EncodedBytes += enc.GetEncodedSize();
+}
+
+std::string to_str(ResponseEncodingReport const &rpt) {
+  std::stringstream ss("");
+  ss << "Response encoding report for " << rpt.NUnits << " event units:"
+     << std::endl;
+  ss << "\tDecoded size: " << rpt.DecodedBytes
+     << " B, encoded size: " << rpt.EncodedBytes << " B";
+  if (rpt.EncodedBytes) {
+    ss << " (x" << (double(rpt.DecodedBytes) / double(rpt.EncodedBytes))
+       << " smaller)";
+  }
+  ss << std::endl;
+  for (auto const &ps : rpt.params) {
+    bool within = ps.second.spec.encoding == ResponseEncoding::kDouble
+                      ? (ps.second.MaxAbsError <= 0)
+                      : (ps.second.MaxAbsError <= ps.second.spec.MaxAbsError);
+    ss << "\tParam " << ps.first << ": { encoding: "
+       << to_str(ps.second.spec.encoding)
+       << ", declared max |err|: " << ps.second.spec.MaxAbsError
+       << ", observed max |err|: " << ps.second.MaxAbsError
+       << ", responses: " << ps.second.NResponses
+       << ", escaped: " << ps.second.NEscaped << " } "
+       << (within ? "OK" : "FAIL") << std::endl;
+  }
+  return ss.str();
+}
+
+} // namespace systtools
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "systematicstools/interface/EventResponse_product.hh"
+#include "systematicstools/interface/SystMetaData.hh"
+#include "systematicstools/interface/types.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when a SystParamHeader declares an encoding that
+/// cannot be understood.
+NEW_SYSTTOOLS_EXCEPT(invalid_response_encoding);
+///\brief Exception raised when reading a malformed native response stream.
+NEW_SYSTTOOLS_EXCEPT(corrupt_encoded_response_stream);
+///\brief Exception raised when an encoding is validated against responses
+/// that it was not encoded from.
+NEW_SYSTTOOLS_EXCEPT(mismatched_encoded_response);
+
+///\brief Storage precision used for the per-event responses of a parameter.
+///
+/// The lossy encodings store responses as deltas from unity, as the vast
+/// majority of weight responses are within a few percent of 1.
+///
+/// * kDouble: Lossless, the response is stored unchanged.
+/// * kFloat: Single precision delta from unity.
+/// * kInt16: Delta from unity stored as a signed 16 bit multiple of
+/// 2*MaxAbsError.
+enum class ResponseEncoding : uint8_t { kDouble = 0, kFloat = 1, kInt16 = 2 };
+
+/// SystParamHeader::opts key used to declare a ResponseEncoding
+/// (double/float/int16).
+constexpr char const *kResponseEncodingOptKey = "ResponseEncoding";
+/// SystParamHeader::opts key used to declare the maximum absolute error
+/// tolerated when encoding responses for a parameter.
+constexpr char const *kResponseEncodingMaxAbsErrorOptKey =
+    "ResponseEncodingMaxAbsError";
+
+///\brief The encoding and tolerance declared for a parameter.
+struct ResponseEncodingSpec {
+  ResponseEncoding encoding;
+  double MaxAbsError;
+
+  /// The step size of the kInt16 encoding.
+  double Quantum() const { return 2 * MaxAbsError; }
+};
+
+std::string to_str(ResponseEncoding);
+
+///\brief Reads the declared response encoding from SystParamHeader::opts
+///
+/// Parameters without an encoding declaration are stored losslessly.
+///
+///\note throws invalid_response_encoding for unknown encodings or missing or
+/// non-positive tolerances on lossy encodings.
+ResponseEncodingSpec GetResponseEncodingSpec(SystParamHeader const &hdr);
+
+///\brief Records the response encoding in SystParamHeader::opts, replacing
+/// any previous declaration.
+void SetResponseEncodingSpec(SystParamHeader &hdr,
+                             ResponseEncodingSpec const &spec);
+
+///\brief Compact, columnar storage for the responses of an EventResponse.
+///
+/// Each parameter response in each event unit is stored in a slot that refers
+/// to a contiguous run of values in one of three pools, one per
+/// ResponseEncoding. The encoding of each parameter is declared in its header
+/// (see GetResponseEncodingSpec). Responses that cannot be represented within
+/// the declared tolerance are transparently escaped to the next most precise
+/// encoding, so decoding is always within MaxAbsError of the input.
+///
+/// Slots do not store the offset of their values, which follow those of the
+/// previous slot with the same encoding. The offsets of the first values of
+/// each unit in each pool are kept alongside, but are not written by
+/// EncodedResponseWriter, as the reader rebuilds them.
+class EncodedEventResponse {
+public:
+  struct Slot {
+    paramId_t pid;
+    uint32_t n : 30;
+    uint32_t encoding : 2;
+  };
+
+  EncodedEventResponse() {}
+  EncodedEventResponse(param_header_map_t const &headers) {
+    SetHeaders(headers);
+  }
+  EncodedEventResponse(SystMetaData const &md) { SetHeaders(md); }
+
+  void SetHeaders(param_header_map_t const &headers);
+  void SetHeaders(SystMetaData const &md);
+  void SetEncodingSpecs(std::map<paramId_t, ResponseEncodingSpec> specs) {
+    fSpecs = std::move(specs);
+  }
+  std::map<paramId_t, ResponseEncodingSpec> const &GetEncodingSpecs() const {
+    return fSpecs;
+  }
+
+  /// Drops all encoded units, keeping allocated capacity.
+  void Clear();
+
+  /// Clears and encodes all units of er.
+  void Encode(EventResponse const &er);
+  /// Appends a single encoded event unit.
+  void Append(event_unit_response_t const &eur);
+
+  size_t GetNUnits() const { return fUnitOffsets.size() - 1; }
+  size_t GetNSlots(size_t unit) const {
+    return fUnitOffsets[unit + 1] - fUnitOffsets[unit];
+  }
+  Slot const &GetSlot(size_t unit, size_t slot) const {
+    return fSlots[fUnitOffsets[unit] + slot];
+  }
+
+  ///\brief Decodes the responses of one slot into out, which must have room
+  /// for GetSlot(unit, slot).n values.
+  void DecodeSlot(size_t unit, size_t slot, double *out) const;
+  ///\brief Decodes a single event unit into out.
+  ///
+  /// The capacity of out and its contained response vectors is re-used.
+  void DecodeUnit(size_t unit, event_unit_response_t &out) const;
+  ///\brief Decodes all units into out, re-using the capacity of out.
+  void Decode(EventResponse &out) const;
+  EventResponse Decode() const {
+    EventResponse er;
+    Decode(er);
+    return er;
+  }
+
+  ///\brief The number of bytes used by the encoded payload, as written by
+  /// EncodedResponseWriter.
+  size_t GetEncodedSize() const;
+  ///\brief Number of responses that had to be escaped to a more precise
+  /// encoding than declared, since the last Clear.
+  size_t GetNEscapedResponses() const { return fNEscaped; }
+
+  ///\brief The allocated memory, reported as "maps" for the encoding specs,
+  /// "index" for the unit and value offsets and the slots, and "responses".
+  MemoryBreakdown MemoryFootprint() const;
+
+private:
+  friend class EncodedResponseWriter;
+  friend class EncodedResponseReader;
+
+  static constexpr size_t kNEncodings = 3;
+
+  void AppendSlot(ParamResponses const &pr);
+  ///\brief The offset of the first value of a slot in the pool of its
+  /// encoding.
+  uint64_t GetValueOffset(size_t unit, size_t slot) const;
+  ///\brief Rebuilds fUnitValueOffsets from the slots.
+  void BuildValueOffsets();
+  void DecodeValues(Slot const &s, uint64_t offset, double *out) const;
+
+  std::map<paramId_t, ResponseEncodingSpec> fSpecs;
+
+  std::vector<uint64_t> fUnitOffsets{0};
+  std::vector<Slot> fSlots;
+  ///\brief The offsets of the first values of each unit, kNEncodings per
+  /// unit, indexed by ResponseEncoding, with a final entry for the end.
+  std::vector<uint64_t> fUnitValueOffsets =
+      std::vector<uint64_t>(kNEncodings, 0);
+  std::vector<double> fDoubles;
+  std::vector<float> fFloats;
+  std::vector<int16_t> fInt16s;
+
+  size_t fNEscaped = 0;
+};
+
+///\brief Writes EncodedEventResponses to a native, binary stream.
+///
+/// The stream starts with a header holding the encoding table, followed by one
+/// record per call to Write. Values are written in host byte order.
+class EncodedResponseWriter {
+public:
+  EncodedResponseWriter(std::ostream &os,
+                        std::map<paramId_t, ResponseEncodingSpec> const &specs);
+
+  void Write(EncodedEventResponse const &enc);
+
+private:
+  std::ostream &fOS;
+};
+
+///\brief Reads EncodedEventResponses back from a stream written by
+/// EncodedResponseWriter.
+class EncodedResponseReader {
+public:
+  EncodedResponseReader(std::istream &is);
+
+  std::map<paramId_t, ResponseEncodingSpec> const &GetEncodingSpecs() const {
+    return fSpecs;
+  }
+
+  ///\brief Reads the next record into enc, returns false at the end of the
+  /// stream.
+  ///
+  ///\note throws corrupt_encoded_response_stream if the record is truncated,
+  /// declares more values than remain in the stream, or its unit offsets or
+  /// slots do not refer to exactly the values that it holds.
+  bool Read(EncodedEventResponse &enc);
+
+private:
+  static void CheckRecord(EncodedEventResponse const &enc);
+
+  std::istream &fIS;
+  std::map<paramId_t, ResponseEncodingSpec> fSpecs;
+};
+
+///\brief Summary of the precision and storage cost of an encoding, accumulated
+/// over any number of encoded batches.
+struct ResponseEncodingReport {
+  struct ParamStats {
+    ResponseEncodingSpec spec;
+    size_t NResponses;
+    size_t NEscaped;
+    double MaxAbsError;
+  };
+  std::map<paramId_t, ParamStats> params;
+  size_t NUnits = 0;
+  size_t DecodedBytes = 0;
+  size_t EncodedBytes = 0;
+};
+
+///\brief Compares an encoded batch to the original responses and accumulates
+/// the result into rpt.
+///
+/// \note throws incompatible_number_of_event_units if the unit counts of er
+/// and enc differ, and mismatched_encoded_response if the parameters or
+/// response counts of any event unit differ.
+void ValidateResponseEncoding(EventResponse const &er,
+                              EncodedEventResponse const &enc,
+                              ResponseEncodingReport &rpt);
+
+std::string to_str(ResponseEncodingReport const &rpt);
+
+} // namespace systtools
@@ -0,0 +1,260 @@
+#include "systematicstools/interface/EventResponseIndex.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+namespace systtools {
+
+namespace {
+
+uint32_t const kIndexMagic = 0x58495253; // "SRIX"
+uint32_t const kIndexVersion = 1;
+
+template <typename T> void WritePOD(std::ostream &os, T const &v) {
+  os.write(reinterpret_cast<char const *>(&v), sizeof(T));
+}
+template <typename T> void ReadPOD(std::istream &is, T &v) {
+  if (!is.read(reinterpret_cast<char *>(&v), sizeof(T))) {
+    throw corrupt_event_response_index()
+        << "[ERROR]: Event response index sidecar ended unexpectedly.";
+  }
+}
+void WriteString(std::ostream &os, std::string const &s) {
+  WritePOD(os, uint64_t(s.size()));
+  os.write(s.data(), s.size());
+}
+void ReadString(std::istream &is, std::string &s) {
+  uint64_t n;
+  ReadPOD(is, n);
+  s.resize(n);
+  if (!is.read(&s[0], n)) {
+    throw corrupt_event_response_index()
+        << "[ERROR]: Event response index sidecar ended unexpectedly.";
+  }
+}
+
+bool KeyLess(EventResponseIndex::Location const &l,
+             EventResponseIndex::Location const &r) {
+  return l.key < r.key;
+}
+
+} // namespace
+
+std::string to_str(EventKey const &key) {
+  std::stringstream ss("");
+  ss << "{ run: " << key.run << ", subrun: " << key.subrun
+     << ", event: " << key.event << ", unit: " << key.unit << " }";
+  return ss.str();
+}
+
+uint32_t EventResponseIndex::AddFile(std::string const &file_name) {
+  fFiles.push_back(file_name);
+  return uint32_t(fFiles.size() - 1);
+}
+
+void EventResponseIndex::Add(EventKey const &key, uint32_t file,
+                             uint64_t entry) {
+  if (file >= fFiles.size()) {
+    throw corrupt_event_response_index()
+        << "[ERROR]: Attempted to index " << to_str(key)
+        << " against file number " << file << ", but only " << fFiles.size()
+        << " files have been registered.";
+  }
+  // Keys written in order keep the index sorted and finalization cheap.
+  if (fFinalized && fLocations.size() && !(fLocations.back().key < key)) {
+    fFinalized = false;
+  }
+  fLocations.push_back(Location{key, file, entry});
+}
+
+void EventResponseIndex::Merge(EventResponseIndex const &other) {
+  uint32_t FileOffset = uint32_t(fFiles.size());
+  for (auto const &f : other.fFiles) {
+    fFiles.push_back(f);
+  }
+  fLocations.reserve(fLocations.size() + other.fLocations.size());
+  for (auto const &loc : other.fLocations) {
+    fLocations.push_back(Location{loc.key, loc.file + FileOffset, loc.entry});
+  }
+  fFinalized = false;
+  Finalize();
+}
+
+void EventResponseIndex::Finalize() {
+  if (!std::is_sorted(fLocations.begin(), fLocations.end(), KeyLess)) {
+    std::stable_sort(fLocations.begin(), fLocations.end(), KeyLess);
+  }
+  for (size_t l_it = 1; l_it < fLocations.size(); ++l_it) {
+    if (fLocations[l_it - 1].key == fLocations[l_it].key) {
+      Location const &a = fLocations[l_it - 1];
+      Location const &b = fLocations[l_it];
+      throw duplicate_event_key()
+          << "[ERROR]: " << to_str(a.key) << " is indexed twice, at entry "
+          << a.entry << " of " << std::quoted(fFiles[a.file]) << " and entry "
+          << b.entry << " of " << std::quoted(fFiles[b.file]) << ".";
+    }
+  }
+  fFinalized = true;
+}
+
+void EventResponseIndex::CheckFinalized(char const *method) const {
+  if (!fFinalized) {
+    throw index_not_finalized()
+        << "[ERROR]: EventResponseIndex::" << method
+        << " called before EventResponseIndex::Finalize.";
+  }
+}
+
+EventResponseIndex::Location const *
+EventResponseIndex::Find(EventKey const &key) const {
+  CheckFinalized("Find");
+  auto it = std::lower_bound(
+      fLocations.begin(), fLocations.end(), key,
+      [](Location const &l, EventKey const &k) { return l.key < k; });
+  if ((it == fLocations.end()) || (it->key != key)) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
+EventResponseIndex::Location const &
+EventResponseIndex::Get(EventKey const &key) const {
+  Location const *loc = Find(key);
+  if (!loc) {
+    throw event_key_not_found()
+        << "[ERROR]: " << to_str(key) << " is not present in the index.";
+  }
+  return *loc;
+}
+
+std::vector<EventResponseIndex::Location>
+EventResponseIndex::FindBatch(std::vector<EventKey> const &keys,
+                              std::vector<size_t> &order) const {
+  CheckFinalized("FindBatch");
+
+  // Look the keys up in key order, so each search starts from the last hit.
+  std::vector<size_t> by_key(keys.size());
+  std::iota(by_key.begin(), by_key.end(), 0);
+  std::sort(by_key.begin(), by_key.end(),
+            [&](size_t l, size_t r) { return keys[l] < keys[r]; });
+
+  std::vector<Location const *> found(keys.size(), nullptr);
+  auto from = fLocations.begin();
+  for (size_t k_it : by_key) {
+    from = std::lower_bound(
+        from, fLocations.end(), keys[k_it],
+        [](Location const &l, EventKey const &k) { return l.key < k; });
+    if ((from == fLocations.end()) || (from->key != keys[k_it])) {
+      throw event_key_not_found()
+          << "[ERROR]: " << to_str(keys[k_it])
+          << " is not present in the index.";
+    }
+    found[k_it] = &(*from);
+  }
+
+  order.resize(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+    return std::tie(found[l]->file, found[l]->entry) <
+           std::tie(found[r]->file, found[r]->entry);
+  });
+
+  std::vector<Location> locs;
+  locs.reserve(keys.size());
+  for (size_t o_it : order) {
+    locs.push_back(*found[o_it]);
+  }
+  return locs;
+}
+
+void EventResponseIndex::Write(std::ostream &os) const {
+  CheckFinalized("Write");
+  WritePOD(os, kIndexMagic);
+  WritePOD(os, kIndexVersion);
+  WriteString(os, fTreeName);
+  WritePOD(os, uint64_t(fFiles.size()));
+  for (auto const &f : fFiles) {
+    WriteString(os, f);
+  }
+  WritePOD(os, uint64_t(fLocations.size()));
+  for (auto const &loc : fLocations) {
+    WritePOD(os, loc.key.run);
+    WritePOD(os, loc.key.subrun);
+    WritePOD(os, loc.key.event);
+    WritePOD(os, loc.key.unit);
+    WritePOD(os, loc.file);
+    WritePOD(os, loc.entry);
+  }
+}
+
+void EventResponseIndex::Read(std::istream &is) {
+  uint32_t magic = 0, version = 0;
+  ReadPOD(is, magic);
+  ReadPOD(is, version);
+  if ((magic != kIndexMagic) || (version != kIndexVersion)) {
+    throw corrupt_event_response_index()
+        << "[ERROR]: Input is not an event response index sidecar (magic: "
+        << magic << ", version: " << version << ").";
+  }
+  ReadString(is, fTreeName);
+  uint64_t NFiles;
+  ReadPOD(is, NFiles);
+  fFiles.resize(NFiles);
+  for (auto &f : fFiles) {
+    ReadString(is, f);
+  }
+  uint64_t NLocations;
+  ReadPOD(is, NLocations);
+  fLocations.resize(NLocations);
+  for (auto &loc : fLocations) {
+    ReadPOD(is, loc.key.run);
+    ReadPOD(is, loc.key.subrun);
+    ReadPOD(is, loc.key.event);
+    ReadPOD(is, loc.key.unit);
+    ReadPOD(is, loc.file);
+    ReadPOD(is, loc.entry);
+    if (loc.file >= NFiles) {
+      throw corrupt_event_response_index()
+          << "[ERROR]: Index entry for " << to_str(loc.key)
+          << " refers to file number " << loc.file << ", but only " << NFiles
+          << " files are listed.";
+    }
+  }
+  fFinalized = false;
+  Finalize();
+}
+
+void EventResponseIndex::Save(std::string const &sidecar_name) const {
+  std::ofstream ofs(sidecar_name, std::ios::binary);
+  if (!ofs) {
+    throw corrupt_event_response_index()
+        << "[ERROR]: Failed to open " << std::quoted(sidecar_name)
+        << " for writing.";
+  }
+  Write(ofs);
+}
+
+EventResponseIndex EventResponseIndex::Load(std::string const &sidecar_name) {
+  std::ifstream ifs(sidecar_name, std::ios::binary);
+  if (!ifs) {
+    throw corrupt_event_response_index()
+        << "[ERROR]: Failed to open event response index sidecar "
+        << std::quoted(sidecar_name) << ".";
+  }
+  EventResponseIndex idx;
+  idx.Read(ifs);
+  return idx;
+}
+
+MemoryBreakdown EventResponseIndex::MemoryFootprint() const {
+  MemoryBreakdown mb;
+  mb.Add("index", footprint::HeapBytes(fLocations));
+  mb.Add("files",
+         footprint::HeapBytes(fTreeName) + footprint::HeapBytes(fFiles));
+  return mb;
+}
+
+} // namespace systtools
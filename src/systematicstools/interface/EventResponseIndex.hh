@@ -0,0 +1,123 @@
+#pragma once
+
+#include "systematicstools/utility/MemoryFootprint.hh"
+#include "systematicstools/utility/exceptions.hh"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when the same EventKey is added to an
+/// EventResponseIndex more than once.
+NEW_SYSTTOOLS_EXCEPT(duplicate_event_key);
+///\brief Exception raised when an EventKey cannot be found in an
+/// EventResponseIndex.
+NEW_SYSTTOOLS_EXCEPT(event_key_not_found);
+///\brief Exception raised when an EventResponseIndex is queried or written
+/// before being finalized.
+NEW_SYSTTOOLS_EXCEPT(index_not_finalized);
+///\brief Exception raised when reading a malformed index sidecar.
+NEW_SYSTTOOLS_EXCEPT(corrupt_event_response_index);
+
+///\brief Uniquely identifies an event unit across a set of response files.
+struct EventKey {
+  uint32_t run;
+  uint32_t subrun;
+  uint32_t event;
+  uint32_t unit;
+};
+
+inline bool operator<(EventKey const &l, EventKey const &r) {
+  return std::tie(l.run, l.subrun, l.event, l.unit) <
+         std::tie(r.run, r.subrun, r.event, r.unit);
+}
+inline bool operator==(EventKey const &l, EventKey const &r) {
+  return (l.run == r.run) && (l.subrun == r.subrun) && (l.event == r.event) &&
+         (l.unit == r.unit);
+}
+inline bool operator!=(EventKey const &l, EventKey const &r) {
+  return !(l == r);
+}
+
+std::string to_str(EventKey const &key);
+
+///\brief Sorted EventKey -> (file, entry) table covering a chain of response
+/// files.
+///
+/// Entries are added at write time, the index is then sorted and checked for
+/// duplicate keys by Finalize. Finalized indices can be saved to, and loaded
+/// from, a binary sidecar file, and combined with Merge to cover many files.
+class EventResponseIndex {
+public:
+  struct Location {
+    EventKey key;
+    uint32_t file;
+    uint64_t entry;
+  };
+
+  EventResponseIndex() {}
+  EventResponseIndex(std::string const &tree_name) : fTreeName(tree_name) {}
+
+  std::string const &GetTreeName() const { return fTreeName; }
+  void SetTreeName(std::string const &tree_name) { fTreeName = tree_name; }
+
+  ///\brief Registers a response file and returns its index.
+  uint32_t AddFile(std::string const &file_name);
+  size_t GetNFiles() const { return fFiles.size(); }
+  std::string const &GetFileName(uint32_t file) const {
+    return fFiles.at(file);
+  }
+
+  void Add(EventKey const &key, uint32_t file, uint64_t entry);
+
+  ///\brief Appends all files and entries of other, then re-finalizes.
+  ///
+  ///\note throws duplicate_event_key if any key is present in both.
+  void Merge(EventResponseIndex const &other);
+
+  ///\brief Sorts the table and checks for duplicate keys.
+  void Finalize();
+  bool IsFinalized() const { return fFinalized; }
+
+  size_t size() const { return fLocations.size(); }
+  std::vector<Location> const &GetLocations() const { return fLocations; }
+
+  ///\brief O(log n) lookup, returns nullptr if key is not indexed.
+  Location const *Find(EventKey const &key) const;
+  ///\brief As Find, but throws event_key_not_found.
+  Location const &Get(EventKey const &key) const;
+
+  ///\brief Looks up a batch of keys.
+  ///
+  /// The returned locations are ordered by (file, entry), so that reading them
+  /// in order is near-sequential. The i-th element of order holds the position
+  /// in keys that the i-th returned location corresponds to.
+  ///
+  ///\note throws event_key_not_found if any key is not indexed.
+  std::vector<Location> FindBatch(std::vector<EventKey> const &keys,
+                                  std::vector<size_t> &order) const;
+
+  void Write(std::ostream &os) const;
+  void Read(std::istream &is);
+
+  void Save(std::string const &sidecar_name) const;
+  static EventResponseIndex Load(std::string const &sidecar_name);
+
+  ///\brief The allocated memory, reported as "index" for the location table
+  /// and "files" for the tree and file names.
+  MemoryBreakdown MemoryFootprint() const;
+
+private:
+  void CheckFinalized(char const *method) const;
+
+  std::string fTreeName;
+  std::vector<std::string> fFiles;
+  std::vector<Location> fLocations;
+  bool fFinalized = false;
+};
+
+} // namespace systtools
@@ -0,0 +1,83 @@
+#include "systematicstools/interface/EventResponsePool.hh"
+
+namespace systtools {
+
+std::unique_ptr<EventResponse> EventResponsePool::Acquire(size_t NEventUnits) {
+  ++fCounters.NAcquired;
+  std::unique_ptr<EventResponse> er;
+  if (fFreeEventResponses.size()) {
+    er = std::move(fFreeEventResponses.back());
+    fFreeEventResponses.pop_back();
+  } else {
+    er = std::make_unique<EventResponse>();
+    ++fCounters.NEventResponsesCreated;
+  }
+  // Rather than resize, so that the event units come with their capacity.
+  er->reserve(NEventUnits);
+  for (size_t eu_it = 0; eu_it < NEventUnits; ++eu_it) {
+    er->push_back(AcquireEventUnit());
+  }
+  return er;
+}
+
+void EventResponsePool::Release(std::unique_ptr<EventResponse> &&er) {
+  if (!er) {
+    return;
+  }
+  ++fCounters.NReleased;
+  for (event_unit_response_t &eur : *er) {
+    Release(std::move(eur));
+  }
+  er->clear();
+  fFreeEventResponses.push_back(std::move(er));
+}
+
+event_unit_response_t EventResponsePool::AcquireEventUnit() {
+  if (fFreeEventUnits.empty()) {
+    ++fCounters.NEventUnitsCreated;
+    return event_unit_response_t();
+  }
+  event_unit_response_t eur = std::move(fFreeEventUnits.back());
+  fFreeEventUnits.pop_back();
+  return eur;
+}
+
+void EventResponsePool::Release(event_unit_response_t &&eur) {
+  for (ParamResponses &pr : eur) {
+    pr.responses.clear();
+    fFreeResponses.push_back(std::move(pr.responses));
+  }
+  eur.clear();
+  fFreeEventUnits.push_back(std::move(eur));
+}
+
+std::vector<double> EventResponsePool::AcquireResponses() {
+  if (fFreeResponses.empty()) {
+    ++fCounters.NResponseBuffersCreated;
+    return std::vector<double>();
+  }
+  std::vector<double> resps = std::move(fFreeResponses.back());
+  fFreeResponses.pop_back();
+  return resps;
+}
+
+MemoryBreakdown EventResponsePool::MemoryFootprint() const {
+  size_t UnitBytes = footprint::HeapBytes(fFreeEventResponses) +
+                     footprint::HeapBytes(fFreeEventUnits);
+  for (auto const &er : fFreeEventResponses) {
+    UnitBytes += sizeof(EventResponse) + footprint::HeapBytes(*er);
+  }
+  for (auto const &eur : fFreeEventUnits) {
+    UnitBytes += footprint::HeapBytes(eur);
+  }
+  size_t ResponseBytes = footprint::HeapBytes(fFreeResponses);
+  for (auto const &resps : fFreeResponses) {
+    ResponseBytes += footprint::HeapBytes(resps);
+  }
+  MemoryBreakdown mb;
+  mb.Add("event units", UnitBytes);
+  mb.Add("responses", ResponseBytes);
+  return mb;
+}
+
+} // namespace systtools
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "systematicstools/interface/EventResponse_product.hh"
+
+#include "systematicstools/utility/MemoryFootprint.hh"
+
+#include <memory>
+#include <vector>
+
+namespace systtools {
+
+///\brief A pool of EventResponses, and their event unit and parameter response
+/// vectors, that keep their capacity between events.
+///
+/// Each event, a driver Acquires an EventResponse with the required number of
+/// event units, fills it, e.g. with AddParamResponses, writes it out, and then
+/// Releases it back to the pool. Released responses are taken apart into
+/// their component vectors, which are handed out again on the next Acquire.
+/// As buffers only ever grow, once the pool has seen the largest event,
+/// steady-state processing makes no heap allocations. GetCounters shows how
+/// many buffers had to be created, and should stop changing after warm up.
+///
+///\note Not thread safe. Use one pool per thread.
+class EventResponsePool {
+public:
+  struct Counters {
+    ///\brief The number of calls to Acquire and Release.
+    size_t NAcquired, NReleased;
+    ///\brief The number of EventResponses, event unit responses, and
+    /// parameter response buffers created because the pool had none free.
+    size_t NEventResponsesCreated, NEventUnitsCreated, NResponseBuffersCreated;
+  };
+
+  ///\brief Gets an EventResponse holding NEventUnits empty event units.
+  std::unique_ptr<EventResponse> Acquire(size_t NEventUnits);
+  ///\brief Returns an EventResponse, and all of the vectors within it, to the
+  /// pool. er is left null.
+  void Release(std::unique_ptr<EventResponse> &&er);
+
+  ///\brief Gets an empty event unit response.
+  event_unit_response_t AcquireEventUnit();
+  ///\brief Returns an event unit response, and all of its parameter response
+  /// buffers, to the pool.
+  void Release(event_unit_response_t &&eur);
+
+  ///\brief Gets an empty response buffer.
+  std::vector<double> AcquireResponses();
+  ///\brief Appends the responses of parameter pid to eur, in a buffer from the
+  /// pool, and returns the empty buffer to be filled.
+  std::vector<double> &AddParamResponses(event_unit_response_t &eur,
+                                         paramId_t pid) {
+    eur.push_back({pid, AcquireResponses()});
+    return eur.back().responses;
+  }
+
+  Counters const &GetCounters() const { return fCounters; }
+
+  ///\brief The memory held by free buffers in the pool, reported as
+  /// "event units" and "responses".
+  MemoryBreakdown MemoryFootprint() const;
+
+private:
+  std::vector<std::unique_ptr<EventResponse>> fFreeEventResponses;
+  std::vector<event_unit_response_t> fFreeEventUnits;
+  std::vector<std::vector<double>> fFreeResponses;
+  Counters fCounters{0, 0, 0, 0, 0};
+};
+
+} // namespace systtools
@@ -1,34 +1,120 @@
 #include "systematicstools/interface/EventResponse_product.hh"
 
+#include "systematicstools/interface/SystMetaData.hh"
+#include "systematicstools/interface/types.hh"
+
 #include <cmath>
+#include <unordered_map>
 
 namespace systtools {
 
-bool FullOfUnity(std::vector<double> const &vec,
-                 double tolerance = std::numeric_limits<double>::epsilon()) {
+namespace {
+
+// Header is a callable returning the header of a parameter Id, or nullptr if
+// it has none.
+template <typename Header>
+void ScrubUnity(event_unit_response_t &eur, Header const &header,
+                double tolerance) {
+  eur.erase(std::remove_if(eur.begin(), eur.end(),
+                           [&](ParamResponses const &pr) {
+                             SystParamHeader const *hdr = header(pr.pid);
+                             return hdr && IsUnityWeightResponse(
+                                               *hdr, pr.responses, tolerance);
+                           }),
+            eur.end());
+}
+
+template <typename Header>
+void ScrubUnity(std::unique_ptr<EventResponse> &er, Header const &header,
+                double tolerance) {
+  SYSTTOOLS_PROFILE_SCOPE(prof, "scrub", "ScrubUnityEventResponses");
+  for (event_unit_response_t &eur : (*er)) {
+    ScrubUnity(eur, header, tolerance);
+  }
+  prof.SetOutputSize(*er);
+}
+
+auto MapHeaders(param_header_map_t const &headers) {
+  return [&](paramId_t pid) -> SystParamHeader const * {
+    auto it = headers.find(pid);
+    return (it == headers.end()) ? nullptr : &it->second.Header;
+  };
+}
+
+} // namespace
+
+bool FullOfUnity(std::vector<double> const &vec, double tolerance) {
   for (auto &u : vec) {
-    if (fabs(u - 1.0) > tolerance) {
+    if (std::fabs(u - 1.0) > tolerance) {
       return false;
     }
   }
   return true;
 }
 
-void ScrubUnityEventResponses(std::unique_ptr<EventResponse> &er) {
-  for (event_unit_response_t &eur : (*er)) {
-    ScrubUnityEventResponses(eur);
+void ScrubUnityEventResponses(std::unique_ptr<EventResponse> &er,
+                              param_header_map_t const &headers,
+                              double tolerance) {
+  ScrubUnity(er, MapHeaders(headers), tolerance);
+}
+
+void ScrubUnityEventResponses(std::unique_ptr<EventResponse> &er,
+                              SystMetaData const &md, double tolerance) {
+  // Index the headers once, rather than searching md for every response.
+  std::unordered_map<paramId_t, SystParamHeader const *> index;
+  for (auto const &hdr : md) {
+    index.emplace(hdr.systParamId, &hdr);
+  }
+  ScrubUnity(
+      er,
+      [&](paramId_t pid) -> SystParamHeader const * {
+        auto it = index.find(pid);
+        return (it == index.end()) ? nullptr : it->second;
+      },
+      tolerance);
+}
+
+void ScrubUnityEventResponses(event_unit_response_t &eur,
+                              param_header_map_t const &headers,
+                              double tolerance) {
+  ScrubUnity(eur, MapHeaders(headers), tolerance);
+}
+
+void ScrubUnityEventResponses(event_unit_response_t &eur,
+                              SystMetaData const &md, double tolerance) {
+  ScrubUnity(
+      eur,
+      [&](paramId_t pid) -> SystParamHeader const * {
+        size_t idx = GetParamIndex(md, pid);
+        return IndexIsHandled(md, idx) ? &md[idx] : nullptr;
+      },
+      tolerance);
+}
+
+MemoryBreakdown MemoryFootprint(event_unit_response_t const &eur) {
+  MemoryBreakdown mb;
+  size_t ResponseBytes = 0;
+  for (auto const &pr : eur) {
+    ResponseBytes += footprint::HeapBytes(pr.responses);
   }
+  mb.Add("event units", footprint::HeapBytes(eur));
+  mb.Add("responses", ResponseBytes);
+  return mb;
 }
 
-void ScrubUnityEventResponses(event_unit_response_t &eur) {
-  for (event_unit_response_t::iterator resp_it = eur.begin();
-       resp_it != eur.end();) {
-    if (FullOfUnity(resp_it->responses)) {
-      resp_it = eur.erase(resp_it);
-    } else {
-      ++resp_it;
+MemoryBreakdown MemoryFootprint(EventResponse const &er) {
+  size_t UnitBytes = footprint::HeapBytes(er);
+  size_t ResponseBytes = 0;
+  for (auto const &eur : er) {
+    UnitBytes += footprint::HeapBytes(eur);
+    for (auto const &pr : eur) {
+      ResponseBytes += footprint::HeapBytes(pr.responses);
     }
   }
+  MemoryBreakdown mb;
+  mb.Add("event units", UnitBytes);
+  mb.Add("responses", ResponseBytes);
+  return mb;
 }
 
 } // namespace systtools
@@ -1,10 +1,16 @@
 #pragma once
 
+#include "systematicstools/interface/Profiler.hh"
 #include "systematicstools/interface/SystParamHeader.hh"
 #include "systematicstools/interface/types.hh"
 
 #include "systematicstools/utility/exceptions.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -21,6 +27,9 @@ struct ParamResponses {
   paramId_t pid;
   std::vector<double> responses;
 };
+///\brief The parameter responses of a single event unit.
+///
+///\note Those built by ExtendEventUnitResponse are sorted by parameter Id.
 typedef std::vector<ParamResponses> event_unit_response_t;
 
 ///\brief The systematic parameter responses calculated for an event.
@@ -45,18 +54,71 @@ typedef std::vector<event_unit_response_w_cv_t> EventAndCVResponse;
 /// differing number of event units.
 NEW_SYSTTOOLS_EXCEPT(incompatible_number_of_event_units);
 
+///\brief Sorts the parameter responses of an EventUnitResponse by parameter
+/// Id, if they are not already.
+template <class EUR> void SortEventUnitResponse(EUR &eur) {
+  auto PidLess = [](typename EUR::value_type const &l,
+                    typename EUR::value_type const &r) {
+    return l.pid < r.pid;
+  };
+  if (!std::is_sorted(eur.begin(), eur.end(), PidLess)) {
+    std::sort(eur.begin(), eur.end(), PidLess);
+  }
+}
+
 ///\brief Extends one EventUnitResponse with the parameter responses of another.
 ///
-/// The parameter responses from e2 are moved into e1.
+/// The parameter responses from e2 are moved into e1. Responses are kept
+/// sorted by parameter Id: either input is sorted first if it is not already,
+/// and the two are then merged in a single pass, which also detects
+/// parameters present in both. As providers handle contiguous ranges of
+/// parameter Ids, the merge is usually an append.
+///
+///\note throws systParamId_collision if a parameter has responses in both,
+/// or more than once in e2, in which case e1 is left in a valid but
+/// unspecified state.
 template <class EUR> void ExtendEventUnitResponse(EUR &e1, EUR &&e2) {
+  if (e2.empty()) {
+    return;
+  }
+  SortEventUnitResponse(e2);
+  auto dup = std::adjacent_find(e2.begin(), e2.end(),
+                                [](typename EUR::value_type const &l,
+                                   typename EUR::value_type const &r) {
+                                  return l.pid == r.pid;
+                                });
+  if (dup != e2.end()) {
+    throw systParamId_collision()
+        << "[ERROR]: Failed to insert response of parameter ID = "
+        << dup->pid << ", it already exists.";
+  }
+  if (e1.empty()) {
+    e1 = std::move(e2);
+    return;
+  }
+  SortEventUnitResponse(e1);
 
-  for (typename EUR::value_type &resps : e2) {
-    if (ContainterHasParam(e1, resps.pid)) {
-      throw systParamId_collision()
-          << "[ERROR]: Failed to insert response of parameter ID = "
-          << resps.pid << ", it already exists.";
+  size_t n1 = e1.size();
+  if (e1.back().pid < e2.front().pid) {
+    e1.reserve(n1 + e2.size());
+    std::move(e2.begin(), e2.end(), std::back_inserter(e1));
+    return;
+  }
+
+  // Merge from the back, so that e1 can be extended in place.
+  e1.resize(n1 + e2.size());
+  size_t i1 = n1, i2 = e2.size(), out = e1.size();
+  while (i2) {
+    if (i1 && (e1[i1 - 1].pid >= e2[i2 - 1].pid)) {
+      if (e1[i1 - 1].pid == e2[i2 - 1].pid) {
+        throw systParamId_collision()
+            << "[ERROR]: Failed to insert response of parameter ID = "
+            << e2[i2 - 1].pid << ", it already exists.";
+      }
+      e1[--out] = std::move(e1[--i1]);
+    } else {
+      e1[--out] = std::move(e2[--i2]);
     }
-    e1.push_back(std::move(resps));
   }
 }
 
@@ -72,6 +134,8 @@ void ExtendEventResponse(std::unique_ptr<ER> &e1, std::unique_ptr<ER> &&e2) {
   if (!e1 || !e2) {
     return;
   }
+  SYSTTOOLS_PROFILE_SCOPE(prof, "merge", "ExtendEventResponse");
+  prof.SetOutputSize(*e2);
 
   if (e1->size() != e2->size()) {
     throw incompatible_number_of_event_units()
@@ -86,18 +150,278 @@ void ExtendEventResponse(std::unique_ptr<ER> &e1, std::unique_ptr<ER> &&e2) {
   }
 }
 
+///\brief Extends one EventResponse with the event_unit_response_ts of a number
+/// of others, e.g. the responses of each provider for the same event.
+///
+/// Each event unit of e1 is reserved for the responses of all providers
+/// before any are merged in. Null inputs are skipped.
+///
+///\note throws incompatible_number_of_event_units if any non-null input has a
+/// different number of event units to e1.
+template <class ER>
+void ExtendEventResponse(std::unique_ptr<ER> &e1,
+                         std::vector<std::unique_ptr<ER>> &&others) {
+  if (!e1) {
+    return;
+  }
+  SYSTTOOLS_PROFILE_SCOPE(prof, "merge", "ExtendEventResponse");
+
+  size_t NResponses = e1->size();
+  for (auto const &e2 : others) {
+    if (e2 && (e2->size() != NResponses)) {
+      throw incompatible_number_of_event_units()
+          << "[ERROR]: The number of responses from two systematic "
+             "providers differs, Provider 1 has "
+          << NResponses << ", and another has " << e2->size();
+    }
+  }
+  for (size_t eur_it = 0; eur_it < NResponses; ++eur_it) {
+    size_t NParams = (*e1)[eur_it].size();
+    for (auto const &e2 : others) {
+      NParams += e2 ? (*e2)[eur_it].size() : 0;
+    }
+    (*e1)[eur_it].reserve(NParams);
+    for (auto &e2 : others) {
+      if (e2) {
+        ExtendEventUnitResponse((*e1)[eur_it], std::move((*e2)[eur_it]));
+      }
+    }
+  }
+  prof.SetOutputSize(*e1);
+}
+
+///\brief The default distance from 1 within which a response is considered
+/// to be unity.
+constexpr double kUnityResponseTolerance =
+    std::numeric_limits<double>::epsilon();
+
+///\brief Whether every response is within tolerance of 1.
+bool FullOfUnity(std::vector<double> const &vec,
+                 double tolerance = kUnityResponseTolerance);
+
+///\brief Whether the responses of the parameter described by hdr can be
+/// dropped as an absence of response: it is a weight parameter and they are
+/// all within tolerance of 1.
+///
+/// A lateral response of 1 is a shifted value, so is never dropped.
+inline bool IsUnityWeightResponse(SystParamHeader const &hdr,
+                                  std::vector<double> const &responses,
+                                  double tolerance = kUnityResponseTolerance) {
+  return hdr.isWeightSystematicVariation && FullOfUnity(responses, tolerance);
+}
+
+// Defined in types.hh, which includes this header. The scrubbing functions
+// take headers as a param_header_map_t or a SystMetaData, spelled out below.
+struct ParamHeaderProviderName;
+
 /// \brief Removes systtools::ParamResponses from event_unit_response_ts
-/// contained within an EventResponse that contain only unity responses.
+/// contained within an EventResponse that contain only unity weight
+/// responses, see IsUnityWeightResponse.
+///
+/// Responses of parameters without a header are kept.
 ///
 /// \note that this is intended to be applied to weight systematics that do not
 /// affect a given event
-void ScrubUnityEventResponses(std::unique_ptr<EventResponse> &er);
+void ScrubUnityEventResponses(
+    std::unique_ptr<EventResponse> &er,
+    std::map<paramId_t, ParamHeaderProviderName> const &headers,
+    double tolerance = kUnityResponseTolerance);
+void ScrubUnityEventResponses(std::unique_ptr<EventResponse> &er,
+                              std::vector<SystParamHeader> const &md,
+                              double tolerance = kUnityResponseTolerance);
 
 /// \brief Removes systtools::ParamResponses from event_unit_response_t that
-/// contain only unity responses.
+/// contain only unity weight responses, see IsUnityWeightResponse.
+///
+/// Compacts the remaining responses in a single pass, preserving their order.
+/// Responses of parameters without a header are kept.
 ///
 /// \note that this is intended to be applied to weight systematics that do not
 /// affect a given event
-void ScrubUnityEventResponses(event_unit_response_t &er);
+void ScrubUnityEventResponses(
+    event_unit_response_t &eur,
+    std::map<paramId_t, ParamHeaderProviderName> const &headers,
+    double tolerance = kUnityResponseTolerance);
+void ScrubUnityEventResponses(event_unit_response_t &eur,
+                              std::vector<SystParamHeader> const &md,
+                              double tolerance = kUnityResponseTolerance);
+
+///\brief Builds an event_unit_response_t that never holds unity weight
+/// responses.
+///
+/// Providers add the responses of each parameter, with its header, as they
+/// are calculated, and those of weight parameters that are all within
+/// tolerance of 1 are dropped rather than stored, so that neither
+/// ScrubUnityEventResponses nor the writers downstream have to handle them.
+/// Responses calculated with the callable form of Add are written to a
+/// reused scratch buffer, so dropped parameters cost no allocation.
+///
+///\note Only weight responses are dropped: a lateral response of 1 is a
+/// shifted value, not an absence of response, so is always added.
+///
+/// A builder can be reused for successive event units with Release, which
+/// leaves it empty.
+class SparseEventUnitResponseBuilder {
+public:
+  explicit SparseEventUnitResponseBuilder(
+      double tolerance = kUnityResponseTolerance)
+      : fTolerance(tolerance) {}
+
+  ///\brief Adds the responses of the parameter described by hdr, unless it is
+  /// a weight parameter and they are all unity.
+  ///
+  /// Returns whether they were added.
+  bool Add(SystParamHeader const &hdr, std::vector<double> &&responses) {
+    if (IsUnityWeightResponse(hdr, responses, fTolerance)) {
+      ++fNSkipped;
+      return false;
+    }
+    fEUR.push_back({hdr.systParamId, std::move(responses)});
+    return true;
+  }
+
+  ///\brief Adds the N responses, response(0) ... response(N-1), of the
+  /// parameter described by hdr, unless it is a weight parameter and they are
+  /// all unity.
+  ///
+  /// Returns whether they were added.
+  template <typename F>
+  bool Add(SystParamHeader const &hdr, size_t N, F &&response) {
+    fScratch.resize(N);
+    for (size_t r_it = 0; r_it < N; ++r_it) {
+      fScratch[r_it] = response(r_it);
+    }
+    if (IsUnityWeightResponse(hdr, fScratch, fTolerance)) {
+      ++fNSkipped;
+      return false;
+    }
+    fEUR.push_back({hdr.systParamId, fScratch});
+    return true;
+  }
+
+  event_unit_response_t const &Get() const { return fEUR; }
+  ///\brief Moves out the built response, leaving the builder empty.
+  event_unit_response_t Release() {
+    event_unit_response_t eur = std::move(fEUR);
+    fEUR.clear();
+    return eur;
+  }
+
+  double GetTolerance() const { return fTolerance; }
+  ///\brief The number of weight parameters dropped as unity since
+  /// construction.
+  size_t GetNSkipped() const { return fNSkipped; }
+
+private:
+  double fTolerance;
+  event_unit_response_t fEUR;
+  std::vector<double> fScratch;
+  size_t fNSkipped = 0;
+};
+
+///\brief A copy-on-write view of a shared, immutable event unit response
+/// prototype, such as the default responses of a provider.
+///
+/// Reading a parameter's responses reads the prototype until
+/// GetMutableResponses is first called for it, which copies just that
+/// parameter's responses. Providers that start from default responses and
+/// overwrite only the affected parameters therefore only allocate for those.
+///
+///\note The prototype must be sorted by parameter Id.
+class EventUnitResponseView {
+public:
+  EventUnitResponseView() {}
+  explicit EventUnitResponseView(
+      std::shared_ptr<event_unit_response_t const> prototype)
+      : fPrototype(std::move(prototype)) {}
+
+  ///\brief The number of parameters in the prototype.
+  size_t size() const { return fPrototype ? fPrototype->size() : 0; }
+  bool HasParam(paramId_t pid) const {
+    return FindSorted(Prototype(), pid) != Prototype().end();
+  }
+  ///\brief Whether GetMutableResponses has been called for pid.
+  bool IsModified(paramId_t pid) const {
+    return FindSorted(fModified, pid) != fModified.end();
+  }
+
+  ///\note throws invalid_parameter_Id if pid is not in the prototype.
+  std::vector<double> const &GetResponses(paramId_t pid) const {
+    auto mod_it = FindSorted(fModified, pid);
+    if (mod_it != fModified.end()) {
+      return mod_it->responses;
+    }
+    return FindPrototype(pid).responses;
+  }
+  ///\brief Gets the responses of parameter pid for modification, copying
+  /// them from the prototype on first use.
+  ///
+  /// The reference is valid until the next call to GetMutableResponses.
+  ///
+  ///\note throws invalid_parameter_Id if pid is not in the prototype.
+  std::vector<double> &GetMutableResponses(paramId_t pid) {
+    auto mod_it = std::lower_bound(fModified.begin(), fModified.end(), pid,
+                                   PidLess);
+    if ((mod_it != fModified.end()) && (mod_it->pid == pid)) {
+      return mod_it->responses;
+    }
+    return fModified.insert(mod_it, FindPrototype(pid))->responses;
+  }
+
+  ///\brief The modified parameter responses only, sorted by parameter Id.
+  event_unit_response_t const &GetModified() const { return fModified; }
+  ///\brief Moves out the modified parameter responses only, e.g. when
+  /// unmodified parameters are unity and need not be stored.
+  event_unit_response_t ReleaseModified() {
+    event_unit_response_t eur = std::move(fModified);
+    fModified.clear();
+    return eur;
+  }
+  ///\brief Builds the full response, the prototype with any modifications.
+  event_unit_response_t Materialize() const {
+    event_unit_response_t eur = Prototype();
+    auto eur_it = eur.begin();
+    for (ParamResponses const &pr : fModified) {
+      eur_it = std::lower_bound(eur_it, eur.end(), pr.pid, PidLess);
+      eur_it->responses = pr.responses;
+    }
+    return eur;
+  }
+
+private:
+  static bool PidLess(ParamResponses const &pr, paramId_t pid) {
+    return pr.pid < pid;
+  }
+  static event_unit_response_t::const_iterator
+  FindSorted(event_unit_response_t const &eur, paramId_t pid) {
+    auto it = std::lower_bound(eur.begin(), eur.end(), pid, PidLess);
+    return ((it != eur.end()) && (it->pid == pid)) ? it : eur.end();
+  }
+  event_unit_response_t const &Prototype() const {
+    static event_unit_response_t const empty;
+    return fPrototype ? *fPrototype : empty;
+  }
+  ParamResponses const &FindPrototype(paramId_t pid) const {
+    auto it = FindSorted(Prototype(), pid);
+    if (it == Prototype().end()) {
+      throw invalid_parameter_Id()
+          << "[ERROR]: Parameter ID = " << pid
+          << " is not in the event unit response prototype.";
+    }
+    return *it;
+  }
+
+  std::shared_ptr<event_unit_response_t const> fPrototype;
+  event_unit_response_t fModified;
+};
+
+///\brief The memory owned by an event unit response, reported as "event units"
+/// for the list of parameter responses and "responses" for the responses
+/// themselves.
+MemoryBreakdown MemoryFootprint(event_unit_response_t const &eur);
+
+///\brief The memory owned by an EventResponse, see
+/// MemoryFootprint(event_unit_response_t const &).
+MemoryBreakdown MemoryFootprint(EventResponse const &er);
 
 } // namespace systtools
@@ -0,0 +1,35 @@
+#include "systematicstools/interface/EventUnitRecord.hh"
+
+#include <iomanip>
+
+namespace systtools {
+
+constexpr size_t EventUnitSchema::kNotFound;
+
+EventUnitSchema::EventUnitSchema(std::vector<std::string> names)
+    : fNames(std::move(names)) {
+  for (size_t v_it = 0; v_it < fNames.size(); ++v_it) {
+    if (!fIndices.emplace(fNames[v_it], v_it).second) {
+      throw unknown_event_unit_variable()
+          << "[ERROR]: Event unit variable " << std::quoted(fNames[v_it])
+          << " was declared more than once.";
+    }
+  }
+}
+
+size_t EventUnitSchema::Find(std::string const &name) const {
+  auto it = fIndices.find(name);
+  return (it == fIndices.end()) ? kNotFound : it->second;
+}
+
+size_t EventUnitSchema::GetIndex(std::string const &name) const {
+  size_t idx = Find(name);
+  if (idx == kNotFound) {
+    throw unknown_event_unit_variable()
+        << "[ERROR]: Event unit variable " << std::quoted(name)
+        << " is not available from this input.";
+  }
+  return idx;
+}
+
+} // namespace systtools
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "systematicstools/interface/EventResponseIndex.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when a variable is requested that an
+/// EventUnitSchema does not contain.
+NEW_SYSTTOOLS_EXCEPT(unknown_event_unit_variable);
+
+///\brief The names of the variables describing each event unit read by a
+/// standalone driver, e.g. systtools_run.
+///
+/// Providers look up the indices of the variables that they need once, in
+/// ISystProviderTool::SetEventUnitSchema, and then index each EventUnitRecord
+/// directly.
+class EventUnitSchema {
+public:
+  static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+
+  EventUnitSchema() {}
+  EventUnitSchema(std::vector<std::string> names);
+
+  size_t size() const { return fNames.size(); }
+  std::vector<std::string> const &GetNames() const { return fNames; }
+  std::string const &GetName(size_t i) const { return fNames.at(i); }
+
+  ///\brief Gets the index of a variable, or kNotFound.
+  size_t Find(std::string const &name) const;
+  ///\brief As Find, but throws unknown_event_unit_variable.
+  size_t GetIndex(std::string const &name) const;
+
+private:
+  std::vector<std::string> fNames;
+  std::map<std::string, size_t> fIndices;
+};
+
+///\brief A single event unit, as a flat record of variable values ordered as
+/// the variables of an EventUnitSchema.
+struct EventUnitRecord {
+  EventKey key;
+  std::vector<double> values;
+
+  double operator[](size_t i) const { return values[i]; }
+};
+
+} // namespace systtools
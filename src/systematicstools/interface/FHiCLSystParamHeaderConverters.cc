@@ -53,11 +53,19 @@ SystParamHeader FHiCLToSystParamHeader(fhicl::ParameterSet const &paramset) {
   paramset.get_if_present("paramValidityRange", sph.paramValidityRange);
   paramset.get_if_present("isSplineable", sph.isSplineable);
   paramset.get_if_present("isRandomlyThrown", sph.isRandomlyThrown);
-  paramset.get_if_present("paramVariations", sph.paramVariations);
+  std::vector<double> paramVariations;
+  if (paramset.get_if_present("paramVariations", paramVariations)) {
+    // Many parameters are often thrown from the same distribution.
+    sph.paramVariations = std::move(paramVariations);
+    sph.paramVariations.Intern();
+  }
   paramset.get_if_present("isResponselessParam", sph.isResponselessParam);
   paramset.get_if_present("responseParamId", sph.responseParamId);
   paramset.get_if_present("responses", sph.responses);
-  paramset.get_if_present("opts", sph.opts);
+  std::vector<std::string> opts;
+  if (paramset.get_if_present("opts", opts)) {
+    sph.opts = std::move(opts);
+  }
 
   return sph;
 }
@@ -106,7 +114,7 @@ fhicl::ParameterSet SystParamHeaderToFHiCL(SystParamHeader const &sph) {
     ps.put("isRandomlyThrown", sph.isRandomlyThrown);
   }
   if (sph.paramVariations.size()) {
-    ps.put("paramVariations", sph.paramVariations);
+    ps.put("paramVariations", sph.paramVariations.get());
   }
   if (sph.isResponselessParam) {
     ps.put("isResponselessParam", sph.isResponselessParam);
@@ -118,7 +126,7 @@ fhicl::ParameterSet SystParamHeaderToFHiCL(SystParamHeader const &sph) {
     ps.put("responses", sph.responses);
   }
   if (sph.opts.size()) {
-    ps.put("opts", sph.opts);
+    ps.put("opts", sph.opts.get());
   }
 
   return ps;
@@ -1,5 +1,9 @@
 #include "systematicstools/interface/ISystProviderTool.hh"
 
+#include "systematicstools/interface/Profiler.hh"
+
+#include <algorithm>
+
 namespace systtools {
 
 ISystProviderTool::ISystProviderTool(fhicl::ParameterSet const &ps)
@@ -37,6 +41,7 @@ void ISystProviderTool::SuggestParameterThrows(parameter_throws_list_t &&,
 
 void ISystProviderTool::ConfigureFromToolConfig(fhicl::ParameterSet const &ps,
                                                 paramId_t firstId) {
+  ProfileScope prof("configure", GetFullyQualifiedName());
   fSystMetaData = this->BuildSystMetaData(ps, firstId);
 
   // The following check expects them to be ordered, but the provider isn't
@@ -56,6 +61,10 @@ void ISystProviderTool::ConfigureFromToolConfig(fhicl::ParameterSet const &ps,
     firstId++;
   }
   fHaveSystMetaData = true;
+  BuildDefaultEventResponse();
+  if (prof.IsActive()) {
+    Profiler::Get().SetParameterNames(GetFullyQualifiedName(), fSystMetaData);
+  }
 }
 
 SystMetaData const &ISystProviderTool::GetSystMetaData() const{
@@ -88,6 +97,7 @@ fhicl::ParameterSet ISystProviderTool::GetParameterHeadersDocument() {
 
 bool ISystProviderTool::ConfigureFromParameterHeaders(
     fhicl::ParameterSet const &ps) {
+  ProfileScope prof("configure", GetFullyQualifiedName());
   std::vector<std::string> const &ParamHeaderNames =
       ps.get<std::vector<std::string>>("parameter_headers");
 
@@ -96,11 +106,15 @@ bool ISystProviderTool::ConfigureFromParameterHeaders(
         FHiCLToSystParamHeader(ps.get<fhicl::ParameterSet>(paramName)));
   }
   fHaveSystMetaData = true;
+  BuildDefaultEventResponse();
 
   fhicl::ParameterSet ToolOptions;
   ps.get_if_present("tool_options", ToolOptions);
 
   fIsFullyConfigured = this->SetupResponseCalculator(ToolOptions);
+  if (prof.IsActive()) {
+    Profiler::Get().SetParameterNames(GetFullyQualifiedName(), fSystMetaData);
+  }
 
   std::cout << "[INFO]: Syst provider " << std::quoted(GetFullyQualifiedName())
             << " configured " << fSystMetaData.size() << " parameters."
@@ -109,16 +123,63 @@ bool ISystProviderTool::ConfigureFromParameterHeaders(
   return fIsFullyConfigured;
 }
 
+void ISystProviderTool::BuildDefaultEventResponse() {
+  auto resp = std::make_shared<event_unit_response_t>();
+  resp->reserve(fSystMetaData.size());
+  for (auto const &sph : fSystMetaData) {
+    resp->push_back(responses_for(sph));
+  }
+  fDefaultEventResponse = resp;
+
+  // GetDefaultEventResponse keeps the header order, while views need the
+  // defaults sorted, so they only get their own copy if the headers are not.
+  if (!std::is_sorted(resp->begin(), resp->end(),
+                      [](ParamResponses const &l, ParamResponses const &r) {
+                        return l.pid < r.pid;
+                      })) {
+    resp = std::make_shared<event_unit_response_t>(*resp);
+    SortEventUnitResponse(*resp);
+  }
+  fSortedDefaultEventResponse = std::move(resp);
+}
+
 systtools::event_unit_response_t
 ISystProviderTool::GetDefaultEventResponse() const
 {
-  auto const& smd = this->GetSystMetaData();
-  systtools::event_unit_response_t resp;
-  resp.reserve(smd.size());
-  for(auto const& sph : smd) {
-    resp.push_back(responses_for(sph));
+  CheckHaveMetaData();
+  return *fDefaultEventResponse;
+}
+
+void ISystProviderTool::GetDefaultEventResponse(
+    event_unit_response_t &eur) const {
+  CheckHaveMetaData();
+  event_unit_response_t const &defaults = *fDefaultEventResponse;
+  eur.resize(defaults.size());
+  for (size_t pr_it = 0; pr_it < defaults.size(); ++pr_it) {
+    eur[pr_it].pid = defaults[pr_it].pid;
+    eur[pr_it].responses.assign(defaults[pr_it].responses.begin(),
+                                defaults[pr_it].responses.end());
   }
-  return resp;
+}
+
+EventUnitResponseView ISystProviderTool::GetDefaultEventResponseView() const {
+  CheckHaveMetaData();
+  return EventUnitResponseView(fSortedDefaultEventResponse);
+}
+
+void ISystProviderTool::SetEventUnitSchema(EventUnitSchema const &) {
+  throw ISystProviderTool_method_unimplemented()
+      << "[ERROR]: Attempted to set up provider tool "
+      << std::quoted(GetToolType())
+      << " for standalone response calculation, but it doesn't support it.";
+}
+
+event_unit_response_t
+ISystProviderTool::GetEventUnitResponse(EventUnitRecord const &) {
+  throw ISystProviderTool_method_unimplemented()
+      << "[ERROR]: Attempted to calculate a standalone event unit response "
+         "with provider tool "
+      << std::quoted(GetToolType()) << ", but it doesn't support it.";
 }
 
 void ISystProviderTool::CheckHaveMetaData(paramId_t i) const{
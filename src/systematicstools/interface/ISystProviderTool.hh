@@ -1,6 +1,7 @@
 #pragma once
 
 #include "systematicstools/interface/EventResponse_product.hh"
+#include "systematicstools/interface/EventUnitRecord.hh"
 #include "systematicstools/interface/FHiCLSystParamHeaderConverters.hh"
 #include "systematicstools/interface/SystMetaData.hh"
 
@@ -10,7 +11,9 @@
 
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <memory>
 #include <string>
 
 namespace systtools {
@@ -72,6 +75,21 @@ public:
     return ex_cfg;
   }
 
+  static constexpr size_t kUnknownNParameters =
+      std::numeric_limits<size_t>::max();
+
+  ///\brief Sub-classes may override this method to report the number of
+  /// parameters that BuildSystMetaData will build from a tool configuration,
+  /// without building them.
+  ///
+  /// Providers that report a count are configured concurrently with others by
+  /// ConfigureISystProvidersFromToolConfigConcurrently, so their
+  /// BuildSystMetaData must not modify state shared with other providers. The
+  /// count must be exact, it is checked after configuration.
+  virtual size_t GetNParametersFromToolConfig(fhicl::ParameterSet const &) {
+    return kUnknownNParameters;
+  }
+
   ///\brief Configure an ISystProvider instance with tool-specific FHiCL
   ///
   /// Takes the tool-specific FHiCL configuration and the paramId_t of the first
@@ -108,7 +126,49 @@ public:
   bool ConfigureFromParameterHeaders(fhicl::ParameterSet const &ps);
 
   //==== return 1-filled event_unit_response_t
+  ///\brief Copies the default responses of every handled parameter, unity
+  /// for each variation, in the order of GetSystMetaData.
+  ///
+  /// The defaults are built once, on configuration.
+  ///
+  ///\note Every response is materialized, prefer building sparse responses
+  /// with SparseEventUnitResponseBuilder, or starting from
+  /// GetDefaultEventResponseView.
   systtools::event_unit_response_t GetDefaultEventResponse() const;
+  ///\brief Resets eur to the default responses, reusing its storage.
+  ///
+  /// Once eur has held the defaults, resetting it again does not allocate, so
+  /// a provider can recycle a single response between event units.
+  void GetDefaultEventResponse(systtools::event_unit_response_t &eur) const;
+  ///\brief A copy-on-write view of the default responses, see
+  /// EventUnitResponseView.
+  ///
+  /// The view holds the defaults sorted by parameter Id.
+  EventUnitResponseView GetDefaultEventResponseView() const;
+
+  ///\brief Prepares a configured instance to calculate responses with
+  /// GetEventUnitResponse for event units described by schema.
+  ///
+  /// Sub-classes that support standalone response calculation should look up
+  /// the indices of any variables that they require here, see
+  /// EventUnitSchema::GetIndex.
+  ///
+  ///\note The default implementation throws
+  /// ISystProviderTool_method_unimplemented.
+  virtual void SetEventUnitSchema(EventUnitSchema const &schema);
+
+  ///\brief Calculates the responses of a single event unit read by a
+  /// standalone driver, e.g. systtools_run.
+  ///
+  /// Responses should depend only on the record, and not on the order in
+  /// which records are passed, so that the output of a driver does not
+  /// depend on how the input is batched or distributed over threads. Drivers
+  /// use a separate instance per thread.
+  ///
+  ///\note The default implementation throws
+  /// ISystProviderTool_method_unimplemented.
+  virtual event_unit_response_t
+  GetEventUnitResponse(EventUnitRecord const &eu);
 
   std::string const &GetToolType() const { return fToolType; }
   std::string const &GetFullyQualifiedName() const { return fFQName; }
@@ -174,6 +234,10 @@ protected:
   bool fIsFullyConfigured;
 
 private:
+  ///\brief Builds fDefaultEventResponse and fSortedDefaultEventResponse
+  /// from fSystMetaData.
+  void BuildDefaultEventResponse();
+
   /// Whether this instance has generated/loaded its parameter set.
   bool fHaveSystMetaData;
   /// \brief The SystMetaData describing the parameters handled by this tool.
@@ -182,6 +246,11 @@ private:
   /// original generation. Subclasses and external callers may use
   /// GetSystMetaData to inspect it.
   SystMetaData fSystMetaData;
+  /// The default responses, in the order of fSystMetaData.
+  std::shared_ptr<event_unit_response_t const> fDefaultEventResponse;
+  /// The default responses sorted by parameter Id, shared by all views handed
+  /// out. The same storage as fDefaultEventResponse if that is sorted.
+  std::shared_ptr<event_unit_response_t const> fSortedDefaultEventResponse;
 };
 
 ParamResponses responses_for(SystParamHeader const& sph);
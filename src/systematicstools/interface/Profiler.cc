@@ -0,0 +1,211 @@
+#include "systematicstools/interface/Profiler.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace systtools {
+
+namespace {
+
+std::string JSONEscape(std::string const &s) {
+  std::string out;
+  for (char c : s) {
+    if ((c == '"') || (c == '\\')) {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+
+///\brief A small, stable id for the calling thread, for use in traces.
+uint32_t GetTraceThreadId() {
+  static std::atomic<uint32_t> NThreads(0);
+  thread_local uint32_t tid = NThreads.fetch_add(1);
+  return tid;
+}
+
+} // namespace
+
+Profiler &Profiler::Get() {
+  static Profiler p;
+  return p;
+}
+
+Profiler::Profiler()
+    : fEnabled(false), fStartTicks(ReadProfileTicks()),
+      fStartTime(std::chrono::steady_clock::now()), fMaxTraceEvents(1000000),
+      fNDroppedTraceEvents(0) {
+  if (char const *prefix = std::getenv("SYSTTOOLS_PROFILE")) {
+    Enable(prefix);
+  }
+}
+
+Profiler::~Profiler() {
+  if (fOutputPrefix.size()) {
+    Write(fOutputPrefix);
+  }
+}
+
+void Profiler::Enable(std::string const &output_prefix) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (output_prefix.size()) {
+    fOutputPrefix = output_prefix;
+  }
+  fEnabled.store(true, std::memory_order_relaxed);
+}
+
+ProfileCounter &Profiler::GetCounter(std::string const &category,
+                                     std::string const &name) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  std::unique_ptr<ProfileCounter> &c = fCounters[{category, name}];
+  if (!c) {
+    c = std::make_unique<ProfileCounter>(category, name);
+  }
+  return *c;
+}
+
+void Profiler::AddTraceEvent(ProfileCounter const &counter, uint64_t start,
+                             uint64_t end) {
+  uint32_t tid = GetTraceThreadId();
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (fTraceEvents.size() < fMaxTraceEvents) {
+    fTraceEvents.push_back({&counter, start, end, tid});
+  } else {
+    fNDroppedTraceEvents++;
+  }
+}
+
+void Profiler::SetMaxTraceEvents(size_t n) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  fMaxTraceEvents = n;
+}
+
+size_t Profiler::GetMaxTraceEvents() const {
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fMaxTraceEvents;
+}
+
+void Profiler::SetParameterNames(std::string const &ProviderFQName,
+                                 std::vector<SystParamHeader> const &md) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (auto const &hdr : md) {
+    ParameterStats &ps = fParameters[hdr.systParamId];
+    ps.ProviderFQName = ProviderFQName;
+    ps.Name = hdr.prettyName;
+  }
+}
+
+double Profiler::GetTicksPerSecond() const {
+#ifdef SYSTTOOLS_PROFILE_HAVE_TSC
+  // Calibrate over at least 10 ms.
+  std::chrono::duration<double> elapsed;
+  uint64_t ticks;
+  do {
+    ticks = ReadProfileTicks();
+    elapsed = std::chrono::steady_clock::now() - fStartTime;
+  } while (elapsed.count() < 1E-2);
+  return double(ticks - fStartTicks) / elapsed.count();
+#else
+  return 1E9;
+#endif
+}
+
+void Profiler::WriteJSON(std::ostream &os) const {
+  double tps = GetTicksPerSecond();
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  os << "{\n  \"ticks_per_second\": " << std::setprecision(10) << tps
+     << std::setprecision(6) << ",\n  \"counters\": [";
+  bool first = true;
+  for (auto const &c_it : fCounters) {
+    ProfileCounter const &c = *c_it.second;
+    if (!c.GetNCalls()) {
+      continue;
+    }
+    double seconds = double(c.GetTicks()) / tps;
+    os << (first ? "\n" : ",\n") << "    {\"category\": \""
+       << JSONEscape(c.GetCategory()) << "\", \"name\": \""
+       << JSONEscape(c.GetName()) << "\", \"calls\": " << c.GetNCalls()
+       << ", \"seconds\": " << seconds
+       << ", \"mean_us\": " << (seconds * 1E6 / double(c.GetNCalls()))
+       << ", \"event_units\": " << c.GetNEventUnits()
+       << ", \"param_responses\": " << c.GetNParamResponses()
+       << ", \"responses\": " << c.GetNResponses() << "}";
+    first = false;
+  }
+  os << "\n  ],\n  \"parameters\": [";
+  first = true;
+  for (auto const &p_it : fParameters) {
+    ParameterStats const &ps = p_it.second;
+    if (!ps.NEventUnits) {
+      continue;
+    }
+    os << (first ? "\n" : ",\n") << "    {\"pid\": " << p_it.first
+       << ", \"name\": \"" << JSONEscape(ps.Name) << "\", \"provider\": \""
+       << JSONEscape(ps.ProviderFQName)
+       << "\", \"event_units\": " << ps.NEventUnits
+       << ", \"responses\": " << ps.NResponses << "}";
+    first = false;
+  }
+  os << "\n  ],\n  \"dropped_trace_events\": " << fNDroppedTraceEvents
+     << "\n}" << std::endl;
+}
+
+void Profiler::WriteChromeTrace(std::ostream &os) const {
+  double us_per_tick = 1E6 / GetTicksPerSecond();
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::fixed
+     << std::setprecision(3);
+  bool first = true;
+  for (TraceEvent const &ev : fTraceEvents) {
+    double ts = (ev.start > fStartTicks)
+                    ? double(ev.start - fStartTicks) * us_per_tick
+                    : 0;
+    os << (first ? "\n" : ",\n") << "{\"name\": \""
+       << JSONEscape(ev.counter->GetName()) << "\", \"cat\": \""
+       << JSONEscape(ev.counter->GetCategory())
+       << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << ev.tid
+       << ", \"ts\": " << ts
+       << ", \"dur\": " << (double(ev.end - ev.start) * us_per_tick) << "}";
+    first = false;
+  }
+  os << "\n]}" << std::defaultfloat << std::endl;
+}
+
+void Profiler::Write(std::string const &output_prefix) const {
+  std::ofstream json(output_prefix + ".json");
+  std::ofstream trace(output_prefix + ".trace.json");
+  if (!json || !trace) {
+    std::cout << "[ERROR]: Failed to open " << std::quoted(output_prefix)
+              << ".json or .trace.json to write profiling results."
+              << std::endl;
+    return;
+  }
+  WriteJSON(json);
+  WriteChromeTrace(trace);
+}
+
+void Profiler::Reset() {
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (auto &c : fCounters) {
+    c.second->fNCalls.store(0, std::memory_order_relaxed);
+    c.second->fTicks.store(0, std::memory_order_relaxed);
+    c.second->fNEventUnits.store(0, std::memory_order_relaxed);
+    c.second->fNParamResponses.store(0, std::memory_order_relaxed);
+    c.second->fNResponses.store(0, std::memory_order_relaxed);
+  }
+  for (auto &p : fParameters) {
+    p.second.NEventUnits = 0;
+    p.second.NResponses = 0;
+  }
+  fTraceEvents.clear();
+  fNDroppedTraceEvents = 0;
+}
+
+} // namespace systtools
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "systematicstools/interface/SystParamHeader.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SYSTTOOLS_PROFILE_HAVE_TSC
+#endif
+
+namespace systtools {
+
+///\brief Reads a cheap, monotonic tick counter.
+///
+/// The time stamp counter on x86, which costs a few ns to read, otherwise
+/// std::chrono::steady_clock nanoseconds. Ticks are converted to seconds with
+/// Profiler::GetTicksPerSecond.
+inline uint64_t ReadProfileTicks() {
+#ifdef SYSTTOOLS_PROFILE_HAVE_TSC
+  return __rdtsc();
+#else
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count());
+#endif
+}
+
+///\brief Aggregated wall time, call count, and output size of a single
+/// instrumented operation, e.g. the response calculation of one provider.
+class ProfileCounter {
+public:
+  ProfileCounter(std::string const &category, std::string const &name)
+      : fCategory(category), fName(name), fNCalls(0), fTicks(0),
+        fNEventUnits(0), fNParamResponses(0), fNResponses(0) {}
+
+  std::string const &GetCategory() const { return fCategory; }
+  std::string const &GetName() const { return fName; }
+  size_t GetNCalls() const { return fNCalls.load(std::memory_order_relaxed); }
+  uint64_t GetTicks() const { return fTicks.load(std::memory_order_relaxed); }
+  size_t GetNEventUnits() const {
+    return fNEventUnits.load(std::memory_order_relaxed);
+  }
+  size_t GetNParamResponses() const {
+    return fNParamResponses.load(std::memory_order_relaxed);
+  }
+  size_t GetNResponses() const {
+    return fNResponses.load(std::memory_order_relaxed);
+  }
+
+  void Record(uint64_t ticks, size_t NEventUnits = 0,
+              size_t NParamResponses = 0, size_t NResponses = 0) {
+    fNCalls.fetch_add(1, std::memory_order_relaxed);
+    fTicks.fetch_add(ticks, std::memory_order_relaxed);
+    fNEventUnits.fetch_add(NEventUnits, std::memory_order_relaxed);
+    fNParamResponses.fetch_add(NParamResponses, std::memory_order_relaxed);
+    fNResponses.fetch_add(NResponses, std::memory_order_relaxed);
+  }
+
+private:
+  friend class Profiler;
+
+  std::string fCategory;
+  std::string fName;
+  std::atomic<size_t> fNCalls;
+  std::atomic<uint64_t> fTicks;
+  std::atomic<size_t> fNEventUnits;
+  std::atomic<size_t> fNParamResponses;
+  std::atomic<size_t> fNResponses;
+};
+
+///\brief Counts the event units, parameter responses, and responses in an
+/// EventResponse or EventAndCVResponse.
+template <typename ER>
+inline void CountEventResponse(ER const &er, size_t &NParamResponses,
+                               size_t &NResponses) {
+  NParamResponses = 0;
+  NResponses = 0;
+  for (auto const &eur : er) {
+    NParamResponses += eur.size();
+    for (auto const &pr : eur) {
+      NResponses += pr.responses.size();
+    }
+  }
+}
+
+///\brief Process-wide collector of timing instrumentation.
+///
+/// Disabled by default, in which case instrumented code only pays for a
+/// relaxed atomic load. Collection is enabled by Enable, or by setting the
+/// SYSTTOOLS_PROFILE environment variable to an output prefix, in which case
+/// the totals are written to <prefix>.json, and a Chrome trace-event file,
+/// viewable in chrome://tracing or Perfetto, to <prefix>.trace.json at exit.
+///
+/// Built-in instrumentation, by category:
+///
+/// * "configure": ISystProviderTool configuration, per provider.
+/// * "response": response calculation wrapped in ProfileEventResponse, per
+/// provider. The number of event units and responses of each parameter are
+/// also recorded.
+/// * "merge": ExtendEventResponse.
+/// * "scrub": ScrubUnityEventResponses.
+///
+/// Further code, e.g. the per-parameter response calculation within a
+/// provider, can be instrumented with ProfileScope or
+/// SYSTTOOLS_PROFILE_SCOPE.
+class Profiler {
+public:
+  static Profiler &Get();
+  ~Profiler();
+
+  bool IsEnabled() const { return fEnabled.load(std::memory_order_relaxed); }
+  ///\brief Enables collection. If output_prefix is not empty, results are
+  /// written there at exit, see Write.
+  void Enable(std::string const &output_prefix = "");
+  void Disable() { fEnabled.store(false, std::memory_order_relaxed); }
+
+  ///\brief Gets the counter for an operation, creating it if required.
+  ///
+  ///\note The returned reference is valid for the lifetime of the process.
+  ProfileCounter &GetCounter(std::string const &category,
+                             std::string const &name);
+
+  ///\brief Adds a single call to the trace. Only the first
+  /// GetMaxTraceEvents() calls are kept, totals are always kept.
+  void AddTraceEvent(ProfileCounter const &counter, uint64_t start,
+                     uint64_t end);
+  void SetMaxTraceEvents(size_t n);
+  size_t GetMaxTraceEvents() const;
+
+  ///\brief Registers the names of the parameters handled by a provider, used
+  /// to label per-parameter output.
+  ///
+  ///\note Takes a SystMetaData, which cannot be named here as its header
+  /// depends on this one.
+  void SetParameterNames(std::string const &ProviderFQName,
+                         std::vector<SystParamHeader> const &md);
+  ///\brief Records the number of event units and responses of each parameter
+  /// in er.
+  template <typename ER>
+  void RecordParameterResponses(std::string const &ProviderFQName,
+                                ER const &er) {
+    std::lock_guard<std::mutex> lock(fMutex);
+    for (auto const &eur : er) {
+      for (auto const &pr : eur) {
+        ParameterStats &ps = fParameters[pr.pid];
+        if (ps.ProviderFQName.empty()) {
+          ps.ProviderFQName = ProviderFQName;
+        }
+        ps.NEventUnits++;
+        ps.NResponses += pr.responses.size();
+      }
+    }
+  }
+
+  ///\brief The tick rate of ReadProfileTicks, calibrated against
+  /// std::chrono::steady_clock since the Profiler was constructed, i.e. the
+  /// first call to Get.
+  ///
+  /// Waits until at least 10 ms have passed since construction.
+  double GetTicksPerSecond() const;
+
+  void WriteJSON(std::ostream &os) const;
+  void WriteChromeTrace(std::ostream &os) const;
+  ///\brief Writes WriteJSON to <output_prefix>.json and WriteChromeTrace to
+  /// <output_prefix>.trace.json.
+  void Write(std::string const &output_prefix) const;
+
+  ///\brief Resets all counters and drops all trace events.
+  void Reset();
+
+private:
+  Profiler();
+
+  struct TraceEvent {
+    ProfileCounter const *counter;
+    uint64_t start;
+    uint64_t end;
+    uint32_t tid;
+  };
+  struct ParameterStats {
+    std::string ProviderFQName;
+    std::string Name;
+    size_t NEventUnits = 0;
+    size_t NResponses = 0;
+  };
+
+  std::atomic<bool> fEnabled;
+  std::string fOutputPrefix;
+  uint64_t fStartTicks;
+  std::chrono::steady_clock::time_point fStartTime;
+
+  mutable std::mutex fMutex;
+  std::map<std::pair<std::string, std::string>,
+           std::unique_ptr<ProfileCounter>>
+      fCounters;
+  std::vector<TraceEvent> fTraceEvents;
+  size_t fMaxTraceEvents;
+  size_t fNDroppedTraceEvents;
+  std::map<paramId_t, ParameterStats> fParameters;
+};
+
+///\brief Times the enclosing scope and records it to a ProfileCounter.
+///
+/// Does nothing if constructed with a null counter, or while the Profiler is
+/// disabled.
+class ProfileScope {
+public:
+  explicit ProfileScope(ProfileCounter *counter)
+      : fCounter(counter), fStart(counter ? ReadProfileTicks() : 0),
+        fNEventUnits(0), fNParamResponses(0), fNResponses(0) {}
+  ProfileScope(std::string const &category, std::string const &name)
+      : ProfileScope(Profiler::Get().IsEnabled()
+                         ? &Profiler::Get().GetCounter(category, name)
+                         : nullptr) {}
+  ProfileScope(ProfileScope const &) = delete;
+  ProfileScope &operator=(ProfileScope const &) = delete;
+
+  ~ProfileScope() {
+    if (!fCounter) {
+      return;
+    }
+    uint64_t end = ReadProfileTicks();
+    fCounter->Record(end - fStart, fNEventUnits, fNParamResponses,
+                     fNResponses);
+    Profiler::Get().AddTraceEvent(*fCounter, fStart, end);
+  }
+
+  bool IsActive() const { return fCounter; }
+  void SetOutputSize(size_t NEventUnits, size_t NParamResponses = 0,
+                     size_t NResponses = 0) {
+    fNEventUnits = NEventUnits;
+    fNParamResponses = NParamResponses;
+    fNResponses = NResponses;
+  }
+  ///\brief Sets the output size from an EventResponse or
+  /// EventAndCVResponse.
+  template <typename ER> void SetOutputSize(ER const &er) {
+    if (fCounter) {
+      fNEventUnits = er.size();
+      CountEventResponse(er, fNParamResponses, fNResponses);
+    }
+  }
+
+private:
+  ProfileCounter *fCounter;
+  uint64_t fStart;
+  size_t fNEventUnits;
+  size_t fNParamResponses;
+  size_t fNResponses;
+};
+
+///\brief Calls calc, which returns a std::unique_ptr<EventResponse>, and
+/// records it as the response calculation of provider ProviderFQName.
+///
+/// e.g. auto er = ProfileEventResponse(
+///          tool->GetFullyQualifiedName(),
+///          [&]() { return tool->GetEventResponse(ev); });
+template <typename F>
+inline auto ProfileEventResponse(std::string const &ProviderFQName, F &&calc)
+    -> decltype(calc()) {
+  Profiler &prof = Profiler::Get();
+  if (!prof.IsEnabled()) {
+    return calc();
+  }
+  ProfileCounter &counter = prof.GetCounter("response", ProviderFQName);
+  uint64_t start = ReadProfileTicks();
+  auto er = calc();
+  uint64_t end = ReadProfileTicks();
+
+  size_t NParamResponses = 0, NResponses = 0;
+  if (er) {
+    CountEventResponse(*er, NParamResponses, NResponses);
+    prof.RecordParameterResponses(ProviderFQName, *er);
+  }
+  counter.Record(end - start, er ? er->size() : 0, NParamResponses,
+                 NResponses);
+  prof.AddTraceEvent(counter, start, end);
+  return er;
+}
+
+} // namespace systtools
+
+///\brief Declares a ProfileScope, VAR, that times the rest of the enclosing
+/// scope. The counter for CATEGORY and NAME is looked up once, so NAME must
+/// not change between calls.
+#define SYSTTOOLS_PROFILE_SCOPE(VAR, CATEGORY, NAME)                           \
+  static systtools::ProfileCounter &VAR##_systtools_counter =                  \
+      systtools::Profiler::Get().GetCounter(CATEGORY, NAME);                   \
+  systtools::ProfileScope VAR(systtools::Profiler::Get().IsEnabled()           \
+                                  ? &VAR##_systtools_counter                   \
+                                  : nullptr)
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "systematicstools/utility/MemoryFootprint.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace systtools {
+
+namespace detail {
+
+inline size_t HashCombine(size_t h, size_t v) {
+  return h ^ (v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2));
+}
+
+///\brief A pool of weak references to immutable, shared values, used to make
+/// identical values share storage.
+template <typename V> class InternPool {
+public:
+  static InternPool &Get() {
+    static InternPool pool;
+    return pool;
+  }
+
+  ///\brief Returns the storage of a value, still in use, that compares equal
+  /// to *v, or adds v to the pool and returns it.
+  std::shared_ptr<V> Intern(std::shared_ptr<V> v, size_t hash) {
+    std::lock_guard<std::mutex> lock(fMutex);
+    auto range = fEntries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      std::shared_ptr<V> existing = it->second.lock();
+      if (existing && (*existing == *v)) {
+        return existing;
+      }
+    }
+    if (fEntries.size() >= fNextPrune) {
+      Prune();
+    }
+    fEntries.emplace(hash, v);
+    return v;
+  }
+
+private:
+  void Prune() {
+    for (auto it = fEntries.begin(); it != fEntries.end();) {
+      it = it->second.expired() ? fEntries.erase(it) : std::next(it);
+    }
+    fNextPrune = 2 * std::max(fEntries.size(), size_t(32));
+  }
+
+  std::mutex fMutex;
+  std::unordered_multimap<size_t, std::weak_ptr<V>> fEntries;
+  size_t fNextPrune = 64;
+};
+
+} // namespace detail
+
+///\brief A copy-on-write std::vector.
+///
+/// Copies share storage until one of them is modified. Identical vectors built
+/// separately, e.g. the throws of many parameters thrown from the same
+/// distribution, can also be made to share storage with Intern.
+///
+/// Reading is through the usual const std::vector interface, or a
+/// std::vector<T> const & from get or by implicit conversion. Modifying
+/// methods, including the non-const element access and iterators, copy the
+/// storage first if it is shared, so read through a const reference or get
+/// to keep it shared. The storage can be passed on as a std::vector<T> & via
+/// Mutable.
+///
+///\note As for std::vector, a single instance must not be modified and
+/// accessed concurrently, but copies may be used from different threads.
+template <typename T> class SharedVector {
+public:
+  typedef std::vector<T> vector_type;
+  typedef T value_type;
+  typedef typename vector_type::size_type size_type;
+  typedef typename vector_type::const_iterator const_iterator;
+  typedef typename vector_type::iterator iterator;
+
+  SharedVector() {}
+  SharedVector(vector_type v) {
+    if (v.size()) {
+      fData = std::make_shared<vector_type>(std::move(v));
+    }
+  }
+  SharedVector(std::initializer_list<T> il) : SharedVector(vector_type(il)) {}
+
+  SharedVector &operator=(vector_type v) {
+    return (*this = SharedVector(std::move(v)));
+  }
+  SharedVector &operator=(std::initializer_list<T> il) {
+    return (*this = SharedVector(vector_type(il)));
+  }
+
+  vector_type const &get() const { return fData ? *fData : Empty(); }
+  operator vector_type const &() const { return get(); }
+
+  size_type size() const { return fData ? fData->size() : 0; }
+  bool empty() const { return !size(); }
+  const_iterator begin() const { return get().begin(); }
+  const_iterator end() const { return get().end(); }
+  T const &operator[](size_type i) const { return (*fData)[i]; }
+  T const &at(size_type i) const { return get().at(i); }
+  T const &front() const { return fData->front(); }
+  T const &back() const { return fData->back(); }
+  T const *data() const { return fData ? fData->data() : nullptr; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  iterator begin() { return Mutable().begin(); }
+  iterator end() { return Mutable().end(); }
+  T &operator[](size_type i) { return Mutable()[i]; }
+  T &at(size_type i) { return Mutable().at(i); }
+  T &front() { return Mutable().front(); }
+  T &back() { return Mutable().back(); }
+  T *data() { return Mutable().data(); }
+
+  void clear() {
+    fData.reset();
+    fInterned = false;
+  }
+  void reserve(size_type n) { Mutable().reserve(n); }
+  void push_back(T const &v) { Mutable().push_back(v); }
+  template <typename... Args> T &emplace_back(Args &&... args) {
+    Mutable().emplace_back(std::forward<Args>(args)...);
+    return fData->back();
+  }
+  void pop_back() { Mutable().pop_back(); }
+  // pos may point into storage that Mutable is about to copy, so it is
+  // carried over to the copy as an index.
+  iterator insert(const_iterator pos, T const &v) {
+    size_type i = pos - cbegin();
+    vector_type &data = Mutable();
+    return data.insert(data.cbegin() + i, v);
+  }
+  iterator erase(const_iterator pos) {
+    size_type i = pos - cbegin();
+    vector_type &data = Mutable();
+    return data.erase(data.cbegin() + i);
+  }
+  void resize(size_type n, T const &v = T()) { Mutable().resize(n, v); }
+  void set(size_type i, T const &v) { Mutable()[i] = v; }
+
+  ///\brief Gets the storage for modification, copying it first if shared.
+  vector_type &Mutable() {
+    if (!fData) {
+      fData = std::make_shared<vector_type>();
+    } else if (fInterned || (fData.use_count() > 1)) {
+      fData = std::make_shared<vector_type>(*fData);
+    }
+    fInterned = false;
+    return *fData;
+  }
+
+  ///\brief Whether two instances share the same storage.
+  bool SharesStorageWith(SharedVector const &other) const {
+    return fData && (fData == other.fData);
+  }
+  ///\brief The number of instances sharing this storage.
+  long use_count() const { return fData.use_count(); }
+
+  ///\brief Replaces the storage with that of an identical, previously
+  /// interned vector, if one is still in use, otherwise interns this one.
+  ///
+  /// Thread safe. The pool only holds weak references, so interned storage
+  /// is freed as normal once no instances use it.
+  SharedVector &Intern() {
+    if (!fData || fInterned) {
+      return *this;
+    }
+    size_t hash = Hash(*fData);
+    fData = detail::InternPool<vector_type>::Get().Intern(std::move(fData),
+                                                          hash);
+    fInterned = true;
+    return *this;
+  }
+
+  friend bool operator==(SharedVector const &l, SharedVector const &r) {
+    return (l.fData == r.fData) || (l.get() == r.get());
+  }
+  friend bool operator!=(SharedVector const &l, SharedVector const &r) {
+    return !(l == r);
+  }
+
+private:
+  static vector_type const &Empty() {
+    static vector_type const empty;
+    return empty;
+  }
+
+  static size_t Hash(vector_type const &v) {
+    size_t h = std::hash<size_t>()(v.size());
+    for (T const &e : v) {
+      h = detail::HashCombine(h, std::hash<T>()(e));
+    }
+    return h;
+  }
+
+  std::shared_ptr<vector_type> fData;
+  bool fInterned = false;
+};
+
+namespace footprint {
+
+///\brief Shared storage is apportioned evenly between the instances that
+/// share it, so that summing over all of them counts it once.
+template <typename T> inline size_t HeapBytes(SharedVector<T> const &v) {
+  if (!v.use_count()) {
+    return 0;
+  }
+  return (v.get().capacity() * sizeof(T)) / size_t(v.use_count());
+}
+
+} // namespace footprint
+
+} // namespace systtools
@@ -1,4 +1,5 @@
 #include "systematicstools/interface/SystMetaData.hh"
+#include "systematicstools/interface/types.hh"
 
 #include <set>
 
@@ -178,4 +179,26 @@ void ExtendSystMetaData(SystMetaData &md1, SystMetaData const &md2) {
     md1.push_back(sph);
   }
 }
+
+MemoryBreakdown MemoryFootprint(SystMetaData const &md) {
+  MemoryBreakdown mb;
+  mb.Add("headers", footprint::HeapBytes(md));
+  for (auto const &hdr : md) {
+    mb += MemoryFootprint(hdr);
+  }
+  return mb;
+}
+
+MemoryBreakdown MemoryFootprint(param_header_map_t const &headers) {
+  MemoryBreakdown mb;
+  size_t NodeBytes = footprint::NodeBytes(headers);
+  size_t HeaderBytes = headers.size() * sizeof(ParamHeaderProviderName);
+  mb.Add("maps", NodeBytes - HeaderBytes);
+  mb.Add("headers", HeaderBytes);
+  for (auto const &hdr_it : headers) {
+    mb.Add("headers", footprint::HeapBytes(hdr_it.second.ProviderFQName));
+    mb += MemoryFootprint(hdr_it.second.Header);
+  }
+  return mb;
+}
 } // namespace systtools
@@ -8,14 +8,12 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 
 namespace systtools {
 
-/// \brief Exception raised when no key-value pair with a given key can be found
-/// in a given SystParamHeader.
-NEW_SYSTTOOLS_EXCEPT(no_such_opt_kv);
 /// \brief Exception raised if a SystMetaData fails basic interface validation.
 NEW_SYSTTOOLS_EXCEPT(invalid_SystMetaData);
 /// \brief A list of Parameter Headers
@@ -80,12 +78,11 @@ SystParamHeader &GetParam(SystMetaData &md, paramId_t pid);
 /// opts entry.
 template <typename T>
 inline bool SystHasOpt(SystMetaData const &md, T const &ident,
-                       std::string const &opt) {
+                       std::string_view opt) {
   if (!HasParam(md, ident)) {
     return false;
   }
-  SystParamHeader const &hdr = GetParam(md, ident);
-  return (std::find(hdr.opts.begin(), hdr.opts.end(), opt) != hdr.opts.end());
+  return GetParam(md, ident).opts.Has(opt);
 }
 ///\brief Returns true if the Parameter Header specified by ident has a matching
 /// opts key-value entry.
@@ -93,39 +90,33 @@ inline bool SystHasOpt(SystMetaData const &md, T const &ident,
 /// \note Looks for an entry in SystParamHeader::opts that begins with `<key>=`
 template <typename T>
 inline bool SystHasOptKV(SystMetaData const &md, T const &ident,
-                         std::string const &key) {
+                         std::string_view key) {
   if (!HasParam(md, ident)) {
     return false;
   }
-  SystParamHeader const &hdr = GetParam(md, ident);
-  for (auto const &opt : hdr.opts) {
-    if (opt.find(key + "=") == 0) {
-      return true;
-    }
-  }
-  return false;
+  return GetParam(md, ident).opts.HasKV(key);
 }
 ///\brief Returns the option value corresponding to `key` on the Param Header
 /// specified by ident.
 ///
 /// \note Looks for an entry in SystParamHeader::opts that begins with `<key>=`
-/// and returns the rest of the string.
+/// and returns the rest of the string. Use SystParamOpts::FindKV directly to
+/// avoid the copy.
 template <typename T>
 inline std::string SystGetOptKV(SystMetaData const &md, T const &ident,
-                                std::string const &key) {
+                                std::string_view key) {
   if (!HasParam(md, ident)) {
     return "";
   }
   SystParamHeader const &hdr = GetParam(md, ident);
-  for (auto const &opt : hdr.opts) {
-    if (opt.find(key + "=") == 0) {
-      return opt.substr(key.size() + 1);
-    }
+  std::string_view value;
+  if (!hdr.opts.FindKV(key, value)) {
+    throw no_such_opt_kv() << "[ERROR]: For header, "
+                           << std::quoted(hdr.prettyName)
+                           << " failed to find KV option for key: "
+                           << std::quoted(std::string(key));
   }
-  throw no_such_opt_kv() << "[ERROR]: For header, "
-                         << std::quoted(hdr.prettyName)
-                         << " failed to find KV option for key: "
-                         << std::quoted(key);
+  return std::string(value);
 }
 
 ///\brief Checks for declared and mis-used interdependency between parameters in
@@ -150,5 +141,8 @@ bool Validate(SystMetaData const &sh, bool quiet = true);
 /// (systtools::systParamId_collision), then an exception is raised.
 void ExtendSystMetaData(SystMetaData &md1, SystMetaData const &md2);
 
+///\brief The memory owned by a list of headers, reported as "headers".
+MemoryBreakdown MemoryFootprint(SystMetaData const &md);
+
 } // namespace systtools
 
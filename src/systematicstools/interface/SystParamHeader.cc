@@ -134,4 +134,13 @@ bool Validate(SystParamHeader const &hdr, bool quiet) {
   }
   return true;
 }
+
+MemoryBreakdown MemoryFootprint(SystParamHeader const &hdr) {
+  MemoryBreakdown mb;
+  mb.Add("headers", footprint::HeapBytes(hdr.prettyName) +
+                        footprint::HeapBytes(hdr.paramVariations) +
+                        footprint::HeapBytes(hdr.responses) +
+                        footprint::HeapBytes(hdr.opts));
+  return mb;
+}
 }
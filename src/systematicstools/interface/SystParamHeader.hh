@@ -1,5 +1,9 @@
 #pragma once
 
+#include "systematicstools/interface/SharedVector.hh"
+#include "systematicstools/interface/SystParamOpts.hh"
+
+#include "systematicstools/utility/MemoryFootprint.hh"
 #include "systematicstools/utility/exceptions.hh"
 
 #include <array>
@@ -129,7 +133,11 @@ struct SystParamHeader {
   /// units, see `oneSigmaShifts`) that were used to determine responses. The
   /// responses can either be event-level or parameter-level, parameter-level
   /// responses are stored in `responses`.
-  std::vector<double> paramVariations;
+  ///
+  /// Copy-on-write, so copies of a header share their variations. Headers
+  /// read from FHiCL or binary documents also share identical variations with
+  /// each other, see SharedVector::Intern.
+  SharedVector<double> paramVariations;
   ///\brief Whether variations of this parameter produce responses via this
   /// header.
   ///
@@ -154,7 +162,10 @@ struct SystParamHeader {
 
   ///\brief Arbitrary string options stored in the metadata for further
   /// `ISystProviderTool` configuration.
-  std::vector<std::string> opts;
+  ///
+  /// `<key>=<value>` options are parsed once, when set, and can be looked up
+  /// without allocating with SystParamOpts::FindKV.
+  SystParamOpts opts;
 };
 
 ///\brief Checks interface validity of a SystParamHeader
@@ -181,4 +192,8 @@ struct SystParamHeader {
 /// responses defined? (shouldn't)
 bool Validate(SystParamHeader const &hdr, bool quiet = true);
 
+///\brief The memory owned by the names, variations, responses, and opts of a
+/// header, reported as "headers".
+MemoryBreakdown MemoryFootprint(SystParamHeader const &hdr);
+
 } // namespace systtools
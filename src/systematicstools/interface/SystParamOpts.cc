@@ -0,0 +1,142 @@
+#include "systematicstools/interface/SystParamOpts.hh"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+
+namespace systtools {
+
+namespace {
+
+bool IsKVWithKey(std::string const &opt, std::string_view key) {
+  return (opt.size() > key.size()) && (opt.compare(0, key.size(), key) == 0) &&
+         (opt[key.size()] == '=');
+}
+
+} // namespace
+
+void SystParamOpts::Set(vector_type opts) {
+  if (opts.empty()) {
+    fTable.reset();
+    return;
+  }
+  auto table = std::make_shared<Table>();
+  table->opts = std::move(opts);
+
+  size_t hash = std::hash<size_t>()(table->opts.size());
+  for (uint32_t opt_it = 0; opt_it < table->opts.size(); ++opt_it) {
+    std::string const &opt = table->opts[opt_it];
+    hash = detail::HashCombine(hash, std::hash<std::string>()(opt));
+    size_t eq_pos = opt.find('=');
+    if (eq_pos != std::string::npos) {
+      table->kv.emplace_back(opt_it, uint32_t(eq_pos));
+    }
+  }
+  // Stable, so that the first of any repeated keys is found first.
+  std::stable_sort(table->kv.begin(), table->kv.end(),
+                   [&](std::pair<uint32_t, uint32_t> const &l,
+                       std::pair<uint32_t, uint32_t> const &r) {
+                     return std::string_view(table->opts[l.first])
+                                .substr(0, l.second) <
+                            std::string_view(table->opts[r.first])
+                                .substr(0, r.second);
+                   });
+
+  fTable = detail::InternPool<Table const>::Get().Intern(std::move(table),
+                                                         hash);
+}
+
+size_t SystParamOpts::FindKVIndex(std::string_view key) const {
+  if (!fTable) {
+    return 0;
+  }
+  Table const &table = *fTable;
+  size_t lo = 0, hi = table.kv.size();
+  while (lo < hi) {
+    size_t mid = lo + ((hi - lo) / 2);
+    if (table.Key(mid) < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return ((lo < table.kv.size()) && (table.Key(lo) == key)) ? (lo + 1) : 0;
+}
+
+bool SystParamOpts::Has(std::string_view opt) const {
+  for (std::string const &o : get()) {
+    if (o == opt) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SystParamOpts::FindKV(std::string_view key,
+                           std::string_view &value) const {
+  size_t kv_it = FindKVIndex(key);
+  if (!kv_it) {
+    return false;
+  }
+  value = fTable->Value(kv_it - 1);
+  return true;
+}
+
+std::string_view SystParamOpts::GetKV(std::string_view key) const {
+  std::string_view value;
+  if (!FindKV(key, value)) {
+    throw no_such_opt_kv() << "[ERROR]: Failed to find KV option for key: "
+                           << std::quoted(std::string(key));
+  }
+  return value;
+}
+
+void SystParamOpts::push_back(std::string opt) {
+  vector_type opts = get();
+  opts.push_back(std::move(opt));
+  Set(std::move(opts));
+}
+
+SystParamOpts::const_iterator SystParamOpts::erase(const_iterator it) {
+  size_t idx = size_t(std::distance(begin(), it));
+  vector_type opts = get();
+  opts.erase(opts.begin() + idx);
+  Set(std::move(opts));
+  return begin() + idx;
+}
+
+void SystParamOpts::SetKV(std::string_view key, std::string_view value) {
+  vector_type opts;
+  for (std::string const &opt : get()) {
+    if (!IsKVWithKey(opt, key)) {
+      opts.push_back(opt);
+    }
+  }
+  opts.push_back(std::string(key) + "=" + std::string(value));
+  Set(std::move(opts));
+}
+
+size_t SystParamOpts::EraseKV(std::string_view key) {
+  if (!HasKV(key)) {
+    return 0;
+  }
+  vector_type opts;
+  for (std::string const &opt : get()) {
+    if (!IsKVWithKey(opt, key)) {
+      opts.push_back(opt);
+    }
+  }
+  size_t NErased = size() - opts.size();
+  Set(std::move(opts));
+  return NErased;
+}
+
+size_t SystParamOpts::SharedHeapBytes() const {
+  if (!fTable) {
+    return 0;
+  }
+  return sizeof(Table) + footprint::HeapBytes(fTable->opts) +
+         footprint::HeapBytes(fTable->kv);
+}
+
+} // namespace systtools
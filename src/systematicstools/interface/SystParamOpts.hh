@@ -0,0 +1,156 @@
+#pragma once
+
+#include "systematicstools/interface/SharedVector.hh"
+
+#include "systematicstools/utility/MemoryFootprint.hh"
+#include "systematicstools/utility/exceptions.hh"
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace systtools {
+
+/// \brief Exception raised when no key-value pair with a given key can be found
+/// in a given SystParamHeader.
+NEW_SYSTTOOLS_EXCEPT(no_such_opt_kv);
+
+///\brief The arbitrary string options of a SystParamHeader, with a key-value
+/// table parsed once when they are set.
+///
+/// Reads like a const std::vector<std::string>, which is also the serialized
+/// form. Options of the form `<key>=<value>` are indexed by key, where the key
+/// is everything before the first `=`, so that HasKV, FindKV, and GetKV are
+/// binary searches that do not allocate. If a key appears more than once, the
+/// first entry is used.
+///
+/// The options and table are immutable and shared: copies, and any instances
+/// holding identical options, use the same storage. Modifying methods build a
+/// new table, so they should not be used in per-event code.
+class SystParamOpts {
+public:
+  typedef std::vector<std::string> vector_type;
+  typedef std::string value_type;
+  typedef vector_type::size_type size_type;
+  typedef vector_type::const_iterator const_iterator;
+  typedef const_iterator iterator;
+
+  SystParamOpts() {}
+  SystParamOpts(vector_type opts) { Set(std::move(opts)); }
+  SystParamOpts(std::initializer_list<std::string> il) { Set(il); }
+
+  SystParamOpts &operator=(vector_type opts) {
+    Set(std::move(opts));
+    return *this;
+  }
+  SystParamOpts &operator=(std::initializer_list<std::string> il) {
+    Set(il);
+    return *this;
+  }
+
+  vector_type const &get() const { return fTable ? fTable->opts : Empty(); }
+  operator vector_type const &() const { return get(); }
+
+  size_type size() const { return get().size(); }
+  bool empty() const { return !size(); }
+  const_iterator begin() const { return get().begin(); }
+  const_iterator end() const { return get().end(); }
+  std::string const &operator[](size_type i) const { return get()[i]; }
+  std::string const &at(size_type i) const { return get().at(i); }
+  std::string const &front() const { return get().front(); }
+  std::string const &back() const { return get().back(); }
+
+  void clear() { fTable.reset(); }
+  void push_back(std::string opt);
+  ///\brief Removes an option, returning an iterator to the following one.
+  const_iterator erase(const_iterator it);
+
+  ///\brief Whether an option exactly matching opt exists.
+  bool Has(std::string_view opt) const;
+  ///\brief Whether an option of the form `<key>=<value>` exists.
+  bool HasKV(std::string_view key) const {
+    return bool(FindKVIndex(key));
+  }
+  ///\brief Sets value to the value of the option with the given key, if one
+  /// exists.
+  ///
+  /// value views storage owned by this instance, and remains valid until it
+  /// is modified or destroyed.
+  bool FindKV(std::string_view key, std::string_view &value) const;
+  ///\brief Gets the value of the option with the given key.
+  ///
+  ///\note throws no_such_opt_kv if there is no such option.
+  std::string_view GetKV(std::string_view key) const;
+
+  ///\brief Replaces any options with the given key with `<key>=<value>`.
+  void SetKV(std::string_view key, std::string_view value);
+  ///\brief Removes any options with the given key, returning how many were
+  /// removed.
+  size_t EraseKV(std::string_view key);
+
+  ///\brief Whether two instances share the same storage.
+  bool SharesStorageWith(SystParamOpts const &other) const {
+    return fTable && (fTable == other.fTable);
+  }
+  ///\brief The number of instances sharing this storage.
+  long use_count() const { return fTable.use_count(); }
+  ///\brief The heap memory of the shared options and table.
+  size_t SharedHeapBytes() const;
+
+  friend bool operator==(SystParamOpts const &l, SystParamOpts const &r) {
+    return (l.fTable == r.fTable) || (l.get() == r.get());
+  }
+  friend bool operator!=(SystParamOpts const &l, SystParamOpts const &r) {
+    return !(l == r);
+  }
+
+private:
+  struct Table {
+    vector_type opts;
+    ///\brief The option index and key length of each key-value option,
+    /// sorted by key.
+    std::vector<std::pair<uint32_t, uint32_t>> kv;
+
+    std::string_view Key(size_t kv_it) const {
+      return std::string_view(opts[kv[kv_it].first])
+          .substr(0, kv[kv_it].second);
+    }
+    std::string_view Value(size_t kv_it) const {
+      return std::string_view(opts[kv[kv_it].first])
+          .substr(kv[kv_it].second + 1);
+    }
+
+    bool operator==(Table const &other) const { return opts == other.opts; }
+  };
+
+  void Set(vector_type opts);
+  ///\brief Returns one past the table index of the first option with the
+  /// given key, or 0 if there is none.
+  size_t FindKVIndex(std::string_view key) const;
+
+  static vector_type const &Empty() {
+    static vector_type const empty;
+    return empty;
+  }
+
+  std::shared_ptr<Table const> fTable;
+};
+
+namespace footprint {
+
+///\brief Shared storage is apportioned evenly between the instances that
+/// share it, so that summing over all of them counts it once.
+inline size_t HeapBytes(SystParamOpts const &opts) {
+  if (!opts.use_count()) {
+    return 0;
+  }
+  return opts.SharedHeapBytes() / size_t(opts.use_count());
+}
+
+} // namespace footprint
+
+} // namespace systtools
@@ -63,6 +63,12 @@ struct ParamHeaderProviderName {
 /// name of the ISystProviderTool responsible for generating them.
 typedef std::map<paramId_t, ParamHeaderProviderName> param_header_map_t;
 
+///\brief The memory owned by a header map, reported as "headers", and the map
+/// node overhead as "maps".
+///
+///\note Defined in SystMetaData.cc
+MemoryBreakdown MemoryFootprint(param_header_map_t const &headers);
+
 ///\brief Gets the index of a parameter--X association with a given paramId_t
 ///
 /// Returns kParamUnhandled<size_t> if parameter does not exist in the
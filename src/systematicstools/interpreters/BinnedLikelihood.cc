@@ -0,0 +1,295 @@
+#include "systematicstools/interpreters/BinnedLikelihood.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace systtools {
+
+BinnedLikelihood::BinnedLikelihood(std::vector<double> data,
+                                   param_header_map_t const &headers,
+                                   param_list_t const &params,
+                                   Config const &cfg)
+    : fConfig(cfg), fData(std::move(data)), fParamIds(params),
+      fMaxEntriesPerEvent(0) {
+  fConfig.ChunkSize = std::max(fConfig.ChunkSize, size_t(1));
+  fEventEntryOffsets.push_back(0);
+
+  for (paramId_t pid : fParamIds) {
+    auto hdr_it = headers.find(pid);
+    if (hdr_it == headers.end()) {
+      throw invalid_binned_likelihood()
+          << "[ERROR]: Parameter " << pid
+          << " was requested, but it has no header.";
+    }
+    SystParamHeader const &hdr = hdr_it->second.Header;
+    if (fParamIndex.count(pid)) {
+      throw invalid_binned_likelihood()
+          << "[ERROR]: Parameter " << hdr.prettyName << " (" << pid
+          << ") was requested more than once.";
+    }
+    fParamIndex.emplace(pid, uint32_t(fParams.size()));
+
+    Param p;
+    if (hdr.isSplineable) {
+      p.Knots = hdr.paramVariations.get();
+    }
+    p.Central = hdr.centralParamValue;
+    p.SigmaLow = std::fabs(hdr.oneSigmaShifts[0]);
+    p.SigmaUp = std::fabs(hdr.oneSigmaShifts[1]);
+    p.HasPenalty = (hdr.centralParamValue != kDefaultDouble) &&
+                   (hdr.oneSigmaShifts[0] != kDefaultDouble) &&
+                   (hdr.oneSigmaShifts[1] != kDefaultDouble) &&
+                   (p.SigmaLow > 0) && (p.SigmaUp > 0);
+    p.DiffersEventByEvent = hdr.differsEventByEvent;
+    p.GlobalOffset = std::numeric_limits<size_t>::max();
+    p.GlobalOrder = 0;
+    p.x = 0;
+    p.knot = 0;
+    p.dx = 0;
+    fParams.push_back(std::move(p));
+  }
+}
+
+void BinnedLikelihood::AddResponse(paramId_t pid,
+                                   std::vector<double> const &knots,
+                                   double const *coeffs, size_t order) {
+  auto pidx_it = fParamIndex.find(pid);
+  if (pidx_it == fParamIndex.end()) {
+    return;
+  }
+  Param &p = fParams[pidx_it->second];
+  if (p.GlobalOffset != std::numeric_limits<size_t>::max()) {
+    fEntries.push_back({pidx_it->second, p.GlobalOrder, p.GlobalOffset});
+    return;
+  }
+
+  size_t NCoeffs = order + 1;
+  if (!order) {
+    if (knots != p.Knots.get()) {
+      throw invalid_binned_likelihood()
+          << "[ERROR]: Cached response for parameter " << pid << " has "
+          << knots.size() << " knots, which differ from the "
+          << p.Knots.size() << " knots listed by its header.";
+    }
+    NCoeffs = kNSplineCoeffs * knots.size();
+  }
+  size_t offset = fCoeffs.size();
+  fCoeffs.insert(fCoeffs.end(), coeffs, coeffs + NCoeffs);
+  // Responses that do not differ event by event are stored once.
+  if (!p.DiffersEventByEvent) {
+    p.GlobalOffset = offset;
+    p.GlobalOrder = uint32_t(order);
+  }
+  fEntries.push_back({pidx_it->second, uint32_t(order), offset});
+}
+
+void BinnedLikelihood::AddEvent(int bin, double weight) {
+  fEventBins.push_back(bin);
+  fEventWeights.push_back(weight);
+  fEventEntryOffsets.push_back(fEntries.size());
+  fMaxEntriesPerEvent =
+      std::max(fMaxEntriesPerEvent, fEventEntryOffsets.back() -
+                                        fEventEntryOffsets[GetNEvents() - 1]);
+}
+
+void BinnedLikelihood::FillChunk(size_t c_it, bool gradient,
+                                 std::vector<double> &scratch) {
+  size_t NBins = fData.size();
+  size_t NParams = fParams.size();
+  double *hist = fChunkHists.data() + (c_it * NBins);
+  std::fill_n(hist, NBins, 0);
+  double *grad = nullptr;
+  if (gradient) {
+    grad = fChunkGrads.data() + (c_it * NBins * NParams);
+    std::fill_n(grad, NBins * NParams, 0);
+    scratch.resize(2 * fMaxEntriesPerEvent);
+  }
+
+  size_t begin = c_it * fConfig.ChunkSize;
+  size_t end = std::min(GetNEvents(), begin + fConfig.ChunkSize);
+  for (size_t e_it = begin; e_it < end; ++e_it) {
+    Entry const *en = fEntries.data() + fEventEntryOffsets[e_it];
+    size_t NEntries = fEventEntryOffsets[e_it + 1] - fEventEntryOffsets[e_it];
+    double weight = fEventWeights[e_it];
+
+    if (!grad) {
+      for (size_t en_it = 0; en_it < NEntries; ++en_it) {
+        Param const &p = fParams[en[en_it].param];
+        double const *coeffs = fCoeffs.data() + en[en_it].offset;
+        weight *= en[en_it].order
+                      ? EvalPolyCoeffs(coeffs, en[en_it].order, p.x)
+                      : EvalSplineCoeffs(coeffs, p.knot, p.dx);
+      }
+      hist[fEventBins[e_it]] += weight;
+      continue;
+    }
+
+    // deriv[i] first holds the derivative of response i times the product of
+    // the weight and responses before it, and then the product of those after
+    // it, so that the gradient is a single pass.
+    double *resp = scratch.data();
+    double *deriv = resp + NEntries;
+    for (size_t en_it = 0; en_it < NEntries; ++en_it) {
+      Param const &p = fParams[en[en_it].param];
+      double const *coeffs = fCoeffs.data() + en[en_it].offset;
+      if (en[en_it].order) {
+        resp[en_it] = EvalPolyCoeffs(coeffs, en[en_it].order, p.x);
+        deriv[en_it] =
+            weight * EvalPolyCoeffsDerivative(coeffs, en[en_it].order, p.x);
+      } else {
+        resp[en_it] = EvalSplineCoeffs(coeffs, p.knot, p.dx);
+        deriv[en_it] =
+            weight * EvalSplineCoeffsDerivative(coeffs, p.knot, p.dx);
+      }
+      weight *= resp[en_it];
+    }
+    hist[fEventBins[e_it]] += weight;
+    double *bin_grad = grad + (size_t(fEventBins[e_it]) * NParams);
+    double after = 1;
+    for (size_t en_it = NEntries; en_it-- > 0;) {
+      bin_grad[en[en_it].param] += deriv[en_it] * after;
+      after *= resp[en_it];
+    }
+  }
+}
+
+double BinnedLikelihood::Evaluate(double const *x, double *gradient) {
+  size_t NBins = fData.size();
+  size_t NParams = fParams.size();
+
+  for (size_t p_it = 0; p_it < NParams; ++p_it) {
+    Param &p = fParams[p_it];
+    p.x = x[p_it];
+    if (p.Knots.empty()) {
+      continue;
+    }
+    p.knot = p.Knots.Find(x[p_it]);
+    p.dx = x[p_it] - p.Knots[p.knot];
+  }
+
+  // Always at least one chunk, so that an empty sample reduces to zeros.
+  size_t NChunks = std::max(
+      (GetNEvents() + fConfig.ChunkSize - 1) / fConfig.ChunkSize, size_t(1));
+  fChunkHists.resize(NChunks * NBins);
+  if (gradient) {
+    fChunkGrads.resize(NChunks * NBins * NParams);
+  }
+
+  size_t NThreads = fConfig.NThreads ? fConfig.NThreads
+                                     : std::thread::hardware_concurrency();
+  NThreads = std::min(std::max(NThreads, size_t(1)), NChunks);
+  fThreadScratch.resize(NThreads);
+
+  // Chunks are interleaved between threads, every chunk has its own
+  // histogram, so the assignment does not affect the result.
+  auto FillChunks = [&](size_t t_it) {
+    for (size_t c_it = t_it; c_it < NChunks; c_it += NThreads) {
+      FillChunk(c_it, gradient, fThreadScratch[t_it]);
+    }
+  };
+  if (NThreads < 2) {
+    FillChunks(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (size_t t_it = 0; t_it < NThreads; ++t_it) {
+      threads.emplace_back(FillChunks, t_it);
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+  }
+
+  // Pairwise reduction of the chunk histograms into the first.
+  for (size_t stride = 1; stride < NChunks; stride *= 2) {
+    for (size_t c_it = 0; (c_it + stride) < NChunks; c_it += 2 * stride) {
+      double *into = fChunkHists.data() + (c_it * NBins);
+      double const *from = fChunkHists.data() + ((c_it + stride) * NBins);
+      for (size_t b_it = 0; b_it < NBins; ++b_it) {
+        into[b_it] += from[b_it];
+      }
+      if (gradient) {
+        into = fChunkGrads.data() + (c_it * NBins * NParams);
+        from = fChunkGrads.data() + ((c_it + stride) * NBins * NParams);
+        for (size_t g_it = 0; g_it < (NBins * NParams); ++g_it) {
+          into[g_it] += from[g_it];
+        }
+      }
+    }
+  }
+  fPrediction.assign(fChunkHists.begin(), fChunkHists.begin() + NBins);
+
+  if (gradient) {
+    std::fill_n(gradient, NParams, 0);
+  }
+  double LLH = 0;
+  for (size_t b_it = 0; b_it < NBins; ++b_it) {
+    double mu = fPrediction[b_it];
+    double n = fData[b_it];
+    LLH += 2 * (mu - n);
+    double dLLHdmu = 2;
+    if (n > 0) {
+      if (!(mu > 0)) {
+        LLH = std::numeric_limits<double>::infinity();
+        continue;
+      }
+      LLH += 2 * n * std::log(n / mu);
+      dLLHdmu = 2 * (1 - (n / mu));
+    }
+    if (gradient) {
+      double const *dmu = fChunkGrads.data() + (b_it * NParams);
+      for (size_t p_it = 0; p_it < NParams; ++p_it) {
+        gradient[p_it] += dLLHdmu * dmu[p_it];
+      }
+    }
+  }
+
+  if (fConfig.UsePenalty) {
+    LLH += GetPenalty(x, gradient);
+  }
+  return LLH;
+}
+
+double BinnedLikelihood::GetPenalty(double const *x, double *gradient) const {
+  double penalty = 0;
+  for (size_t p_it = 0; p_it < fParams.size(); ++p_it) {
+    Param const &p = fParams[p_it];
+    if (!p.HasPenalty) {
+      continue;
+    }
+    double sigma = (x[p_it] < p.Central) ? p.SigmaLow : p.SigmaUp;
+    double pull = (x[p_it] - p.Central) / sigma;
+    penalty += pull * pull;
+    if (gradient) {
+      gradient[p_it] += 2 * pull / sigma;
+    }
+  }
+  return penalty;
+}
+
+MemoryBreakdown BinnedLikelihood::MemoryFootprint() const {
+  MemoryBreakdown mb;
+  mb.Add("coefficients", footprint::HeapBytes(fCoeffs));
+  size_t IndexBytes = footprint::HeapBytes(fEventBins) +
+                      footprint::HeapBytes(fEventWeights) +
+                      footprint::HeapBytes(fEntries) +
+                      footprint::HeapBytes(fEventEntryOffsets) +
+                      footprint::HeapBytes(fParams) +
+                      footprint::NodeBytes(fParamIndex);
+  for (Param const &p : fParams) {
+    IndexBytes += footprint::HeapBytes(p.Knots);
+  }
+  mb.Add("index", IndexBytes);
+  size_t BufferBytes = footprint::HeapBytes(fChunkHists) +
+                       footprint::HeapBytes(fChunkGrads) +
+                       footprint::HeapBytes(fThreadScratch) +
+                       footprint::HeapBytes(fPrediction);
+  for (auto const &s : fThreadScratch) {
+    BufferBytes += footprint::HeapBytes(s);
+  }
+  mb.Add("buffers", BufferBytes);
+  return mb;
+}
+
+} // namespace systtools
@@ -0,0 +1,218 @@
+#ifndef SYSTTOOLS_INTERPRETERS_BINNEDLIKELIHOOD_SEEN
+#define SYSTTOOLS_INTERPRETERS_BINNEDLIKELIHOOD_SEEN
+
+#include "systematicstools/interface/SystMetaData.hh"
+#include "systematicstools/interface/types.hh"
+
+#include "systematicstools/interpreters/ResponseModel.hh"
+#include "systematicstools/interpreters/SplineResponse.hh"
+
+#include "systematicstools/utility/MemoryFootprint.hh"
+#include "systematicstools/utility/exceptions.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when a BinnedLikelihood is constructed from
+/// inconsistent inputs.
+NEW_SYSTTOOLS_EXCEPT(invalid_binned_likelihood);
+
+///\brief -2lnL of a binned prediction, built by reweighting every event in an
+/// EventSplineCache, against a data histogram, plus a penalty for each
+/// parameter.
+///
+/// On construction, the coefficients of each cached weight response, which
+/// the cache has already built with the InterpolationScheme declared for its
+/// parameter, and of each cached polynomial response, are copied, and events
+/// are stored contiguously with their bin. Each evaluation then resolves the
+/// spline interval of every parameter once, and makes a single pass over the
+/// events.
+///
+/// The Poisson likelihood ratio,
+///
+///   -2lnL = 2 * sum_b (mu_b - n_b + n_b * ln(n_b / mu_b)),
+///
+/// is used, where a bin with no prediction and some data contributes
+/// +infinity. The penalty for parameter i at x_i is ((x_i - c_i)/s_i)^2, where
+/// c_i is the header centralParamValue, and s_i is the upper or, for x_i < c_i,
+/// the magnitude of the lower oneSigmaShifts. Parameters with either unset
+/// are not penalised.
+///
+/// Events are evaluated in fixed size chunks, spread over the worker threads,
+/// and the per-chunk histograms are summed pairwise in a fixed order. The
+/// result therefore does not depend on the number of threads, and repeated
+/// evaluations at the same point are bitwise identical.
+///
+/// Optionally, the gradient with respect to every parameter is computed in
+/// the same pass, from the analytic spline derivatives.
+///
+/// Each spline is evaluated at the requested value, and is extrapolated beyond
+/// its knots as TSpline3::Eval does. Parameter limits are left to the fitter.
+///
+///\note Not thread safe, Evaluate uses internal buffers, which are kept
+/// between calls so that, other than starting the worker threads, repeated
+/// evaluations do not allocate.
+class BinnedLikelihood {
+public:
+  struct Config {
+    ///\brief Worker threads, 0 uses the number of hardware threads.
+    size_t NThreads;
+    ///\brief Events per chunk. Changing this changes the summation order, and
+    /// so the least significant bits of the result.
+    size_t ChunkSize;
+    ///\brief Whether to add the header-derived parameter penalty.
+    bool UsePenalty;
+
+    Config() : NThreads(0), ChunkSize(1 << 16), UsePenalty(true) {}
+  };
+
+  ///\brief Builds the likelihood from every event in an EventSplineCache.
+  ///
+  /// event_bins[eid] is the data bin of cached event eid, events with a bin
+  /// outside of [0, data.size()) are ignored. params are the fitted
+  /// parameters, their order sets the order of the values passed to
+  /// Evaluate and of the gradient. Responses to other parameters are
+  /// ignored. If given, event_weights[eid] is the nominal weight of event eid.
+  ///
+  ///\note throws invalid_binned_likelihood if the inputs are inconsistent.
+  template <typename cache_t>
+  BinnedLikelihood(cache_t const &cache, std::vector<int> const &event_bins,
+                   std::vector<double> data, param_header_map_t const &headers,
+                   param_list_t const &params, Config const &cfg = Config(),
+                   std::vector<double> const &event_weights = {})
+      : BinnedLikelihood(std::move(data), headers, params, cfg) {
+    size_t NEvents = cache.GetNEventsInCache();
+    if (event_bins.size() != NEvents) {
+      throw invalid_binned_likelihood()
+          << "[ERROR]: Passed " << event_bins.size() << " event bins for "
+          << NEvents << " cached events.";
+    }
+    if (event_weights.size() && (event_weights.size() != NEvents)) {
+      throw invalid_binned_likelihood()
+          << "[ERROR]: Passed " << event_weights.size()
+          << " event weights for " << NEvents << " cached events.";
+    }
+    for (size_t eid = 0; eid < NEvents; ++eid) {
+      if ((event_bins[eid] < 0) || (size_t(event_bins[eid]) >= fData.size())) {
+        continue;
+      }
+      size_t NResponses = 0;
+      auto const *resps = cache.GetEventResponses(eid, NResponses);
+      for (size_t r_it = 0; r_it < NResponses; ++r_it) {
+        auto const &cp = cache.GetCachedParam(resps[r_it].slot);
+        if (cp.IsWeight) {
+          AddResponse(cp.pid, cp.Knots.get(),
+                      cache.GetResponseCoeffs(resps[r_it]), cp.PolyOrder);
+        }
+      }
+      AddEvent(event_bins[eid],
+               event_weights.size() ? event_weights[eid] : 1);
+    }
+  }
+
+  size_t GetNBins() const { return fData.size(); }
+  ///\brief The number of events that fall into a data bin.
+  size_t GetNEvents() const { return fEventBins.size(); }
+  param_list_t const &GetParameters() const { return fParamIds; }
+
+  ///\brief -2lnL, including any penalty, with the parameters set to x.
+  ///
+  ///\note x must hold a value for each of GetParameters().
+  double Evaluate(std::vector<double> const &x) {
+    return Evaluate(x.data(), nullptr);
+  }
+  ///\brief -2lnL, including any penalty, with the parameters set to x, and
+  /// its derivative with respect to each parameter in gradient.
+  double Evaluate(std::vector<double> const &x, std::vector<double> &gradient) {
+    gradient.resize(fParams.size());
+    return Evaluate(x.data(), gradient.data());
+  }
+  double Evaluate(double const *x, double *gradient);
+
+  ///\brief The predicted histogram from the last evaluation.
+  std::vector<double> const &GetPrediction() const { return fPrediction; }
+
+  ///\brief The penalty alone at x. If gradient, the derivatives of the
+  /// penalty are added to it.
+  double GetPenalty(double const *x, double *gradient = nullptr) const;
+
+  ///\brief The memory owned, reported as "coefficients" for the spline
+  /// coefficients, "index" for the per-event bins, weights, and entries, and
+  /// "buffers" for the per-chunk histograms.
+  MemoryBreakdown MemoryFootprint() const;
+
+private:
+  BinnedLikelihood(std::vector<double> data, param_header_map_t const &headers,
+                   param_list_t const &params, Config const &cfg);
+
+  ///\brief Adds the response of an event to parameter pid, if it is fitted:
+  /// if order is 0, kNSplineCoeffs spline coefficients per knot, otherwise
+  /// the order + 1 coefficients of a polynomial.
+  ///
+  ///\note throws invalid_binned_likelihood if the knots of a spline differ
+  /// from those of the header.
+  void AddResponse(paramId_t pid, std::vector<double> const &knots,
+                   double const *coeffs, size_t order);
+  ///\brief Adds an event in bin, with the responses added since the last
+  /// event.
+  void AddEvent(int bin, double weight);
+
+  ///\brief Fills the histogram, and if gradient, its derivatives, of chunk
+  /// c_it.
+  void FillChunk(size_t c_it, bool gradient, std::vector<double> &scratch);
+
+  struct Param {
+    SplineKnots Knots;
+    bool HasPenalty;
+    double Central;
+    double SigmaLow;
+    double SigmaUp;
+    bool DiffersEventByEvent;
+    ///\brief The offset, and polynomial order, of the shared coefficients of
+    /// a parameter that does not differ event by event.
+    size_t GlobalOffset;
+    uint32_t GlobalOrder;
+    ///\brief The value, and its spline interval and offset into it, resolved
+    /// per evaluation.
+    double x;
+    size_t knot;
+    double dx;
+  };
+  ///\brief A response, either spline coefficients, or if order is not 0,
+  /// the coefficients of a polynomial of that order.
+  struct Entry {
+    uint32_t param;
+    uint32_t order;
+    size_t offset;
+  };
+
+  Config fConfig;
+  std::vector<double> fData;
+  param_list_t fParamIds;
+  std::vector<Param> fParams;
+  std::map<paramId_t, uint32_t> fParamIndex;
+
+  std::vector<int> fEventBins;
+  std::vector<double> fEventWeights;
+  ///\brief The parameter responses of each event.
+  std::vector<Entry> fEntries;
+  std::vector<size_t> fEventEntryOffsets;
+  size_t fMaxEntriesPerEvent;
+  ///\brief Spline coefficients, kNSplineCoeffs per knot, or polynomial
+  /// coefficients, for every entry.
+  std::vector<double> fCoeffs;
+
+  ///\brief Per chunk histograms, and their derivatives, bin major.
+  std::vector<double> fChunkHists;
+  std::vector<double> fChunkGrads;
+  std::vector<std::vector<double>> fThreadScratch;
+  std::vector<double> fPrediction;
+};
+
+} // namespace systtools
+
+#endif
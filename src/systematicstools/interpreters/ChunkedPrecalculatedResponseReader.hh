@@ -0,0 +1,194 @@
+#ifndef SYSTTOOLS_INTERPRETERS_CHUNKEDPRECALCULATEDRESPONSEREADER_SEEN
+#define SYSTTOOLS_INTERPRETERS_CHUNKEDPRECALCULATEDRESPONSEREADER_SEEN
+
+#include "systematicstools/interface/types.hh"
+
+#include "systematicstools/interpreters/PrecalculatedResponseReader.hh"
+
+#include "systematicstools/utility/ParameterAndProviderConfigurationUtility.hh"
+#include "systematicstools/utility/exceptions.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Reads precalculated responses that were written as a number of
+/// entry-aligned trees, one per set of ISystProviderTools.
+///
+/// This allows the responses of a newly added ISystProviderTool to be written
+/// to a separate tree, or file, rather than rewriting all existing responses:
+///
+/// * Configure the new provider with
+/// GetNextFreeParamId(existing_headers) as the first parameter id.
+/// * Write its responses, one entry per event unit in the same order as the
+/// existing tree, with MakeProviderTreeWriter.
+/// * Read with one chunk for the existing tree and one for the new provider.
+///
+/// Each chunk covers the contiguous paramId_t range of its providers in the
+/// merged header map. Chunks are only read when a requested parameter falls
+/// within their range.
+template <size_t Order> class ChunkedPrecalculatedResponseReader {
+public:
+  NEW_SYSTTOOLS_EXCEPT(misaligned_chunk);
+  NEW_SYSTTOOLS_EXCEPT(overlapping_chunk);
+
+  typedef PrecalculatedResponseReader<Order> reader_t;
+  typedef std::vector<typename reader_t::ParamPolyResponses>
+      event_poly_response_t;
+
+private:
+  struct Chunk {
+    std::vector<std::string> ProviderFQNames;
+    paramId_t first;
+    paramId_t last;
+    std::unique_ptr<reader_t> reader;
+  };
+
+  param_header_map_t fHeaders;
+  std::vector<Chunk> fChunks;
+  size_t fNEntries = 0;
+
+  static void AppendResponses(event_poly_response_t &out,
+                              event_poly_response_t &&in) {
+    for (auto &ppr : in) {
+      out.push_back(std::move(ppr));
+    }
+  }
+
+public:
+  ///\brief headers must be the merged header map of all providers in all
+  /// chunks.
+  ChunkedPrecalculatedResponseReader(param_header_map_t headers)
+      : fHeaders(std::move(headers)) {}
+
+  ///\brief The conventional tree name for the responses of a single provider.
+  static std::string GetProviderTreeName(std::string const &ProviderFQName) {
+    return "responses_" + ProviderFQName;
+  }
+
+  ///\brief Instantiates a PrecalculatedResponseReader in write mode for the
+  /// responses of a single provider.
+  ///
+  ///\note One entry must be filled for every entry in the existing response
+  /// tree(s), including event units for which the provider has no response.
+  static std::unique_ptr<reader_t>
+  MakeProviderTreeWriter(
+      param_header_map_t const &headers, std::string const &ProviderFQName,
+      TTree *tree, ResponseEncoding encoding = ResponseEncoding::kDouble) {
+    return reader_t::MakeTreeWriter(
+        SelectProviderHeaders(headers, ProviderFQName), tree, encoding);
+  }
+
+  ///\brief Adds a chunk holding the responses of ProviderFQNames from tree
+  /// tree_name in file file_name.
+  ///
+  ///\note throws misaligned_chunk if the number of entries differs from
+  /// previously added chunks, and overlapping_chunk if the parameter range
+  /// overlaps that of a previously added chunk.
+  void AddChunk(std::string const &file_name, std::string const &tree_name,
+                std::vector<std::string> const &ProviderFQNames) {
+    Chunk chunk;
+    chunk.ProviderFQNames = ProviderFQNames;
+    size_t NHeaders = 0;
+    for (auto const &FQName : ProviderFQNames) {
+      param_header_map_t const &phdrs = SelectProviderHeaders(fHeaders, FQName);
+      if (!NHeaders) {
+        chunk.first = phdrs.begin()->first;
+        chunk.last = phdrs.rbegin()->first;
+      } else {
+        chunk.first = std::min(chunk.first, phdrs.begin()->first);
+        chunk.last = std::max(chunk.last, phdrs.rbegin()->first);
+      }
+      NHeaders += phdrs.size();
+    }
+    if (!NHeaders) {
+      throw incorrectly_configured()
+          << "[ERROR]: Attempted to add response chunk from tree "
+          << std::quoted(tree_name) << " in file " << std::quoted(file_name)
+          << " without naming any providers.";
+    }
+
+    for (auto const &c : fChunks) {
+      if ((chunk.first <= c.last) && (c.first <= chunk.last)) {
+        throw overlapping_chunk()
+            << "[ERROR]: Response chunk from tree " << std::quoted(tree_name)
+            << " in file " << std::quoted(file_name)
+            << " covers parameters [" << chunk.first << ", " << chunk.last
+            << "], which overlaps an existing chunk covering [" << c.first
+            << ", " << c.last << "].";
+      }
+    }
+
+    chunk.reader = std::make_unique<reader_t>(file_name, tree_name, NHeaders);
+    size_t NEntries = chunk.reader->GetEntries();
+    if (fChunks.size() && (NEntries != fNEntries)) {
+      throw misaligned_chunk()
+          << "[ERROR]: Response chunk from tree " << std::quoted(tree_name)
+          << " in file " << std::quoted(file_name) << " has " << NEntries
+          << " entries, but previously added chunks have " << fNEntries
+          << ".";
+    }
+    fNEntries = NEntries;
+
+    fChunks.insert(std::upper_bound(fChunks.begin(), fChunks.end(), chunk,
+                                    [](Chunk const &l, Chunk const &r) {
+                                      return l.first < r.first;
+                                    }),
+                   std::move(chunk));
+  }
+
+  ///\brief Adds a chunk for a single provider written to a tree named by
+  /// GetProviderTreeName.
+  void AddProviderChunk(std::string const &file_name,
+                        std::string const &ProviderFQName) {
+    AddChunk(file_name, GetProviderTreeName(ProviderFQName), {ProviderFQName});
+  }
+
+  size_t GetNChunks() const { return fChunks.size(); }
+  size_t GetEntries() const { return fNEntries; }
+  param_header_map_t const &GetHeaders() const { return fHeaders; }
+
+  ///\brief Gets the merged responses from all chunks for entry, ordered by
+  /// paramId_t range.
+  event_poly_response_t GetEventResponse(size_t entry) {
+    event_poly_response_t resps;
+    for (auto &c : fChunks) {
+      AppendResponses(resps, c.reader->GetEventResponse(entry));
+    }
+    return resps;
+  }
+
+  ///\brief Gets the responses to the parameters in pids for entry.
+  ///
+  /// Only chunks covering at least one requested parameter are read.
+  event_poly_response_t GetEventResponse(size_t entry,
+                                         param_list_t const &pids) {
+    event_poly_response_t resps;
+    for (auto &c : fChunks) {
+      bool needed = false;
+      for (paramId_t pid : pids) {
+        if ((pid >= c.first) && (pid <= c.last)) {
+          needed = true;
+          break;
+        }
+      }
+      if (!needed) {
+        continue;
+      }
+      for (auto &ppr : c.reader->GetEventResponse(entry)) {
+        if (std::find(pids.begin(), pids.end(), ppr.pid) != pids.end()) {
+          resps.push_back(std::move(ppr));
+        }
+      }
+    }
+    return resps;
+  }
+};
+
+} // namespace systtools
+
+#endif
@@ -1,41 +1,156 @@
 #ifndef SYSTTOOLS_INTERPRETERS_EVENTSPLINECACHEHELPER_SEEN
 #define SYSTTOOLS_INTERPRETERS_EVENTSPLINECACHEHELPER_SEEN
 
+#include "systematicstools/interpreters/InterpolationSchemes.hh"
 #include "systematicstools/interpreters/ParamHeaderHelper.hh"
 #include "systematicstools/interpreters/ParamValidationAndErrorResponse.hh"
+#include "systematicstools/interpreters/ResponseModel.hh"
+#include "systematicstools/interpreters/SplineResponse.hh"
 
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
 
 namespace systtools {
 typedef size_t eventId_t;
 
-template <typename event_unit_t> class EventSplineCacheBase {
+///\brief Common storage for EventSplineCache
+///
+/// The care level, CL, is fixed at compile time and is used for the checks
+/// made here and by the contained ParamHeaderHelperT.
+///
+/// Each parameter is resolved from its header once, when it is first cached:
+/// its knots, whether it is a weight response, its ResponseModel and its
+/// InterpolationScheme. The responses of each event are then interpolated
+/// once, with that scheme, into flat coefficients, kNSplineCoeffs per knot, as
+/// used by SplineResponse, or, for a polynomial ResponseModel, fitted with a
+/// polynomial of that order. Evaluation is then a knot search and a
+/// polynomial, with no virtual calls. Responses of parameters that do not
+/// differ event by event are stored once, and shared by every event.
+template <typename event_unit_t, ParamValidationAndErrorResponse::CareLevel CL>
+class EventSplineCacheBase {
+
+public:
+  typedef StaticParamHeaderHelper<CL> header_helper_t;
+  typedef std::map<paramId_t, double> param_value_map_t;
+  typedef typename header_helper_t::param_tspline_map_t param_tspline_map_t;
+
+  ///\brief A parameter with cached responses, as resolved from its header
+  /// when it was first cached.
+  struct CachedParam {
+    paramId_t pid;
+    ///\brief Whether responses to the parameter are cached: it has a header,
+    /// is a spline parameter, and is not responseless.
+    bool Usable;
+    bool IsWeight;
+    bool DiffersEventByEvent;
+    ///\brief The order of the polynomial fitted to the responses, if the
+    /// parameter declares a polynomial ResponseModel, otherwise 0, and they
+    /// are interpolated with Scheme.
+    size_t PolyOrder;
+    InterpolationScheme Scheme;
+    SplineKnots Knots;
+    ///\brief The offset of the coefficients shared by every event, for a
+    /// parameter that does not differ event by event, once they are built.
+    size_t GlobalOffset;
+  };
+  ///\brief The cached response of one parameter for one event, the
+  /// kNSplineCoeffs coefficients per knot, or PolyOrder + 1 polynomial
+  /// coefficients, of the parameter in slot start at GetResponseCoeffs.
+  struct CachedResponse {
+    uint32_t slot;
+    size_t offset;
+  };
 
 protected:
+  static constexpr size_t kNoOffset = std::numeric_limits<size_t>::max();
+
   param_value_map_t currentValues;
   param_list_t weightParams;
   param_list_t lateralParams;
-  std::vector<std::pair<event_unit_t,
-                        std::pair<ParamHeaderHelper::param_tspline_map_t,
-                                  ParamHeaderHelper::param_tspline_map_t>>>
-      fEvents;
-  ParamHeaderHelper fHeaderHelper;
+
+  std::vector<event_unit_t> fEvents;
+  ///\brief The parameters with cached responses, indexed by slot, in the
+  /// order that they were first cached.
+  std::vector<CachedParam> fCachedParams;
+  std::map<paramId_t, uint32_t> fParamSlots;
+  ///\brief The responses of each event, sorted by slot, those of event eid
+  /// are fResponses[fEventOffsets[eid] ... fEventOffsets[eid + 1]).
+  std::vector<CachedResponse> fResponses;
+  std::vector<size_t> fEventOffsets{0};
+  size_t fMaxResponsesPerEvent = 0;
+  std::vector<double> fCoeffs;
+  header_helper_t fHeaderHelper;
   ParamValidationAndErrorResponse fChkErr;
 
+  ///\brief The cached response of parameter i for event eid, or nullptr if
+  /// it does not affect the event.
+  CachedResponse const *FindResponse(paramId_t i, eventId_t eid) const {
+    auto slot_it = fParamSlots.find(i);
+    if (slot_it == fParamSlots.end()) {
+      return nullptr;
+    }
+    uint32_t slot = slot_it->second;
+    auto begin = fResponses.begin() + fEventOffsets[eid];
+    auto end = fResponses.begin() + fEventOffsets[eid + 1];
+    auto r_it = std::lower_bound(
+        begin, end, slot,
+        [](CachedResponse const &r, uint32_t s) { return r.slot < s; });
+    return ((r_it != end) && (r_it->slot == slot)) ? &(*r_it) : nullptr;
+  }
+
+  // Every InterpolationScheme is stored in the same layout, so is evaluated
+  // by EvalSplineCoeffs.
+  double EvalResponse(CachedResponse const &r, double v) const {
+    CachedParam const &cp = fCachedParams[r.slot];
+    if (cp.PolyOrder) {
+      return EvalPolyCoeffs(fCoeffs.data() + r.offset, cp.PolyOrder, v);
+    }
+    size_t k = cp.Knots.Find(v);
+    return EvalSplineCoeffs(fCoeffs.data() + r.offset, k, v - cp.Knots[k]);
+  }
+  double EvalResponseDerivative(CachedResponse const &r, double v) const {
+    CachedParam const &cp = fCachedParams[r.slot];
+    if (cp.PolyOrder) {
+      return EvalPolyCoeffsDerivative(fCoeffs.data() + r.offset, cp.PolyOrder,
+                                      v);
+    }
+    size_t k = cp.Knots.Find(v);
+    return EvalSplineCoeffsDerivative(fCoeffs.data() + r.offset, k,
+                                      v - cp.Knots[k]);
+  }
+
+  ///\brief The weight response of parameter i for cached event eid at v, 1 if
+  /// the parameter does not affect the event.
+  double EvalWeightResponse(paramId_t i, eventId_t eid, double v) const {
+    CachedResponse const *r = FindResponse(i, eid);
+    return (r && fCachedParams[r->slot].IsWeight) ? EvalResponse(*r, v) : 1;
+  }
+  ///\brief The lateral response of parameter i for cached event eid at v, 1
+  /// if the parameter does not affect the event.
+  double EvalLateralResponse(paramId_t i, eventId_t eid, double v) const {
+    CachedResponse const *r = FindResponse(i, eid);
+    return (r && !fCachedParams[r->slot].IsWeight) ? EvalResponse(*r, v) : 1;
+  }
+
 public:
   typedef std::vector<event_unit_t> event_t;
 
   EventSplineCacheBase(){};
-  EventSplineCacheBase(param_header_map_t headers)
+  EventSplineCacheBase(param_header_map_t const &headers)
       : fHeaderHelper(headers), fChkErr{} {}
   EventSplineCacheBase(param_header_map_t &&headers)
       : fHeaderHelper(std::move(headers)), fChkErr{} {}
 
+  ///\note Parameters are resolved from the headers when they are first
+  /// cached, so headers should be set before events are cached.
   void SetHeaders(param_header_map_t const &headers) {
-    fHeaderHelper = ParamHeaderHelper(headers);
+    fHeaderHelper = header_helper_t(headers, fChkErr);
   }
   void SetHeaders(param_header_map_t &&headers) {
-    fHeaderHelper = ParamHeaderHelper(std::move(headers));
+    fHeaderHelper = header_helper_t(std::move(headers), fChkErr);
   }
 
   void SetChkErr(ParamValidationAndErrorResponse const &ChkErr) {
@@ -45,37 +160,50 @@ public:
 
   ///\brief Take a copy of the event and build the internal splines from the
   /// supplied event information.
+  ///
+  /// Parameters whose header declares a polynomial ResponseModel are fitted
+  /// with a polynomial of that order, rather than splined. Responses to
+  /// parameters without a usable spline header, and, as there is nothing to
+  /// interpolate, spline responses with fewer responses than knots, are not
+  /// cached.
+  ///
+  ///\note throws invalid_interpolation_scheme or invalid_response_model if a
+  /// parameter declares an unknown scheme or model.
   eventId_t CacheEvent(event_unit_t const &eu,
                        event_unit_response_t const &eur) {
-    param_list_t parameters;
-    for (auto &pr : eur) {
-      parameters.push_back(pr.first);
-    }
-
     eventId_t id = fEvents.size();
 
-    std::cout << "[INFO]: Caching event " << id << std::endl;
-
-    for (auto &resp : eur) {
-      std::cout << "\tParam " << resp.first << " has " << resp.second.size()
-                << " responses. Is it known about by Event cache? "
-                << currentValues.count(resp.first) << ", by the header helper? "
-                << fHeaderHelper.HaveHeader(resp.first) << std::endl;
-    }
+    SYSTTOOLS_DIAG(kDebug, "CacheEvent", "Caching event " << id);
 
-    fEvents.emplace_back(
-        eu, std::pair<ParamHeaderHelper::param_tspline_map_t,
-                      ParamHeaderHelper::param_tspline_map_t>{{}, {}});
-    std::cout << "[INFO]: Getting splines for " << parameters.size()
-              << " parameters." << std::endl;
-    for (auto &&isp : fHeaderHelper.GetSplines(parameters, eur)) {
-      std::cout << "[INFO]: Adding spline for param " << isp.first << std::endl;
-      if (fHeaderHelper.IsWeightResponse(isp.first)) {
-        fEvents.back().second.first.emplace(isp.first, isp.second);
-      } else {
-        fEvents.back().second.second.emplace(isp.first, isp.second);
+    size_t first = fResponses.size();
+    for (auto &pr : eur) {
+      SYSTTOOLS_DIAG(kDebug, "CacheEvent",
+                     "\tParam " << pr.pid << " has " << pr.responses.size()
+                                << " responses. Is it known about by Event "
+                                   "cache? "
+                                << currentValues.count(pr.pid)
+                                << ", by the header helper? "
+                                << fHeaderHelper.HaveHeader(pr.pid));
+      uint32_t slot = GetParamSlot(pr.pid);
+      if (!fCachedParams[slot].Usable) {
+        if (CL <= ParamValidationAndErrorResponse::kFrog) {
+          ReportUncachedParam(pr.pid);
+        }
+        continue;
       }
+      CacheResponse(slot, pr);
     }
+
+    // Sorted by slot, so that the response to a parameter can be found by
+    // bisection.
+    std::sort(fResponses.begin() + first, fResponses.end(),
+              [](CachedResponse const &l, CachedResponse const &r) {
+                return l.slot < r.slot;
+              });
+    fEventOffsets.push_back(fResponses.size());
+    fMaxResponsesPerEvent =
+        std::max(fMaxResponsesPerEvent, fResponses.size() - first);
+    fEvents.push_back(eu);
     return id;
   }
   // ///\brief Take the supplied event and build the internal splines from the
@@ -120,24 +248,16 @@ public:
   //   }
   //   return id;
   // }
-
   std::vector<eventId_t> CacheEvents(event_t const &e,
                                      EventResponse const &er) {
     std::vector<eventId_t> rtn;
     size_t NToAdd = e.size();
     if (e.size() != er.size()) {
-      std::cout << "["
-                << ((fChkErr.fPedantry ==
-                     ParamValidationAndErrorResponse::kAnythingGoes)
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Attempting to cache events, but the number of events ("
-                << e.size()
-                << ") differs from the number of event responses passed ("
-                << er.size() << ")." << std::endl;
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "EventCountMismatch",
+                             "Attempting to cache events, but the number of "
+                             "events (" << e.size()
+                                 << ") differs from the number of event "
+                                    "responses passed (" << er.size() << ").");
       NToAdd = std::min(e.size(), er.size());
     }
     for (size_t i = 0; i < NToAdd; ++i) {
@@ -149,18 +269,11 @@ public:
     std::vector<eventId_t> rtn;
     size_t NToAdd = e.size();
     if (e.size() != er.size()) {
-      std::cout << "["
-                << ((fChkErr.fPedantry ==
-                     ParamValidationAndErrorResponse::kAnythingGoes)
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Attempting to cache events, but the number of events ("
-                << e.size()
-                << ") differs from the number of event responses passed ("
-                << er.size() << ")." << std::endl;
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "EventCountMismatch",
+                             "Attempting to cache events, but the number of "
+                             "events (" << e.size()
+                                 << ") differs from the number of event "
+                                    "responses passed (" << er.size() << ").");
       NToAdd = std::min(e.size(), er.size());
     }
     for (size_t i = 0; i < NToAdd; ++i) {
@@ -169,51 +282,87 @@ public:
     return rtn;
   }
 
-  size_t GetNEventsInCache() { return fEvents.size(); }
+  size_t GetNEventsInCache() const { return fEvents.size(); }
+
+  ///\brief The cached parameter in slot, see GetEventResponses.
+  CachedParam const &GetCachedParam(uint32_t slot) const {
+    return fCachedParams[slot];
+  }
+  ///\brief The NResponses cached responses of an event, sorted by slot.
+  CachedResponse const *GetEventResponses(eventId_t eid,
+                                          size_t &NResponses) const {
+    NResponses = fEventOffsets[eid + 1] - fEventOffsets[eid];
+    return fResponses.data() + fEventOffsets[eid];
+  }
+  ///\brief The coefficients of a cached response, kNSplineCoeffs per knot of
+  /// its parameter, built with its InterpolationScheme, or, if its PolyOrder
+  /// is not 0, the PolyOrder + 1 coefficients of a polynomial.
+  double const *GetResponseCoeffs(CachedResponse const &r) const {
+    return fCoeffs.data() + r.offset;
+  }
+
+  ///\brief The memory owned by the cache.
+  ///
+  /// Reported as "headers" and "maps" for the headers, "event units" for the
+  /// cached event units, "maps" and "parameters" for the cached parameters,
+  /// "splines" for the per event unit responses and their coefficients, and
+  /// "parameters" for the declared parameters and evaluation buffers.
+  ///
+  ///\note Memory owned by the cached event_unit_t instances is not included.
+  MemoryBreakdown MemoryFootprint() const {
+    MemoryBreakdown mb = fHeaderHelper.MemoryFootprint();
+    mb.Add("event units", footprint::HeapBytes(fEvents));
+
+    size_t KnotBytes = 0;
+    for (CachedParam const &cp : fCachedParams) {
+      KnotBytes += footprint::HeapBytes(cp.Knots);
+    }
+    mb.Add("maps", footprint::NodeBytes(fParamSlots));
+    mb.Add("splines", footprint::HeapBytes(fResponses) +
+                          footprint::HeapBytes(fEventOffsets) +
+                          footprint::HeapBytes(fCoeffs));
+
+    mb.Add("parameters",
+           footprint::HeapBytes(fCachedParams) + KnotBytes +
+               footprint::NodeBytes(currentValues) +
+               footprint::HeapBytes(weightParams) +
+               footprint::HeapBytes(lateralParams) +
+               footprint::HeapBytes(fSlotWeightIndex) +
+               footprint::HeapBytes(fGradValues) +
+               footprint::HeapBytes(fGradIsFlat) +
+               footprint::HeapBytes(fGradKnots) +
+               footprint::HeapBytes(fGradDx) +
+               footprint::HeapBytes(fGradResponses) +
+               footprint::HeapBytes(fGradDerivs) +
+               footprint::HeapBytes(fGradIndices) +
+               footprint::HeapBytes(fResponseScratch));
+    return mb;
+  }
 
   void DeclareUsingParameter(paramId_t i, double v = kDefaultDouble) {
-    if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+    if (CL <= ParamValidationAndErrorResponse::kFrog) {
       if (!fHeaderHelper.HaveHeader(i)) {
-        if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-          std::cout << "["
-                    << ((fChkErr.fPedantry ==
-                         ParamValidationAndErrorResponse::kNotOnMyWatch)
-                            ? "ERROR"
-                            : "WARN")
-                    << "]: Attempted to declare the use of parameter " << i
-                    << " but the header information has not been loaded."
-                    << std::endl;
-          if (fChkErr.fPedantry ==
-              ParamValidationAndErrorResponse::kNotOnMyWatch) {
-            throw;
-          }
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                               "Attempted to declare the use of parameter " << i
+                                   << " but the header information has not "
+                                      "been loaded.");
         // Can carry on here as it may be loaded later.
       }
       // Check if the use of this parameter has already been declared.
       if (currentValues.find(i) != currentValues.end()) {
-        if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-          std::cout << "["
-                    << ((fChkErr.fPedantry ==
-                         ParamValidationAndErrorResponse::kNotOnMyWatch)
-                            ? "ERROR"
-                            : "WARN")
-                    << "]: Attempted to declare the use of parameter " << i
-                    << " "
-                    << (fHeaderHelper.HaveHeader(i)
-                            ? fHeaderHelper.GetHeader(i).prettyName + " "
-                            : "")
-                    << "but it has already been declared." << std::endl;
-          if (fChkErr.fPedantry ==
-              ParamValidationAndErrorResponse::kNotOnMyWatch) {
-            throw;
-          }
-        }
+        SYSTTOOLS_CHECK_FAILED(
+            fChkErr, "ParameterRedeclared",
+            "Attempted to declare the use of parameter " << i << " "
+                << (fHeaderHelper.HaveHeader(i)
+                        ? fHeaderHelper.GetHeader(i).prettyName + " "
+                        : "")
+                << "but it has already been declared.");
       }
     }
     currentValues[i] = v;
     if (fHeaderHelper.IsWeightResponse(i)) {
       weightParams.push_back(i);
+      fSlotWeightIndexValid = false;
     } else {
       lateralParams.push_back(i);
     }
@@ -229,47 +378,33 @@ public:
     }
   }
   void SetParameterValue(paramId_t i, double v) {
-    if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+    if (CL <= ParamValidationAndErrorResponse::kFrog) {
       if (!fHeaderHelper.HaveHeader(i)) {
-        if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-          std::cout << "["
-                    << ((fChkErr.fPedantry ==
-                         ParamValidationAndErrorResponse::kNotOnMyWatch)
-                            ? "ERROR"
-                            : "WARN")
-                    << "]: Attempted to declare the use of parameter " << i
-                    << " but the header information has not been loaded."
-                    << std::endl;
-          if (fChkErr.fPedantry ==
-              ParamValidationAndErrorResponse::kNotOnMyWatch) {
-            throw;
-          }
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                               "Attempted to declare the use of parameter " << i
+                                   << " but the header information has not "
+                                      "been loaded.");
         // Can carry on here as it may be loaded later.
       }
       // Check if the use of this parameter has already been declared.
       if (currentValues.find(i) == currentValues.end()) {
-        if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-          std::cout << "["
-                    << ((fChkErr.fPedantry ==
-                         ParamValidationAndErrorResponse::kNotOnMyWatch)
-                            ? "ERROR"
-                            : "WARN")
-                    << "]: Attempted to set the value of parameter " << i << " "
-                    << (fHeaderHelper.HaveHeader(i)
-                            ? fHeaderHelper.GetHeader(i).prettyName + " "
-                            : "")
-                    << "but it has not been declared." << std::endl;
-          if (fChkErr.fPedantry ==
-              ParamValidationAndErrorResponse::kNotOnMyWatch) {
-            throw;
-          }
-        }
+        SYSTTOOLS_CHECK_FAILED(
+            fChkErr, "ParameterNotDeclared",
+            "Attempted to set the value of parameter " << i << " "
+                << (fHeaderHelper.HaveHeader(i)
+                        ? fHeaderHelper.GetHeader(i).prettyName + " "
+                        : "")
+                << "but it has not been declared.");
       }
     }
-    currentValues[i] = v;
+    // Parameters are only listed once, however many times they are set.
+    if (!currentValues.emplace(i, v).second) {
+      currentValues[i] = v;
+      return;
+    }
     if (fHeaderHelper.IsWeightResponse(i)) {
       weightParams.push_back(i);
+      fSlotWeightIndexValid = false;
     } else {
       lateralParams.push_back(i);
     }
@@ -286,22 +421,395 @@ public:
   }
 
   bool ParameterAffectsEventWeight(paramId_t i, eventId_t eid) {
-    return (fEvents[eid].second.first.find(i) !=
-            fEvents[eid].second.first.end());
+    CachedResponse const *r = FindResponse(i, eid);
+    return r && fCachedParams[r->slot].IsWeight;
   }
   bool ParameterAffectsEventLateral(paramId_t i, eventId_t eid) {
-    return (fEvents[eid].second.second.find(i) !=
-            fEvents[eid].second.second.end());
+    CachedResponse const *r = FindResponse(i, eid);
+    return r && !fCachedParams[r->slot].IsWeight;
+  }
+
+  event_unit_t const &GetEventUnit(eventId_t eid) { return fEvents[eid]; }
+
+  ///\brief The declared weight parameters, in the order used for the
+  /// gradients returned by GetTotalEventWeightsAndGradient.
+  param_list_t const &GetWeightParameters() const { return weightParams; }
+
+  ///\brief Gets the total weight of a cached event at the current parameter
+  /// values.
+  ///
+  /// The values, any limits, and the knot interval of each parameter are
+  /// resolved once, and then the responses of the event are evaluated in a
+  /// single pass. At the kTortoise care level, values outside of the
+  /// parameter limits are evaluated at the limit.
+  double GetTotalEventWeightResponse(eventId_t eid) {
+    if (!CheckEventCached(eid)) {
+      return ErrorWeight();
+    }
+    PrepareWeightValues();
+    return EvalTotalEventWeight(eid);
+  }
+
+  ///\brief Gets the weight response of parameter i, at v, for a cached
+  /// event, and sets dwdv to its derivative with respect to v.
+  ///
+  /// Parameters that do not affect the event have a response of 1 and a
+  /// derivative of 0. At the kTortoise care level, values outside of the
+  /// parameter limits are evaluated at the limit, with a derivative of 0.
+  double GetEventWeightResponseAndDerivative(paramId_t i, eventId_t eid,
+                                             double v, double &dwdv) {
+    dwdv = 0;
+    if (!CheckEventCached(eid)) {
+      return ErrorWeight();
+    }
+    bool Flat = false;
+    v = ClampToLimits(i, v, Flat);
+    CachedResponse const *r = FindResponse(i, eid);
+    if (!r || !fCachedParams[r->slot].IsWeight) {
+      return 1;
+    }
+    if (!Flat) {
+      dwdv = EvalResponseDerivative(*r, v);
+    }
+    return EvalResponse(*r, v);
+  }
+
+  ///\brief Gets the total weight of a cached event at the current parameter
+  /// values, and writes its derivative with respect to each of
+  /// GetWeightParameters() to gradient.
+  ///
+  ///\note gradient must have room for GetWeightParameters().size() entries.
+  double GetTotalEventWeightAndGradient(eventId_t eid, double *gradient) {
+    PrepareWeightValues();
+    return EvalTotalEventWeightAndGradient(eid, gradient);
   }
 
-  event_unit_t const &GetEventUnit(eventId_t eid) { return fEvents[eid].first; }
+  ///\brief Gets the total weights of a batch of cached events at the current
+  /// parameter values, along with their gradients.
+  ///
+  /// The derivative of the weight of eids[e] with respect to parameter
+  /// GetWeightParameters()[j] is written to gradients[e * NParams + j]. The
+  /// current parameter values, any limits, and knot intervals are resolved
+  /// once for the batch, after which each event is a single pass over its
+  /// responses: each response and derivative is evaluated once and the
+  /// products of the other responses are accumulated from both ends, so that
+  /// the full gradient costs about as much as the weight alone. The weights
+  /// are identical to GetTotalEventWeightResponse.
+  ///
+  /// weights and gradients are resized, but keep their capacity, so they can
+  /// be reused between calls without allocating.
+  void GetTotalEventWeightsAndGradient(std::vector<eventId_t> const &eids,
+                                       std::vector<double> &weights,
+                                       std::vector<double> &gradients) {
+    PrepareWeightValues();
+    size_t NParams = weightParams.size();
+    weights.resize(eids.size());
+    gradients.resize(eids.size() * NParams);
+    for (size_t e_it = 0; e_it < eids.size(); ++e_it) {
+      weights[e_it] = EvalTotalEventWeightAndGradient(
+          eids[e_it], gradients.data() + (e_it * NParams));
+    }
+  }
+
+private:
+  static constexpr size_t kNoWeightIndex = std::numeric_limits<size_t>::max();
+
+  ///\brief The index in weightParams of the parameter in each slot, or
+  /// kNoWeightIndex, rebuilt when parameters are declared or cached.
+  std::vector<size_t> fSlotWeightIndex;
+  bool fSlotWeightIndexValid = false;
+  ///\brief The current weight parameter values, after any limits are
+  /// applied, whether the response is flat at that value, and the knot
+  /// interval, and offset into it, of the value.
+  std::vector<double> fGradValues;
+  std::vector<char> fGradIsFlat;
+  std::vector<size_t> fGradKnots;
+  std::vector<double> fGradDx;
+  ///\brief The responses, derivatives, and weight parameter indices of the
+  /// event being evaluated.
+  std::vector<double> fGradResponses;
+  std::vector<double> fGradDerivs;
+  std::vector<size_t> fGradIndices;
+  std::vector<double> fResponseScratch;
+
+  ///\brief The slot of parameter pid, which is resolved from its header if
+  /// this is the first time that it has been cached.
+  uint32_t GetParamSlot(paramId_t pid) {
+    auto slot_it = fParamSlots.find(pid);
+    if (slot_it != fParamSlots.end()) {
+      return slot_it->second;
+    }
+    CachedParam cp;
+    cp.pid = pid;
+    cp.Usable = false;
+    cp.IsWeight = false;
+    cp.DiffersEventByEvent = true;
+    cp.PolyOrder = 0;
+    cp.Scheme = InterpolationScheme::kCubicSpline;
+    cp.GlobalOffset = kNoOffset;
+    if (fHeaderHelper.HaveHeader(pid) && fHeaderHelper.IsSplineParam(pid) &&
+        !fHeaderHelper.IsResponselessParam(pid)) {
+      SystParamHeader const &hdr = fHeaderHelper.GetHeader(pid);
+      cp.Usable = true;
+      cp.IsWeight = fHeaderHelper.IsWeightResponse(pid);
+      cp.DiffersEventByEvent = hdr.differsEventByEvent;
+      cp.PolyOrder = GetPolyOrder(GetResponseModel(hdr));
+      cp.Scheme = GetInterpolationScheme(hdr);
+      cp.Knots = hdr.paramVariations.get();
+    }
+    uint32_t slot = uint32_t(fCachedParams.size());
+    fCachedParams.push_back(std::move(cp));
+    fParamSlots.emplace(pid, slot);
+    fSlotWeightIndexValid = false;
+    return slot;
+  }
+
+  void ReportUncachedParam(paramId_t pid) {
+    if (!fHeaderHelper.HaveHeader(pid)) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                             "Requested header for parameter "
+                                 << pid
+                                 << ", but it is not currently configured.");
+    } else if (!fHeaderHelper.IsSplineParam(pid)) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested spline response for a list of "
+                             "parameters, but parameter "
+                                 << pid << ", "
+                                 << fHeaderHelper.GetHeader(pid).prettyName
+                                 << " is not a splineable systematic. ");
+    } else {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ResponselessParameter",
+                             "Requested response for a list of parameters, "
+                             "but parameter "
+                                 << pid << ", "
+                                 << fHeaderHelper.GetHeader(pid).prettyName
+                                 << " is a responseless parameter. ");
+    }
+  }
+
+  ///\brief Interpolates, or fits, and caches the responses pr, of the usable
+  /// parameter in slot.
+  void CacheResponse(uint32_t slot, ParamResponses const &pr) {
+    CachedParam &cp = fCachedParams[slot];
+    if (cp.GlobalOffset != kNoOffset) {
+      fResponses.push_back({slot, cp.GlobalOffset});
+      return;
+    }
+    std::vector<double> const &responses =
+        cp.DiffersEventByEvent ? pr.responses
+                               : fHeaderHelper.GetHeader(cp.pid).responses;
+    size_t NKnots = cp.Knots.size();
+    if (responses.size() != NKnots) {
+      if (CL == ParamValidationAndErrorResponse::kTortoise) {
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "ResponseCountMismatch",
+                               "Requested "
+                                   << (cp.PolyOrder ? "polynomial" : "spline")
+                                   << " for parameter " << cp.pid
+                                   << ", but the number of "
+                                   << "responses (" << responses.size()
+                                   << ") and knots (" << NKnots
+                                   << ") differ.");
+      }
+      // A polynomial is fitted to as many responses as there are, a spline
+      // needs one per knot.
+      if (cp.PolyOrder && responses.size()) {
+        NKnots = std::min(NKnots, responses.size());
+      } else if (!NKnots || (responses.size() < NKnots)) {
+        return;
+      }
+    }
+    double const *y = responses.data();
+    if (CL == ParamValidationAndErrorResponse::kTortoise) {
+      SystParamHeader const &hdr = fHeaderHelper.GetHeader(cp.pid);
+      fResponseScratch.assign(y, y + NKnots);
+      for (size_t r_it = 0; r_it < NKnots; ++r_it) {
+        fResponseScratch[r_it] =
+            fChkErr.CheckResponse(fResponseScratch[r_it], hdr, r_it);
+      }
+      y = fResponseScratch.data();
+    }
+    size_t offset = fCoeffs.size();
+    if (cp.PolyOrder) {
+      // Any coefficients beyond the order that the responses determine are
+      // 0, so every response is evaluated at PolyOrder.
+      fCoeffs.resize(offset + cp.PolyOrder + 1);
+      FitPolyCoeffs(cp.Knots.data(), y, NKnots, cp.PolyOrder,
+                    fCoeffs.data() + offset);
+    } else {
+      fCoeffs.resize(offset + (kNSplineCoeffs * NKnots));
+      BuildInterpolationCoeffs(cp.Scheme, cp.Knots.data(), y, NKnots,
+                               fCoeffs.data() + offset);
+    }
+    if (!cp.DiffersEventByEvent) {
+      cp.GlobalOffset = offset;
+    }
+    fResponses.push_back({slot, offset});
+  }
+
+  double ErrorWeight() const {
+    return (fChkErr.fErrorResponse ==
+            ParamValidationAndErrorResponse::kUnityWeight)
+               ? 1
+               : 0;
+  }
+
+  bool CheckEventCached(eventId_t eid) {
+    if ((CL <= ParamValidationAndErrorResponse::kFrog) &&
+        (fEvents.size() <= eid)) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "EventNotCached",
+                             "Requested event " << eid << ", but only have "
+                                 << fEvents.size() << " in the cache.");
+      return false;
+    }
+    return true;
+  }
+
+  double ClampToLimits(paramId_t i, double v, bool &Flat) {
+    Flat = false;
+    if (CL != ParamValidationAndErrorResponse::kTortoise) {
+      return v;
+    }
+    if (fHeaderHelper.HasParameterLowLimit(i) &&
+        (v < fHeaderHelper.GetParameterLowLimit(i))) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \""
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified lower bound at "
+                                 << fHeaderHelper.GetParameterLowLimit(i)
+                                 << ".");
+      Flat = true;
+      return fHeaderHelper.GetParameterLowLimit(i);
+    }
+    if (fHeaderHelper.HasParameterUpLimit(i) &&
+        (v > fHeaderHelper.GetParameterUpLimit(i))) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \""
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified upper bound at "
+                                 << fHeaderHelper.GetParameterUpLimit(i)
+                                 << ".");
+      Flat = true;
+      return fHeaderHelper.GetParameterUpLimit(i);
+    }
+    return v;
+  }
+
+  ///\brief Resolves the current value, and its knot interval, of every
+  /// weight parameter.
+  void PrepareWeightValues() {
+    size_t NParams = weightParams.size();
+    if (!fSlotWeightIndexValid) {
+      fSlotWeightIndex.assign(fCachedParams.size(), kNoWeightIndex);
+      for (size_t p_it = 0; p_it < NParams; ++p_it) {
+        auto slot_it = fParamSlots.find(weightParams[p_it]);
+        if ((slot_it != fParamSlots.end()) &&
+            fCachedParams[slot_it->second].IsWeight) {
+          fSlotWeightIndex[slot_it->second] = p_it;
+        }
+      }
+      fSlotWeightIndexValid = true;
+    }
+    fGradValues.resize(NParams);
+    fGradIsFlat.resize(NParams);
+    fGradKnots.resize(NParams);
+    fGradDx.resize(NParams);
+    for (size_t p_it = 0; p_it < NParams; ++p_it) {
+      bool Flat = false;
+      fGradValues[p_it] = ClampToLimits(
+          weightParams[p_it], currentValues[weightParams[p_it]], Flat);
+      fGradIsFlat[p_it] = Flat;
+      fGradKnots[p_it] = 0;
+      fGradDx[p_it] = 0;
+    }
+    for (size_t s_it = 0; s_it < fSlotWeightIndex.size(); ++s_it) {
+      size_t p_it = fSlotWeightIndex[s_it];
+      if (p_it == kNoWeightIndex) {
+        continue;
+      }
+      if (fCachedParams[s_it].PolyOrder) {
+        continue;
+      }
+      SplineKnots const &knots = fCachedParams[s_it].Knots;
+      fGradKnots[p_it] = knots.Find(fGradValues[p_it]);
+      fGradDx[p_it] = fGradValues[p_it] - knots[fGradKnots[p_it]];
+    }
+    size_t NMax = fMaxResponsesPerEvent + NParams;
+    fGradResponses.resize(NMax);
+    fGradDerivs.resize(NMax);
+    fGradIndices.resize(NMax);
+  }
+
+  double EvalTotalEventWeight(eventId_t eid) const {
+    double weight = 1;
+    for (size_t r_it = fEventOffsets[eid]; r_it < fEventOffsets[eid + 1];
+         ++r_it) {
+      CachedResponse const &r = fResponses[r_it];
+      size_t p_it = fSlotWeightIndex[r.slot];
+      if (p_it == kNoWeightIndex) {
+        continue;
+      }
+      double const *coeffs = fCoeffs.data() + r.offset;
+      size_t order = fCachedParams[r.slot].PolyOrder;
+      weight *= order ? EvalPolyCoeffs(coeffs, order, fGradValues[p_it])
+                      : EvalSplineCoeffs(coeffs, fGradKnots[p_it],
+                                         fGradDx[p_it]);
+    }
+    return weight;
+  }
+
+  double EvalTotalEventWeightAndGradient(eventId_t eid, double *gradient) {
+    size_t NParams = weightParams.size();
+    std::fill_n(gradient, NParams, 0);
+    if (!CheckEventCached(eid)) {
+      return ErrorWeight();
+    }
+    // fGradDerivs[n] first holds the derivative of response n times the
+    // product of the responses before it, and then the product of those
+    // after it.
+    double weight = 1;
+    size_t NResps = 0;
+    auto AddResponse = [&](size_t p_it, double resp, double deriv) {
+      fGradResponses[NResps] = resp;
+      fGradDerivs[NResps] = fGradIsFlat[p_it] ? 0 : (weight * deriv);
+      fGradIndices[NResps] = p_it;
+      weight *= resp;
+      ++NResps;
+    };
+    for (size_t r_it = fEventOffsets[eid]; r_it < fEventOffsets[eid + 1];
+         ++r_it) {
+      CachedResponse const &r = fResponses[r_it];
+      size_t p_it = fSlotWeightIndex[r.slot];
+      if (p_it == kNoWeightIndex) {
+        continue;
+      }
+      double const *coeffs = fCoeffs.data() + r.offset;
+      size_t order = fCachedParams[r.slot].PolyOrder;
+      if (order) {
+        AddResponse(p_it, EvalPolyCoeffs(coeffs, order, fGradValues[p_it]),
+                    EvalPolyCoeffsDerivative(coeffs, order, fGradValues[p_it]));
+      } else {
+        AddResponse(p_it,
+                    EvalSplineCoeffs(coeffs, fGradKnots[p_it], fGradDx[p_it]),
+                    EvalSplineCoeffsDerivative(coeffs, fGradKnots[p_it],
+                                               fGradDx[p_it]));
+      }
+    }
+    double after = 1;
+    for (size_t n_it = NResps; n_it-- > 0;) {
+      gradient[fGradIndices[n_it]] += fGradDerivs[n_it] * after;
+      after *= fGradResponses[n_it];
+    }
+    return weight;
+  }
 };
 
 template <typename event_unit_t,
           ParamValidationAndErrorResponse::CareLevel CLtight =
               ParamValidationAndErrorResponse::kFrog,
           typename Enable = void>
-class EventSplineCache : public EventSplineCacheBase<event_unit_t> {};
+class EventSplineCache : public EventSplineCacheBase<event_unit_t, CLtight> {};
 
 template <typename event_unit_t,
           ParamValidationAndErrorResponse::CareLevel CLtight>
@@ -309,41 +817,34 @@ class EventSplineCache<
     event_unit_t, CLtight,
     typename std::enable_if<CLtight == ParamValidationAndErrorResponse::kHare,
                             void>::type>
-    : public EventSplineCacheBase<event_unit_t> {
+    : public EventSplineCacheBase<event_unit_t, CLtight> {
 
-  using EventSplineCacheBase<event_unit_t>::currentValues;
-  using EventSplineCacheBase<event_unit_t>::weightParams;
-  using EventSplineCacheBase<event_unit_t>::lateralParams;
-  using EventSplineCacheBase<event_unit_t>::fEvents;
-  using EventSplineCacheBase<event_unit_t>::fHeaderHelper;
-  using EventSplineCacheBase<event_unit_t>::fChkErr;
+  typedef EventSplineCacheBase<event_unit_t, CLtight> base_t;
 
-  using EventSplineCacheBase<event_unit_t>::KnowAboutParameter;
-  using EventSplineCacheBase<event_unit_t>::ParameterAffectsEventWeight;
-  using EventSplineCacheBase<event_unit_t>::ParameterAffectsEventLateral;
+  using base_t::currentValues;
+  using base_t::weightParams;
+  using base_t::lateralParams;
+  using base_t::fEvents;
+  using base_t::fHeaderHelper;
+  using base_t::fChkErr;
+
+  using base_t::KnowAboutParameter;
+  using base_t::ParameterAffectsEventWeight;
+  using base_t::ParameterAffectsEventLateral;
+  using base_t::EvalWeightResponse;
+  using base_t::EvalLateralResponse;
 
 public:
   double GetEventWeightResponse(paramId_t i, eventId_t eid, double v) {
-    return ParameterAffectsEventWeight(i, eid)
-               ? fEvents[eid].second.first[i].Eval(v)
-               : 1;
+    return EvalWeightResponse(i, eid, v);
   }
 
   double GetEventWeightResponse(paramId_t i, eventId_t eid) {
     return GetEventWeightResponse(i, eid, currentValues[i]);
   }
 
-  double GetTotalEventWeightResponse(eventId_t eid) {
-    double weight = 1;
-    for (auto &i : weightParams) {
-      GetEventWeightResponse(i, eid, currentValues[i]);
-    }
-    return weight;
-  }
   double GetEventLateralResponse(paramId_t i, eventId_t eid, double v) {
-    return ParameterAffectsEventLateral(i, eid)
-               ? fEvents[eid].second.second[i].Eval(v)
-               : 1;
+    return EvalLateralResponse(i, eid, v);
   }
   double GetEventLateralResponse(paramId_t i, eventId_t eid) {
     return GetEventLateralResponse(i, eid, currentValues[i]);
@@ -356,146 +857,103 @@ class EventSplineCache<
     event_unit_t, CLtight,
     typename std::enable_if<CLtight == ParamValidationAndErrorResponse::kFrog,
                             void>::type>
-    : public EventSplineCacheBase<event_unit_t> {
+    : public EventSplineCacheBase<event_unit_t, CLtight> {
+
+  typedef EventSplineCacheBase<event_unit_t, CLtight> base_t;
 
-  using EventSplineCacheBase<event_unit_t>::currentValues;
-  using EventSplineCacheBase<event_unit_t>::weightParams;
-  using EventSplineCacheBase<event_unit_t>::lateralParams;
-  using EventSplineCacheBase<event_unit_t>::fEvents;
-  using EventSplineCacheBase<event_unit_t>::fHeaderHelper;
-  using EventSplineCacheBase<event_unit_t>::fChkErr;
+  using base_t::currentValues;
+  using base_t::weightParams;
+  using base_t::lateralParams;
+  using base_t::fEvents;
+  using base_t::fHeaderHelper;
+  using base_t::fChkErr;
 
-  using EventSplineCacheBase<event_unit_t>::KnowAboutParameter;
-  using EventSplineCacheBase<event_unit_t>::ParameterAffectsEventWeight;
-  using EventSplineCacheBase<event_unit_t>::ParameterAffectsEventLateral;
+  using base_t::KnowAboutParameter;
+  using base_t::ParameterAffectsEventWeight;
+  using base_t::ParameterAffectsEventLateral;
+  using base_t::EvalWeightResponse;
+  using base_t::EvalLateralResponse;
 
 public:
   double GetEventWeightResponse(paramId_t i, eventId_t eid, double v) {
-    if (fEvents.size() < eid) {
-      std::cout << "["
-                << (fChkErr.fPedantry ==
-                            ParamValidationAndErrorResponse::kNotOnMyWatch
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Requested event " << eid << ", but only have "
-                << fEvents.size() << " in the cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+    if (fEvents.size() <= eid) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "EventNotCached",
+                             "Requested event " << eid << ", but only have "
+                                 << fEvents.size() << " in the cache.");
       return ((fChkErr.fErrorResponse ==
                ParamValidationAndErrorResponse::kUnityWeight)
                   ? 1
                   : 0);
     }
     if (!KnowAboutParameter(i)) {
-      std::cout << "["
-                << (fChkErr.fPedantry ==
-                            ParamValidationAndErrorResponse::kNotOnMyWatch
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterNotDeclared",
+                             "Requested event weight response for parameter "
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << ", but it has not been declared to the "
+                                    "Cache.");
 
       if (!fHeaderHelper.HaveHeader(i)) {
-        std::cout << "["
-                  << (fChkErr.fPedantry ==
-                              ParamValidationAndErrorResponse::kNotOnMyWatch
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested event weight response for parameter "
-                  << fHeaderHelper.GetHeader(i).prettyName
-                  << ", but it is not understood by the currently loaded "
-                     "parameter headers.."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                               "Requested event weight response for parameter "
+                                   << fHeaderHelper.GetHeader(i).prettyName
+                                   << ", but it is not understood by the "
+                                      "currently loaded parameter headers..");
         return ((fChkErr.fErrorResponse ==
                  ParamValidationAndErrorResponse::kUnityWeight)
                     ? 1
                     : 0);
       }
     }
-    return ParameterAffectsEventWeight(i, eid)
-               ? fEvents[eid].second.first[i].Eval(v)
-               : 1;
+    return EvalWeightResponse(i, eid, v);
   }
 
   double GetEventWeightResponse(paramId_t i, eventId_t eid) {
     if (!KnowAboutParameter(i)) {
-      std::cout << "[ERROR]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      throw;
+      throw failed_parameter_check()
+          << "[ERROR]: Requested event weight response for parameter "
+          << fHeaderHelper.GetHeader(i).prettyName
+          << ", but it has not been declared to the Cache.";
     }
     return GetEventWeightResponse(i, eid, currentValues[i]);
   }
 
-  double GetTotalEventWeightResponse(eventId_t eid) {
-    double weight = 1;
-    for (auto &i : weightParams) {
-      GetEventWeightResponse(i, eid, currentValues[i]);
-    }
-    return weight;
-  }
   double GetEventLateralResponse(paramId_t i, eventId_t eid, double v) {
-    if (fEvents.size() < eid) {
-      std::cout << "[ERROR]: Requested event " << eid << ", but only have "
-                << fEvents.size() << " in the cache." << std::endl;
+    if (fEvents.size() <= eid) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "EventNotCached",
+                             "Requested event " << eid << ", but only have "
+                                 << fEvents.size() << " in the cache.");
       return ((fChkErr.fErrorResponse ==
                ParamValidationAndErrorResponse::kUnityWeight)
                   ? 1
                   : 0);
     }
     if (!KnowAboutParameter(i)) {
-      std::cout << "["
-                << (fChkErr.fPedantry ==
-                            ParamValidationAndErrorResponse::kNotOnMyWatch
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterNotDeclared",
+                             "Requested event weight response for parameter "
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << ", but it has not been declared to the "
+                                    "Cache.");
 
       if (!fHeaderHelper.HaveHeader(i)) {
-        std::cout << "["
-                  << (fChkErr.fPedantry ==
-                              ParamValidationAndErrorResponse::kNotOnMyWatch
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested event weight response for parameter "
-                  << fHeaderHelper.GetHeader(i).prettyName
-                  << ", but it is not understood by the currently loaded "
-                     "parameter headers.."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                               "Requested event weight response for parameter "
+                                   << fHeaderHelper.GetHeader(i).prettyName
+                                   << ", but it is not understood by the "
+                                      "currently loaded parameter headers..");
         return ((fChkErr.fErrorResponse ==
                  ParamValidationAndErrorResponse::kUnityWeight)
                     ? 1
                     : 0);
       }
     }
-    return ParameterAffectsEventLateral(i, eid)
-               ? fEvents[eid].second.second[i].Eval(v)
-               : 1;
+    return EvalLateralResponse(i, eid, v);
   }
   double GetEventLateralResponse(paramId_t i, eventId_t eid) {
     if (!KnowAboutParameter(i)) {
-      std::cout << "[ERROR]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      throw;
+      throw failed_parameter_check()
+          << "[ERROR]: Requested event weight response for parameter "
+          << fHeaderHelper.GetHeader(i).prettyName
+          << ", but it has not been declared to the Cache.";
     }
     return GetEventLateralResponse(i, eid, currentValues[i]);
   }
@@ -507,64 +965,46 @@ class EventSplineCache<
     event_unit_t, CLtight,
     typename std::enable_if<
         CLtight == ParamValidationAndErrorResponse::kTortoise, void>::type>
-    : public EventSplineCacheBase<event_unit_t> {
+    : public EventSplineCacheBase<event_unit_t, CLtight> {
+
+  typedef EventSplineCacheBase<event_unit_t, CLtight> base_t;
 
-  using EventSplineCacheBase<event_unit_t>::currentValues;
-  using EventSplineCacheBase<event_unit_t>::weightParams;
-  using EventSplineCacheBase<event_unit_t>::lateralParams;
-  using EventSplineCacheBase<event_unit_t>::fEvents;
-  using EventSplineCacheBase<event_unit_t>::fHeaderHelper;
-  using EventSplineCacheBase<event_unit_t>::fChkErr;
+  using base_t::currentValues;
+  using base_t::weightParams;
+  using base_t::lateralParams;
+  using base_t::fEvents;
+  using base_t::fHeaderHelper;
+  using base_t::fChkErr;
 
-  using EventSplineCacheBase<event_unit_t>::KnowAboutParameter;
-  using EventSplineCacheBase<event_unit_t>::ParameterAffectsEventWeight;
-  using EventSplineCacheBase<event_unit_t>::ParameterAffectsEventLateral;
+  using base_t::KnowAboutParameter;
+  using base_t::ParameterAffectsEventWeight;
+  using base_t::ParameterAffectsEventLateral;
+  using base_t::EvalWeightResponse;
+  using base_t::EvalLateralResponse;
 
 public:
   double GetEventWeightResponse(paramId_t i, eventId_t eid, double v) {
-    if (fEvents.size() < eid) {
-      std::cout << "["
-                << (fChkErr.fPedantry ==
-                            ParamValidationAndErrorResponse::kNotOnMyWatch
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Requested event " << eid << ", but only have "
-                << fEvents.size() << " in the cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+    if (fEvents.size() <= eid) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "EventNotCached",
+                             "Requested event " << eid << ", but only have "
+                                 << fEvents.size() << " in the cache.");
       return ((fChkErr.fErrorResponse ==
                ParamValidationAndErrorResponse::kUnityWeight)
                   ? 1
                   : 0);
     }
     if (!KnowAboutParameter(i)) {
-      std::cout << "["
-                << (fChkErr.fPedantry ==
-                            ParamValidationAndErrorResponse::kNotOnMyWatch
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterNotDeclared",
+                             "Requested event weight response for parameter "
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << ", but it has not been declared to the "
+                                    "Cache.");
       if (!fHeaderHelper.HaveHeader(i)) {
-        std::cout << "["
-                  << (fChkErr.fPedantry ==
-                              ParamValidationAndErrorResponse::kNotOnMyWatch
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested event weight response for parameter "
-                  << fHeaderHelper.GetHeader(i).prettyName
-                  << ", but it is not understood by the currently loaded "
-                     "parameter headers.."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                               "Requested event weight response for parameter "
+                                   << fHeaderHelper.GetHeader(i).prettyName
+                                   << ", but it is not understood by the "
+                                      "currently loaded parameter headers..");
         return ((fChkErr.fErrorResponse ==
                  ParamValidationAndErrorResponse::kUnityWeight)
                     ? 1
@@ -574,58 +1014,39 @@ public:
 
     if (fHeaderHelper.HasParameterLowLimit(i) &&
         (v < fHeaderHelper.GetParameterLowLimit(i))) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Parameter \"" << fHeaderHelper.GetHeader(i).prettyName
-                  << "\", evaluated at " << v
-                  << ", but specified lower bound at "
-                  << fHeaderHelper.GetParameterLowLimit(i) << "." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \""
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified lower bound at "
+                                 << fHeaderHelper.GetParameterLowLimit(i)
+                                 << ".");
 
       v = fHeaderHelper.GetParameterLowLimit(i);
     }
     if (fHeaderHelper.HasParameterUpLimit(i) &&
         (v > fHeaderHelper.GetParameterUpLimit(i))) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Parameter \"" << fHeaderHelper.GetHeader(i).prettyName
-                  << "\", evaluated at " << v
-                  << ", but specified upper bound at "
-                  << fHeaderHelper.GetParameterUpLimit(i) << "." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \""
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified upper bound at "
+                                 << fHeaderHelper.GetParameterUpLimit(i)
+                                 << ".");
 
       v = fHeaderHelper.GetParameterUpLimit(i);
     }
 
-    return ParameterAffectsEventWeight(i, eid)
-               ? fEvents[eid].second.first[i].Eval(v)
-               : 1;
+    return EvalWeightResponse(i, eid, v);
   }
 
   double GetEventWeightResponse(paramId_t i, eventId_t eid) {
     if (!KnowAboutParameter(i)) {
-      std::cout << "[ERROR]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterNotDeclared",
+                             "Requested event weight response for parameter "
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << ", but it has not been declared to the "
+                                    "Cache.");
       return ((fChkErr.fErrorResponse ==
                ParamValidationAndErrorResponse::kUnityWeight)
                   ? 1
@@ -634,57 +1055,28 @@ public:
     return GetEventWeightResponse(i, eid, currentValues[i]);
   }
 
-  double GetTotalEventWeightResponse(eventId_t eid) {
-    double weight = 1;
-    for (auto &i : weightParams) {
-      GetEventWeightResponse(i, eid, currentValues[i]);
-    }
-    return weight;
-  }
   double GetEventLateralResponse(paramId_t i, eventId_t eid, double v) {
-    if (fEvents.size() < eid) {
-      std::cout << "["
-                << (fChkErr.fPedantry ==
-                            ParamValidationAndErrorResponse::kNotOnMyWatch
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Requested event " << eid << ", but only have "
-                << fEvents.size() << " in the cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+    if (fEvents.size() <= eid) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "EventNotCached",
+                             "Requested event " << eid << ", but only have "
+                                 << fEvents.size() << " in the cache.");
       return ((fChkErr.fErrorResponse ==
                ParamValidationAndErrorResponse::kUnityWeight)
                   ? 1
                   : 0);
     }
     if (!KnowAboutParameter(i)) {
-      std::cout << "["
-                << (fChkErr.fPedantry ==
-                            ParamValidationAndErrorResponse::kNotOnMyWatch
-                        ? "ERROR"
-                        : "WARN")
-                << "]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterNotDeclared",
+                             "Requested event weight response for parameter "
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << ", but it has not been declared to the "
+                                    "Cache.");
       if (!fHeaderHelper.HaveHeader(i)) {
-        std::cout << "["
-                  << (fChkErr.fPedantry ==
-                              ParamValidationAndErrorResponse::kNotOnMyWatch
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested event weight response for parameter "
-                  << fHeaderHelper.GetHeader(i).prettyName
-                  << ", but it is not understood by the currently loaded "
-                     "parameter headers.."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                               "Requested event weight response for parameter "
+                                   << fHeaderHelper.GetHeader(i).prettyName
+                                   << ", but it is not understood by the "
+                                      "currently loaded parameter headers..");
         return ((fChkErr.fErrorResponse ==
                  ParamValidationAndErrorResponse::kUnityWeight)
                     ? 1
@@ -694,57 +1086,38 @@ public:
 
     if (fHeaderHelper.HasParameterLowLimit(i) &&
         (v < fHeaderHelper.GetParameterLowLimit(i))) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Parameter \"" << fHeaderHelper.GetHeader(i).prettyName
-                  << "\", evaluated at " << v
-                  << ", but specified lower bound at "
-                  << fHeaderHelper.GetParameterLowLimit(i) << "." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \""
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified lower bound at "
+                                 << fHeaderHelper.GetParameterLowLimit(i)
+                                 << ".");
 
       v = fHeaderHelper.GetParameterLowLimit(i);
     }
     if (fHeaderHelper.HasParameterUpLimit(i) &&
         (v > fHeaderHelper.GetParameterUpLimit(i))) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Parameter \"" << fHeaderHelper.GetHeader(i).prettyName
-                  << "\", evaluated at " << v
-                  << ", but specified upper bound at "
-                  << fHeaderHelper.GetParameterUpLimit(i) << "." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \""
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified upper bound at "
+                                 << fHeaderHelper.GetParameterUpLimit(i)
+                                 << ".");
 
       v = fHeaderHelper.GetParameterUpLimit(i);
     }
 
-    return ParameterAffectsEventLateral(i, eid)
-               ? fEvents[eid].second.second[i].Eval(v)
-               : 1;
+    return EvalLateralResponse(i, eid, v);
   }
   double GetEventLateralResponse(paramId_t i, eventId_t eid) {
     if (!KnowAboutParameter(i)) {
-      std::cout << "[ERROR]: Requested event weight response for parameter "
-                << fHeaderHelper.GetHeader(i).prettyName
-                << ", but it has not been declared to the Cache." << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterNotDeclared",
+                             "Requested event weight response for parameter "
+                                 << fHeaderHelper.GetHeader(i).prettyName
+                                 << ", but it has not been declared to the "
+                                    "Cache.");
       return ((fChkErr.fErrorResponse ==
                ParamValidationAndErrorResponse::kUnityWeight)
                   ? 1
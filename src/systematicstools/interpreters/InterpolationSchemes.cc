@@ -0,0 +1,48 @@
+#include "systematicstools/interpreters/InterpolationSchemes.hh"
+
+#include <iomanip>
+
+namespace systtools {
+
+std::string to_str(InterpolationScheme scheme) {
+  switch (scheme) {
+  case InterpolationScheme::kCubicSpline: {
+    return "cubic";
+  }
+  case InterpolationScheme::kLinear: {
+    return "linear";
+  }
+  case InterpolationScheme::kMonotoneCubic: {
+    return "monotone";
+  }
+  case InterpolationScheme::kAkima: {
+    return "akima";
+  }
+  }
+  return "unknown";
+}
+
+InterpolationScheme GetInterpolationScheme(SystParamHeader const &hdr) {
+  std::string_view schemestr;
+  if (!hdr.opts.FindKV(kInterpolationOptKey, schemestr) ||
+      (schemestr == "cubic")) {
+    return InterpolationScheme::kCubicSpline;
+  } else if (schemestr == "linear") {
+    return InterpolationScheme::kLinear;
+  } else if (schemestr == "monotone") {
+    return InterpolationScheme::kMonotoneCubic;
+  } else if (schemestr == "akima") {
+    return InterpolationScheme::kAkima;
+  }
+  throw invalid_interpolation_scheme()
+      << "[ERROR]: SystParamHeader(" << hdr.systParamId << ":"
+      << std::quoted(hdr.prettyName) << ") declares unknown "
+      << kInterpolationOptKey << ": " << std::quoted(schemestr)
+      << ", expected one of cubic, linear, monotone, or akima.";
+}
+
+void SetInterpolationScheme(SystParamHeader &hdr, InterpolationScheme scheme) {
+  hdr.opts.SetKV(kInterpolationOptKey, to_str(scheme));
+}
+
+} // namespace systtools
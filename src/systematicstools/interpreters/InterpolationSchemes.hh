@@ -0,0 +1,302 @@
+#ifndef SYSTTOOLS_INTERPRETERS_INTERPOLATIONSCHEMES_SEEN
+#define SYSTTOOLS_INTERPRETERS_INTERPOLATIONSCHEMES_SEEN
+
+#include "systematicstools/interface/SystParamHeader.hh"
+
+#include "systematicstools/interpreters/SplineResponse.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when a header declares an unknown interpolation
+/// scheme.
+NEW_SYSTTOOLS_EXCEPT(invalid_interpolation_scheme);
+
+///\brief How the responses at a spline parameter's knots are interpolated.
+///
+/// * kCubicSpline: The not-a-knot cubic spline of TSpline3, the default.
+/// * kLinear: Straight lines between knots, the cheapest, and never
+/// overshoots.
+/// * kMonotoneCubic: The Fritsch-Carlson monotone cubic, which does not
+/// overshoot where the responses are monotonic.
+/// * kAkima: The Akima cubic, which is robust to single outlying responses.
+///
+/// All are piecewise cubic, and are stored with kNSplineCoeffs coefficients
+/// per knot, as built by BuildSplineCoeffs, so they can be evaluated by the
+/// same code, or held in a TSpline3.
+enum class InterpolationScheme {
+  kCubicSpline,
+  kLinear,
+  kMonotoneCubic,
+  kAkima
+};
+
+/// SystParamHeader::opts key used to declare an InterpolationScheme
+/// (cubic/linear/monotone/akima).
+constexpr char const *kInterpolationOptKey = "Interpolation";
+
+std::string to_str(InterpolationScheme);
+
+///\brief Gets the interpolation scheme declared for a parameter, kCubicSpline
+/// if none is declared.
+///
+///\note throws invalid_interpolation_scheme for unknown schemes.
+InterpolationScheme GetInterpolationScheme(SystParamHeader const &hdr);
+
+///\brief Declares the interpolation scheme of a parameter.
+void SetInterpolationScheme(SystParamHeader &hdr, InterpolationScheme);
+
+///\brief Writes the cubic coefficients of each interval, given the values and
+/// slopes, in the B coefficients, at each knot.
+inline void HermiteSplineCoeffs(double const *x, size_t n, double *coeffs) {
+  double *cf = coeffs;
+  for (size_t i = 0; (i + 1) < n; ++i) {
+    double h = x[i + 1] - x[i];
+    double delta = (cf[kNSplineCoeffs * (i + 1)] - cf[kNSplineCoeffs * i]) / h;
+    double m0 = cf[(kNSplineCoeffs * i) + 1];
+    double m1 = cf[(kNSplineCoeffs * (i + 1)) + 1];
+    cf[(kNSplineCoeffs * i) + 2] = ((3 * delta) - (2 * m0) - m1) / h;
+    cf[(kNSplineCoeffs * i) + 3] = (m0 + m1 - (2 * delta)) / (h * h);
+  }
+  if (n) {
+    cf[(kNSplineCoeffs * (n - 1)) + 2] = 0;
+    cf[(kNSplineCoeffs * (n - 1)) + 3] = 0;
+  }
+}
+
+///\brief Interpolation scheme policies.
+///
+/// Each provides:
+///
+/// * kScheme: The InterpolationScheme.
+/// * Build(x, y, n, coeffs): Writes kNSplineCoeffs coefficients per knot for
+/// the n points (x, y), as BuildSplineCoeffs does.
+/// * Eval(coeffs, k, dx) and Derivative(coeffs, k, dx): Evaluate interval k,
+/// at distance dx from knot k.
+///
+/// Templates over a policy, such as InterpolatedResponse, compile to an
+/// inlined loop for that scheme. DispatchInterpolationScheme selects the
+/// policy for a runtime InterpolationScheme, once, outside of any such loop.
+struct CubicSplineInterpolation {
+  static constexpr InterpolationScheme kScheme =
+      InterpolationScheme::kCubicSpline;
+  static void Build(double const *x, double const *y, size_t n,
+                    double *coeffs) {
+    BuildSplineCoeffs(x, y, n, coeffs);
+  }
+  static double Eval(double const *coeffs, size_t k, double dx) {
+    return EvalSplineCoeffs(coeffs, k, dx);
+  }
+  static double Derivative(double const *coeffs, size_t k, double dx) {
+    return EvalSplineCoeffsDerivative(coeffs, k, dx);
+  }
+};
+
+struct LinearInterpolation {
+  static constexpr InterpolationScheme kScheme = InterpolationScheme::kLinear;
+  static void Build(double const *x, double const *y, size_t n,
+                    double *coeffs) {
+    for (size_t i = 0; i < n; ++i) {
+      double *p = coeffs + (kNSplineCoeffs * i);
+      p[0] = y[i];
+      p[1] = ((i + 1) < n) ? ((y[i + 1] - y[i]) / (x[i + 1] - x[i]))
+                           : (i ? coeffs[(kNSplineCoeffs * (i - 1)) + 1] : 0);
+      p[2] = 0;
+      p[3] = 0;
+    }
+  }
+  static double Eval(double const *coeffs, size_t k, double dx) {
+    double const *p = coeffs + (kNSplineCoeffs * k);
+    return p[0] + (dx * p[1]);
+  }
+  static double Derivative(double const *coeffs, size_t k, double) {
+    return coeffs[(kNSplineCoeffs * k) + 1];
+  }
+};
+
+///\brief Fritsch and Carlson, SIAM J. Numer. Anal. 17 (1980) 238.
+///
+/// Knot slopes start as the mean of the adjacent secants, or zero at a local
+/// extremum, and are then limited so that each interval is monotonic.
+struct MonotoneCubicInterpolation {
+  static constexpr InterpolationScheme kScheme =
+      InterpolationScheme::kMonotoneCubic;
+  static void Build(double const *x, double const *y, size_t n,
+                    double *coeffs) {
+    if (n < 3) {
+      LinearInterpolation::Build(x, y, n, coeffs);
+      return;
+    }
+    auto M = [coeffs](size_t i) -> double & {
+      return coeffs[(kNSplineCoeffs * i) + 1];
+    };
+    auto Delta = [x, y](size_t i) {
+      return (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+    };
+    for (size_t i = 0; i < n; ++i) {
+      coeffs[kNSplineCoeffs * i] = y[i];
+    }
+    M(0) = Delta(0);
+    M(n - 1) = Delta(n - 2);
+    for (size_t i = 1; (i + 1) < n; ++i) {
+      double dl = Delta(i - 1), dr = Delta(i);
+      M(i) = ((dl * dr) > 0) ? ((dl + dr) / 2) : 0;
+    }
+    for (size_t i = 0; (i + 1) < n; ++i) {
+      double delta = Delta(i);
+      if (delta == 0) {
+        M(i) = 0;
+        M(i + 1) = 0;
+        continue;
+      }
+      double alpha = M(i) / delta, beta = M(i + 1) / delta;
+      double r2 = (alpha * alpha) + (beta * beta);
+      if (r2 > 9) {
+        double tau = 3 / std::sqrt(r2);
+        M(i) = tau * alpha * delta;
+        M(i + 1) = tau * beta * delta;
+      }
+    }
+    HermiteSplineCoeffs(x, n, coeffs);
+  }
+  static double Eval(double const *coeffs, size_t k, double dx) {
+    return EvalSplineCoeffs(coeffs, k, dx);
+  }
+  static double Derivative(double const *coeffs, size_t k, double dx) {
+    return EvalSplineCoeffsDerivative(coeffs, k, dx);
+  }
+};
+
+///\brief Akima, J. ACM 17 (1970) 589.
+///
+/// Knot slopes are weighted means of the adjacent secants, weighted by the
+/// change in the secants on the far side, with two extrapolated secants at
+/// each end.
+struct AkimaInterpolation {
+  static constexpr InterpolationScheme kScheme = InterpolationScheme::kAkima;
+  static void Build(double const *x, double const *y, size_t n,
+                    double *coeffs) {
+    if (n < 3) {
+      LinearInterpolation::Build(x, y, n, coeffs);
+      return;
+    }
+    // The secant of interval j, for j = -2 ... n, those beyond the ends are
+    // extrapolated linearly. Only the four around each knot are needed, so
+    // they are kept in a rolling window rather than allocated.
+    auto Secant = [x, y](size_t j) {
+      return (y[j + 1] - y[j]) / (x[j + 1] - x[j]);
+    };
+    double sm1 = (2 * Secant(0)) - Secant(1);
+    double sn1 = (2 * Secant(n - 2)) - Secant(n - 3);
+    auto M = [&](ptrdiff_t j) {
+      if (j == -2) {
+        return (2 * sm1) - Secant(0);
+      } else if (j == -1) {
+        return sm1;
+      } else if (j == ptrdiff_t(n - 1)) {
+        return sn1;
+      } else if (j == ptrdiff_t(n)) {
+        return (2 * sn1) - Secant(n - 2);
+      }
+      return Secant(size_t(j));
+    };
+    double m[4] = {M(-2), M(-1), M(0), M(1)};
+    for (size_t i = 0; i < n; ++i) {
+      double *p = coeffs + (kNSplineCoeffs * i);
+      p[0] = y[i];
+      double wl = std::fabs(m[3] - m[2]);
+      double wr = std::fabs(m[1] - m[0]);
+      p[1] = ((wl + wr) > 0) ? (((wl * m[1]) + (wr * m[2])) / (wl + wr))
+                             : ((m[1] + m[2]) / 2);
+      if ((i + 1) < n) {
+        m[0] = m[1];
+        m[1] = m[2];
+        m[2] = m[3];
+        m[3] = M(ptrdiff_t(i) + 2);
+      }
+    }
+    HermiteSplineCoeffs(x, n, coeffs);
+  }
+  static double Eval(double const *coeffs, size_t k, double dx) {
+    return EvalSplineCoeffs(coeffs, k, dx);
+  }
+  static double Derivative(double const *coeffs, size_t k, double dx) {
+    return EvalSplineCoeffsDerivative(coeffs, k, dx);
+  }
+};
+
+///\brief Calls f with a default constructed policy for scheme, so that f is
+/// instantiated once per scheme.
+template <typename F>
+decltype(auto) DispatchInterpolationScheme(InterpolationScheme scheme,
+                                           F &&f) {
+  switch (scheme) {
+  case InterpolationScheme::kLinear:
+    return f(LinearInterpolation());
+  case InterpolationScheme::kMonotoneCubic:
+    return f(MonotoneCubicInterpolation());
+  case InterpolationScheme::kAkima:
+    return f(AkimaInterpolation());
+  case InterpolationScheme::kCubicSpline:
+  default:
+    return f(CubicSplineInterpolation());
+  }
+}
+
+///\brief Builds the coefficients of the n points (x, y) for a runtime
+/// selected scheme.
+inline void BuildInterpolationCoeffs(InterpolationScheme scheme,
+                                     double const *x, double const *y,
+                                     size_t n, double *coeffs) {
+  DispatchInterpolationScheme(scheme, [&](auto policy) {
+    decltype(policy)::Build(x, y, n, coeffs);
+  });
+}
+
+///\brief ROOT-free response function for a compile-time interpolation scheme.
+///
+/// InterpolatedResponse<CubicSplineInterpolation> is equivalent to
+/// SplineResponse.
+template <typename Scheme> class InterpolatedResponse {
+  SplineKnots fKnots;
+  std::vector<double> fCoeffs;
+
+public:
+  typedef Scheme scheme_t;
+
+  InterpolatedResponse() {}
+  InterpolatedResponse(std::vector<double> const &knots,
+                       std::vector<double> const &responses)
+      : fKnots(knots), fCoeffs(kNSplineCoeffs * knots.size()) {
+    Scheme::Build(fKnots.data(), responses.data(), fKnots.size(),
+                  fCoeffs.data());
+  }
+
+  size_t GetNKnots() const { return fKnots.size(); }
+  std::vector<double> const &GetKnots() const { return fKnots.get(); }
+  std::vector<double> const &GetCoeffs() const { return fCoeffs; }
+
+  double Eval(double v) const {
+    if (fKnots.empty()) {
+      return 0;
+    }
+    size_t k = fKnots.Find(v);
+    return Scheme::Eval(fCoeffs.data(), k, v - fKnots[k]);
+  }
+  double Derivative(double v) const {
+    if (fKnots.empty()) {
+      return 0;
+    }
+    size_t k = fKnots.Find(v);
+    return Scheme::Derivative(fCoeffs.data(), k, v - fKnots[k]);
+  }
+};
+
+} // namespace systtools
+
+#endif
@@ -1,39 +1,42 @@
 #include "systematicstools/interpreters/ParamHeaderHelper.hh"
 
+#include "systematicstools/interpreters/InterpolationSchemes.hh"
+
 #include "systematicstools/utility/printers.hh"
 
-#include <iostream>
+#include <sstream>
 #include <utility>
 
 namespace systtools {
 
-// #define DEBUG_PARAMHEADERHELPER
+namespace {
+std::string DescribeEventUnitParams(event_unit_response_t const &eur) {
+  std::stringstream ss;
+  for (auto &ivs : eur) {
+    ss << (&ivs == &eur.front() ? "" : ", ") << ivs.pid;
+  }
+  return ss.str();
+}
+} // namespace
 
-SystParamHeader ParamHeaderHelper::nullheader = SystParamHeader();
+template <typename VP>
+SystParamHeader ParamHeaderHelperT<VP>::nullheader = SystParamHeader();
 
-SystParamHeader const &ParamHeaderHelper::GetHeader(paramId_t i) const {
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+template <typename VP>
+SystParamHeader const &ParamHeaderHelperT<VP>::GetHeader(paramId_t i) const {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!HaveHeader(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << i
-                  << ", but it is not currently configured." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                             "Requested header for parameter " << i
+                                 << ", but it is not currently configured.");
       return nullheader;
     }
   }
   return fHeaders.at(i).Header;
 }
 
-bool ParamHeaderHelper::HaveHeader(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::HaveHeader(paramId_t i) const {
   auto const &h_it = fHeaders.find(i);
   if (h_it == fHeaders.end()) {
     return false;
@@ -41,32 +44,25 @@ bool ParamHeaderHelper::HaveHeader(paramId_t i) const {
   return true;
 }
 
+template <typename VP>
 SystParamHeader const &
-ParamHeaderHelper::GetHeader(std::string const &name) const {
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+ParamHeaderHelperT<VP>::GetHeader(std::string const &name) const {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!HaveHeader(name)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter named, " << name
-                  << ", but it is not currently configured." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                             "Requested header for parameter named, " << name
+                                 << ", but it is not currently configured.");
       return nullheader;
     }
   }
   return fHeaders.at(GetHeaderId(name)).Header;
 }
-bool ParamHeaderHelper::HaveHeader(std::string const &name) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::HaveHeader(std::string const &name) const {
   return (GetHeaderId(name) != kParamUnhandled<paramId_t>);
 }
-paramId_t ParamHeaderHelper::GetHeaderId(std::string const &name) const {
+template <typename VP>
+paramId_t ParamHeaderHelperT<VP>::GetHeaderId(std::string const &name) const {
   for (auto hdr_it : fHeaders) {
     if (hdr_it.second.Header.prettyName == name) {
       return hdr_it.second.Header.systParamId;
@@ -75,7 +71,8 @@ paramId_t ParamHeaderHelper::GetHeaderId(std::string const &name) const {
   return kParamUnhandled<paramId_t>;
 }
 
-param_list_t ParamHeaderHelper::GetParameters() const {
+template <typename VP>
+param_list_t ParamHeaderHelperT<VP>::GetParameters() const {
   param_list_t paramIds;
   for (auto const &hdr_it : fHeaders) {
     paramIds.push_back(hdr_it.second.Header.systParamId);
@@ -83,184 +80,128 @@ param_list_t ParamHeaderHelper::GetParameters() const {
   return paramIds;
 }
 
-bool ParamHeaderHelper::IsThrownParam(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::IsThrownParam(paramId_t i) const {
   return GetHeader(i).isRandomlyThrown;
 }
 
-bool ParamHeaderHelper::IsResponselessParam(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::IsResponselessParam(paramId_t i) const {
   return GetHeader(i).isResponselessParam;
 }
-paramId_t ParamHeaderHelper::GetResponseParamId(paramId_t i) const {
+template <typename VP>
+paramId_t ParamHeaderHelperT<VP>::GetResponseParamId(paramId_t i) const {
   SystParamHeader const &hdr = GetHeader(i);
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!IsResponselessParam(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested response parameter Id for parameter " << i
-                  << ", but it is not a responseless parameter." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(
+          fChkErr, "NotResponselessParameter",
+          "Requested response parameter Id for parameter " << i
+              << ", but it is not a responseless parameter.");
       return kParamUnhandled<paramId_t>;
     }
   }
   return hdr.responseParamId;
 }
 
-bool ParamHeaderHelper::IsSplineParam(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::IsSplineParam(paramId_t i) const {
   return GetHeader(i).isSplineable;
 }
 
-bool ParamHeaderHelper::ValuesAreInNaturalUnits(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::ValuesAreInNaturalUnits(paramId_t i) const {
   return GetHeader(i).unitsAreNatural;
 }
 
-bool ParamHeaderHelper::IsWeightResponse(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::IsWeightResponse(paramId_t i) const {
   return GetHeader(i).isWeightSystematicVariation;
 }
 
-bool ParamHeaderHelper::HasParameterLimits(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::HasParameterLimits(paramId_t i) const {
   return HasParameterLowLimit(i) || HasParameterUpLimit(i);
 }
-bool ParamHeaderHelper::HasParameterLowLimit(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::HasParameterLowLimit(paramId_t i) const {
   SystParamHeader const &hdr = GetHeader(i);
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!IsSplineParam(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested parameter range lower limit for parameter "
-                  << i << ", but it is not a splineable parameter."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested parameter range lower limit for "
+                             "parameter " << i
+                                 << ", but it is not a splineable parameter.");
       return false;
     }
   }
   return hdr.paramValidityRange[0] != kDefaultDouble;
 }
-bool ParamHeaderHelper::HasParameterUpLimit(paramId_t i) const {
+template <typename VP>
+bool ParamHeaderHelperT<VP>::HasParameterUpLimit(paramId_t i) const {
   SystParamHeader const &hdr = GetHeader(i);
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!IsSplineParam(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested parameter range upper limit for parameter "
-                  << i << ", but it is not a splineable parameter."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested parameter range upper limit for "
+                             "parameter " << i
+                                 << ", but it is not a splineable parameter.");
       return false;
     }
   }
   return hdr.paramValidityRange[1] != kDefaultDouble;
 }
-double ParamHeaderHelper::GetParameterLowLimit(paramId_t i) const {
+template <typename VP>
+double ParamHeaderHelperT<VP>::GetParameterLowLimit(paramId_t i) const {
   SystParamHeader const &hdr = GetHeader(i);
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!HasParameterLowLimit(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested parameter range lower limit for parameter "
-                  << i << ", but it is not a splineable parameter."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested parameter range lower limit for "
+                             "parameter " << i
+                                 << ", but it is not a splineable parameter.");
       return kDefaultDouble;
     }
   }
   return hdr.paramValidityRange[0];
 }
-double ParamHeaderHelper::GetParameterUpLimit(paramId_t i) const {
+template <typename VP>
+double ParamHeaderHelperT<VP>::GetParameterUpLimit(paramId_t i) const {
   SystParamHeader const &hdr = GetHeader(i);
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!HasParameterUpLimit(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested parameter range upper limit for parameter "
-                  << i << ", but it is not a splineable parameter."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested parameter range upper limit for "
+                             "parameter " << i
+                                 << ", but it is not a splineable parameter.");
       return kDefaultDouble;
     }
   }
   return hdr.paramValidityRange[1];
 }
 
+template <typename VP>
 param_value_list_t
-ParamHeaderHelper::CheckParamValueList(param_value_list_t ivlist) const {
+ParamHeaderHelperT<VP>::CheckParamValueList(param_value_list_t ivlist) const {
   for (param_value_list_t::iterator iv_it = ivlist.begin();
        iv_it != ivlist.end();) {
     if (!HaveHeader(iv_it->pid)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << iv_it->pid
-                  << ", but it is not currently configured." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                             "Requested header for parameter " << iv_it->pid
+                                 << ", but it is not currently configured.");
       iv_it = ivlist.erase(iv_it);
       continue;
     }
-    if (fChkErr.fCare == ParamValidationAndErrorResponse::kTortoise) {
+    if (Care() == ParamValidationAndErrorResponse::kTortoise) {
       // If not too fussed about using default behavior, remove the offending
       // parameter.
       if (!IsWeightResponse(iv_it->pid)) {
-        if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-          std::cout << "["
-                    << ((fChkErr.fPedantry ==
-                         ParamValidationAndErrorResponse::kNotOnMyWatch)
-                            ? "ERROR"
-                            : "WARN")
-                    << "]: Requested total response for a map of "
-                       "parameter-value pairs, but parameter "
-                    << iv_it->pid << ", " << GetHeader(iv_it->pid).prettyName
-                    << " is not a weight systematic. " << std::endl;
-          if (fChkErr.fPedantry ==
-              ParamValidationAndErrorResponse::kNotOnMyWatch) {
-            throw;
-          }
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "NotWeightParameter",
+                               "Requested total response for a map of "
+                               "parameter-value pairs, but parameter "
+                                   << iv_it->pid << ", "
+                                   << GetHeader(iv_it->pid).prettyName
+                                   << " is not a weight systematic. ");
         iv_it = ivlist.erase(iv_it);
         continue;
       }
@@ -268,21 +209,11 @@ ParamHeaderHelper::CheckParamValueList(param_value_list_t ivlist) const {
     // If not too fussed about using default behavior, remove the offending
     // parameter.
     if (!IsSplineParam(iv_it->pid)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested response for a map of "
-                     "parameter-value pairs, but parameter "
-                  << iv_it->pid << ", " << GetHeader(iv_it->pid).prettyName
-                  << " is not a splineable parameter. " << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested response for a map of parameter-value "
+                             "pairs, but parameter " << iv_it->pid << ", "
+                                 << GetHeader(iv_it->pid).prettyName
+                                 << " is not a splineable parameter. ");
       iv_it = ivlist.erase(iv_it);
       continue;
     }
@@ -290,46 +221,27 @@ ParamHeaderHelper::CheckParamValueList(param_value_list_t ivlist) const {
   }
   return ivlist;
 }
+template <typename VP>
 param_list_t
-ParamHeaderHelper::CheckParamList(param_list_t ilist, bool ExpectSpline,
+ParamHeaderHelperT<VP>::CheckParamList(param_list_t ilist, bool ExpectSpline,
                                   bool RequireWeightResponse) const {
   for (param_list_t::iterator i_it = ilist.begin(); i_it != ilist.end();) {
     if (!HaveHeader(*i_it)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << (*i_it)
-                  << ", but it is not currently configured." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                             "Requested header for parameter " << (*i_it)
+                                 << ", but it is not currently configured.");
       i_it = ilist.erase(i_it);
       continue;
     }
-    if (fChkErr.fCare == ParamValidationAndErrorResponse::kTortoise) {
+    if (Care() == ParamValidationAndErrorResponse::kTortoise) {
       // If not too fussed about using default behavior, remove the offending
       // parameter.
       if (RequireWeightResponse && !IsWeightResponse(*i_it)) {
-        if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-          std::cout << "["
-                    << ((fChkErr.fPedantry ==
-                         ParamValidationAndErrorResponse::kNotOnMyWatch)
-                            ? "ERROR"
-                            : "WARN")
-                    << "]: Requested total response for a list of parameters, "
-                       "but parameter "
-                    << *i_it << ", " << GetHeader(*i_it).prettyName
-                    << " is not a weight systematic. " << std::endl;
-          if (fChkErr.fPedantry ==
-              ParamValidationAndErrorResponse::kNotOnMyWatch) {
-            throw;
-          }
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "NotWeightParameter",
+                               "Requested total response for a list of "
+                               "parameters, but parameter " << *i_it << ", "
+                                   << GetHeader(*i_it).prettyName
+                                   << " is not a weight systematic. ");
         i_it = ilist.erase(i_it);
         continue;
       }
@@ -337,42 +249,22 @@ ParamHeaderHelper::CheckParamList(param_list_t ilist, bool ExpectSpline,
     // If not too fussed about using default behavior, remove the offending
     // parameter.
     if (ExpectSpline && !IsSplineParam(*i_it)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested spline response for a list of parameters, "
-                     "but parameter "
-                  << *i_it << ", " << GetHeader(*i_it).prettyName
-                  << " is not a splineable systematic. " << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested spline response for a list of "
+                             "parameters, but parameter " << *i_it << ", "
+                                 << GetHeader(*i_it).prettyName
+                                 << " is not a splineable systematic. ");
       i_it = ilist.erase(i_it);
       continue;
     }
     // If not too fussed about using default behavior, remove the offending
     // parameter.
     if (IsResponselessParam(*i_it)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested response for a list of parameters, "
-                     "but parameter "
-                  << *i_it << ", " << GetHeader(*i_it).prettyName
-                  << " is a responseless parameter. " << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ResponselessParameter",
+                             "Requested response for a list of parameters, but "
+                             "parameter " << *i_it << ", "
+                                 << GetHeader(*i_it).prettyName
+                                 << " is a responseless parameter. ");
       i_it = ilist.erase(i_it);
       continue;
     }
@@ -381,54 +273,34 @@ ParamHeaderHelper::CheckParamList(param_list_t ilist, bool ExpectSpline,
   return ilist;
 }
 
-TSpline3 ParamHeaderHelper::GetSpline(paramId_t i,
+template <typename VP>
+TSpline3 ParamHeaderHelperT<VP>::GetSpline(paramId_t i,
                                       spline_t const &event_responses,
                                       SystParamHeader const &hdr) const {
 
   // Check if the response header suggests that this is a spline-type parameter.
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!IsSplineParam(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested spline for parameter " << i
-                  << ", but it is not a splineable parameter." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "NotSplineParameter",
+                             "Requested spline for parameter " << i
+                                 << ", but it is not a splineable parameter.");
       return TSpline3();
     }
   }
 
   // Slow, inefficient checks
-  if (fChkErr.fCare == ParamValidationAndErrorResponse::kTortoise) {
+  if (Care() == ParamValidationAndErrorResponse::kTortoise) {
     scratch_spline_t1 =
         hdr.differsEventByEvent ? event_responses : hdr.responses;
     size_t NResponses = scratch_spline_t1.size();
 
     // Check if the number of responses found is the same as the number of knots
     if ((NResponses != hdr.paramVariations.size())) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested spline for parameter " << i
-                  << ", but the "
-                     "number of responses ("
-                  << NResponses << ") and knots (" << hdr.paramVariations.size()
-                  << ") differ." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ResponseCountMismatch",
+                             "Requested spline for parameter " << i
+                                 << ", but the number of responses ("
+                                 << NResponses << ") and knots ("
+                                 << hdr.paramVariations.size() << ") differ.");
       NResponses = std::min(NResponses, hdr.paramVariations.size());
     }
 
@@ -441,44 +313,74 @@ TSpline3 ParamHeaderHelper::GetSpline(paramId_t i,
 
     scratch_spline_t2 = hdr.paramVariations;
     /// No TSpline3 constructor that takes const arrays...
-    return TSpline3("", scratch_spline_t2.data(), scratch_spline_t1.data(),
-                    NResponses);
+    TSpline3 spl("", scratch_spline_t2.data(), scratch_spline_t1.data(),
+                 NResponses);
+    ApplyInterpolationScheme(spl, i, NResponses);
+    return spl;
   }
 
   scratch_spline_t2 = hdr.paramVariations;
   scratch_spline_t1 = hdr.differsEventByEvent ? event_responses : hdr.responses;
 
-#ifdef DEBUG_PARAMHEADERHELPER
-  std::cout << "[INFO]: Building spline for parameter " << hdr.systParamId
-            << ", " << hdr.prettyName << " from " << scratch_spline_t2.size()
-            << ", shift values and " << scratch_spline_t1.size()
-            << " responses (isGlobal ? " << !hdr.differsEventByEvent << ")."
-            << std::endl;
-#endif
+  SYSTTOOLS_DIAG(kDebug, "BuildSpline",
+                 "Building spline for parameter "
+                     << hdr.systParamId << ", " << hdr.prettyName << " from "
+                     << scratch_spline_t2.size() << ", shift values and "
+                     << scratch_spline_t1.size() << " responses (isGlobal ? "
+                     << !hdr.differsEventByEvent << ").");
 
-  return TSpline3("", scratch_spline_t2.data(), scratch_spline_t1.data(),
-                  scratch_spline_t2.size());
+  TSpline3 spl("", scratch_spline_t2.data(), scratch_spline_t1.data(),
+               scratch_spline_t2.size());
+  ApplyInterpolationScheme(spl, i, scratch_spline_t2.size());
+  return spl;
 }
-TSpline3 ParamHeaderHelper::GetSpline(paramId_t i,
+
+template <typename VP>
+void ParamHeaderHelperT<VP>::ResolveInterpolationSchemes() {
+  fSchemes.clear();
+  for (auto const &hdr_it : fHeaders) {
+    SystParamHeader const &hdr = hdr_it.second.Header;
+    if (!hdr.isSplineable) {
+      continue;
+    }
+    InterpolationScheme scheme = GetInterpolationScheme(hdr);
+    if (scheme != InterpolationScheme::kCubicSpline) {
+      fSchemes.emplace(hdr_it.first, scheme);
+    }
+  }
+}
+
+template <typename VP>
+void ParamHeaderHelperT<VP>::ApplyInterpolationScheme(TSpline3 &spl,
+                                                      paramId_t i,
+                                                      size_t NKnots) const {
+  auto scheme_it = fSchemes.find(i);
+  if (scheme_it == fSchemes.end()) {
+    return;
+  }
+  InterpolationScheme scheme = scheme_it->second;
+  NKnots = std::min(NKnots, std::min(scratch_spline_t1.size(),
+                                     scratch_spline_t2.size()));
+  scratch_spline_t3.resize(kNSplineCoeffs * NKnots);
+  BuildInterpolationCoeffs(scheme, scratch_spline_t2.data(),
+                           scratch_spline_t1.data(), NKnots,
+                           scratch_spline_t3.data());
+  for (size_t k_it = 0; k_it < NKnots; ++k_it) {
+    double const *p = scratch_spline_t3.data() + (kNSplineCoeffs * k_it);
+    spl.SetPointCoeff(int(k_it), p[1], p[2], p[3]);
+  }
+}
+template <typename VP>
+TSpline3 ParamHeaderHelperT<VP>::GetSpline(paramId_t i,
                                       event_unit_response_t const &eur,
                                       SystParamHeader const &) const {
 
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!ContainterHasParam(eur, i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << i
-                  << ", but the relevant event response was not passed."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "MissingEventResponse",
+                             "Requested header for parameter " << i
+                                 << ", but the relevant event response was not "
+                                    "passed.");
       return TSpline3();
     }
   }
@@ -486,18 +388,21 @@ TSpline3 ParamHeaderHelper::GetSpline(paramId_t i,
   return GetSpline(i, GetParamElementFromContainer(eur, i).responses);
 }
 
-TSpline3 ParamHeaderHelper::GetSpline(paramId_t i,
+template <typename VP>
+TSpline3 ParamHeaderHelperT<VP>::GetSpline(paramId_t i,
                                       spline_t const &event_responses) const {
   SystParamHeader const &hdr = GetHeader(i);
   return GetSpline(i, event_responses, hdr);
 }
-TSpline3 ParamHeaderHelper::GetSpline(paramId_t i,
+template <typename VP>
+TSpline3 ParamHeaderHelperT<VP>::GetSpline(paramId_t i,
                                       event_unit_response_t const &eur) const {
   SystParamHeader const &hdr = GetHeader(i);
   return GetSpline(i, eur, hdr);
 }
+template <typename VP>
 std::vector<TSpline3>
-ParamHeaderHelper::GetSplines(paramId_t i, EventResponse const &er) const {
+ParamHeaderHelperT<VP>::GetSplines(paramId_t i, EventResponse const &er) const {
   SystParamHeader const &hdr = GetHeader(i);
   std::vector<TSpline3> rtn;
   for (auto &eur : er) {
@@ -506,11 +411,12 @@ ParamHeaderHelper::GetSplines(paramId_t i, EventResponse const &er) const {
   return rtn;
 }
 
-ParamHeaderHelper::param_tspline_map_t
-ParamHeaderHelper::GetSplines(param_list_t const &ilist,
+template <typename VP>
+typename ParamHeaderHelperT<VP>::param_tspline_map_t
+ParamHeaderHelperT<VP>::GetSplines(param_list_t const &ilist,
                               event_unit_response_t const &eur) const {
   param_tspline_map_t rtn;
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     param_list_t ilist_cpy = CheckParamList(ilist, true, false);
     for (auto &i : ilist_cpy) {
       // Use this form to allow for lazy handing off of checking.
@@ -524,12 +430,13 @@ ParamHeaderHelper::GetSplines(param_list_t const &ilist,
   }
   return rtn;
 }
-std::vector<ParamHeaderHelper::param_tspline_map_t>
-ParamHeaderHelper::GetSplines(param_list_t const &ilist,
+template <typename VP>
+std::vector<typename ParamHeaderHelperT<VP>::param_tspline_map_t>
+ParamHeaderHelperT<VP>::GetSplines(param_list_t const &ilist,
                               EventResponse const &er) const {
 
   std::vector<param_tspline_map_t> rtn;
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     param_list_t ilist_cpy = CheckParamList(ilist, true, false);
     for (auto &eu : er) {
       rtn.emplace_back(GetSplines(ilist_cpy, eu));
@@ -542,82 +449,44 @@ ParamHeaderHelper::GetSplines(param_list_t const &ilist,
   return rtn;
 }
 
+template <typename VP>
 double
-ParamHeaderHelper::GetParameterResponse(paramId_t i, double v,
+ParamHeaderHelperT<VP>::GetParameterResponse(paramId_t i, double v,
                                         spline_t const &event_responses) const {
-  if (fChkErr.fCare == ParamValidationAndErrorResponse::kHare) {
-    if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-      std::cout << "["
-                << ((fChkErr.fPedantry ==
-                     ParamValidationAndErrorResponse::kNotOnMyWatch)
-                        ? "ERROR"
-                        : "WARN")
-                << "]: The GetParameterResponse interface is extremely "
-                   "inefficienct unless you only ever need to evaluate the "
-                   "parameter response for a given event once per execution."
-                << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
-    }
+  if (Care() == ParamValidationAndErrorResponse::kHare) {
+    SYSTTOOLS_CHECK_FAILED(fChkErr, "InefficientInterface",
+                           "The GetParameterResponse interface is extremely "
+                           "inefficienct unless you only ever need to evaluate "
+                           "the parameter response for a given event once per "
+                           "execution.");
   }
 
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!HaveHeader(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << i
-                  << ", but it is not currently configured." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                             "Requested header for parameter " << i
+                                 << ", but it is not currently configured.");
       return 0;
     }
   }
 
   // check parameter limits
-  if (fChkErr.fCare == ParamValidationAndErrorResponse::kTortoise) {
+  if (Care() == ParamValidationAndErrorResponse::kTortoise) {
     if (HasParameterLowLimit(i) && (v < GetParameterLowLimit(i))) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Parameter \"" << GetHeader(i).prettyName
-                  << "\", evaluated at " << v
-                  << ", but specified lower bound at "
-                  << GetParameterLowLimit(i) << "." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \"" << GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified lower bound at "
+                                 << GetParameterLowLimit(i) << ".");
 
       v = GetParameterLowLimit(i);
     }
     if (HasParameterUpLimit(i) && (v > GetParameterUpLimit(i))) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Parameter \"" << GetHeader(i).prettyName
-                  << "\", evaluated at " << v
-                  << ", but specified upper bound at " << GetParameterUpLimit(i)
-                  << "." << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \"" << GetHeader(i).prettyName
+                                 << "\", evaluated at " << v
+                                 << ", but specified upper bound at "
+                                 << GetParameterUpLimit(i) << ".");
 
       v = GetParameterUpLimit(i);
     }
@@ -625,36 +494,27 @@ ParamHeaderHelper::GetParameterResponse(paramId_t i, double v,
   return GetSpline(i, event_responses).Eval(v);
 }
 
-double ParamHeaderHelper::GetParameterResponse(
+template <typename VP>
+double ParamHeaderHelperT<VP>::GetParameterResponse(
     paramId_t i, double v, event_unit_response_t const &eur) const {
 
   // Manually do this check here (from GetSpline) as it seems to be the path of
   // least duplication.
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!ContainterHasParam(eur, i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << i
-                  << ", but the relevant event response was not passed."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-        // If for some reason we have the header info and it is a weight header,
-        // respect the error response settings.
-        if (IsWeightResponse(i)) {
-          return fChkErr.fErrorResponse ==
-                         ParamValidationAndErrorResponse::kUnityWeight
-                     ? 1
-                     : 0;
-        } else { // otherwise just reply with a 0.
-          return 0;
-        }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "MissingEventResponse",
+                             "Requested header for parameter " << i
+                                 << ", but the relevant event response was "
+                                    "not passed.");
+      // If for some reason we have the header info and it is a weight header,
+      // respect the error response settings.
+      if (IsWeightResponse(i)) {
+        return fChkErr.fErrorResponse ==
+                       ParamValidationAndErrorResponse::kUnityWeight
+                   ? 1
+                   : 0;
+      } else { // otherwise just reply with a 0.
+        return 0;
       }
     }
   }
@@ -663,11 +523,56 @@ double ParamHeaderHelper::GetParameterResponse(
                               GetParamElementFromContainer(eur, i).responses);
 }
 
+template <typename VP>
+double ParamHeaderHelperT<VP>::GetParameterResponseDerivative(
+    paramId_t i, double v, spline_t const &event_responses) const {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
+    if (!HaveHeader(i)) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "UnconfiguredParameter",
+                             "Requested header for parameter " << i
+                                 << ", but it is not currently configured.");
+      return 0;
+    }
+  }
+
+  // The response is flat outside of the limits, where it is evaluated at the
+  // limit.
+  if (Care() == ParamValidationAndErrorResponse::kTortoise) {
+    if ((HasParameterLowLimit(i) && (v < GetParameterLowLimit(i))) ||
+        (HasParameterUpLimit(i) && (v > GetParameterUpLimit(i)))) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ParameterOutOfBounds",
+                             "Parameter \"" << GetHeader(i).prettyName
+                                 << "\", derivative evaluated at " << v
+                                 << ", outside of the specified limits.");
+      return 0;
+    }
+  }
+  return GetSpline(i, event_responses).Derivative(v);
+}
+
+template <typename VP>
+double ParamHeaderHelperT<VP>::GetParameterResponseDerivative(
+    paramId_t i, double v, event_unit_response_t const &eur) const {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
+    if (!ContainterHasParam(eur, i)) {
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "MissingEventResponse",
+                             "Requested header for parameter " << i
+                                 << ", but the relevant event response was "
+                                    "not passed.");
+      return 0;
+    }
+  }
+
+  return GetParameterResponseDerivative(
+      i, v, GetParamElementFromContainer(eur, i).responses);
+}
+
+template <typename VP>
 double
-ParamHeaderHelper::GetTotalResponse(param_value_list_t const &ivlist,
+ParamHeaderHelperT<VP>::GetTotalResponse(param_value_list_t const &ivlist,
                                     event_unit_response_t const &eur) const {
 
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     param_value_list_t ivmap_cpy = CheckParamValueList(ivlist);
     double response_weight = 1;
     for (auto &iv : ivmap_cpy) {
@@ -685,8 +590,9 @@ ParamHeaderHelper::GetTotalResponse(param_value_list_t const &ivlist,
   return response_weight;
 }
 
+template <typename VP>
 std::vector<double>
-ParamHeaderHelper::GetParameterResponse(paramId_t i, double v,
+ParamHeaderHelperT<VP>::GetParameterResponse(paramId_t i, double v,
                                         EventResponse const &er) const {
   std::vector<double> rtn;
   for (auto &eur : er) {
@@ -694,8 +600,9 @@ ParamHeaderHelper::GetParameterResponse(paramId_t i, double v,
   }
   return rtn;
 }
+template <typename VP>
 std::vector<double>
-ParamHeaderHelper::GetTotalResponse(param_value_list_t const &ivlist,
+ParamHeaderHelperT<VP>::GetTotalResponse(param_value_list_t const &ivlist,
                                     EventResponse const &er) const {
   std::vector<double> rtn;
   for (auto &eur : er) {
@@ -704,13 +611,16 @@ ParamHeaderHelper::GetTotalResponse(param_value_list_t const &ivlist,
   return rtn;
 }
 
-size_t ParamHeaderHelper::GetNDiscreteVariations(paramId_t i) const {
+template <typename VP>
+size_t ParamHeaderHelperT<VP>::GetNDiscreteVariations(paramId_t i) const {
   SystParamHeader const &hdr = GetHeader(i);
   return hdr.paramVariations.size();
 }
 
+template <typename VP>
 std::vector<size_t>
-ParamHeaderHelper::GetNDiscreteVariations(param_list_t const &paramlist) const {
+ParamHeaderHelperT<VP>::GetNDiscreteVariations(
+    param_list_t const &paramlist) const {
   std::vector<size_t> rtn;
   for (auto &i : paramlist) {
     rtn.push_back(GetNDiscreteVariations(i));
@@ -718,34 +628,25 @@ ParamHeaderHelper::GetNDiscreteVariations(param_list_t const &paramlist) const {
   return rtn;
 }
 
-ParamHeaderHelper::discrete_variation_list_t
-ParamHeaderHelper::GetDiscreteResponses(
+template <typename VP>
+typename ParamHeaderHelperT<VP>::discrete_variation_list_t
+ParamHeaderHelperT<VP>::GetDiscreteResponses(
     paramId_t i, discrete_variation_list_t const &event_responses,
     SystParamHeader const &hdr) const {
 
   // Check if the response header suggests that this is a responseless
   // parameter.
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (IsResponselessParam(i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested responses for parameter " << i
-                  << ", but it expresses responses through parameter "
-                  << GetResponseParamId(i) << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "ResponselessParameter",
+                             "Requested responses for parameter " << i
+                                 << ", but it expresses responses through "
+                                    "parameter " << GetResponseParamId(i));
       return discrete_variation_list_t{};
     }
 
     // Slow, inefficient checks
-    if (fChkErr.fCare == ParamValidationAndErrorResponse::kTortoise) {
+    if (Care() == ParamValidationAndErrorResponse::kTortoise) {
 
       discrete_variation_list_t scratch_discrete_variation_list_t1 =
           hdr.differsEventByEvent ? event_responses : hdr.responses;
@@ -754,21 +655,12 @@ ParamHeaderHelper::GetDiscreteResponses(
       // Check if the number of responses found is the same as the number of
       // knots
       if ((NResponses != hdr.paramVariations.size())) {
-        if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-          std::cout << "["
-                    << ((fChkErr.fPedantry ==
-                         ParamValidationAndErrorResponse::kNotOnMyWatch)
-                            ? "ERROR"
-                            : "WARN")
-                    << "]: Requested discrete variations for parameter " << i
-                    << ", but the number of responses (" << NResponses
-                    << ") and variations (" << hdr.paramVariations.size()
-                    << ") differ." << std::endl;
-          if (fChkErr.fPedantry ==
-              ParamValidationAndErrorResponse::kNotOnMyWatch) {
-            throw;
-          }
-        }
+        SYSTTOOLS_CHECK_FAILED(fChkErr, "ResponseCountMismatch",
+                               "Requested discrete variations for parameter "
+                                   << i << ", but the number of responses ("
+                                   << NResponses << ") and variations ("
+                                   << hdr.paramVariations.size()
+                                   << ") differ.");
         NResponses = std::min(NResponses, hdr.paramVariations.size());
       }
 
@@ -786,107 +678,80 @@ ParamHeaderHelper::GetDiscreteResponses(
   return hdr.differsEventByEvent ? event_responses : hdr.responses;
 }
 
-ParamHeaderHelper::discrete_variation_list_t
-ParamHeaderHelper::GetDiscreteResponses(
+template <typename VP>
+typename ParamHeaderHelperT<VP>::discrete_variation_list_t
+ParamHeaderHelperT<VP>::GetDiscreteResponses(
     paramId_t i, discrete_variation_list_t const &event_responses) const {
   return GetDiscreteResponses(i, event_responses, GetHeader(i));
 }
 
-ParamHeaderHelper::discrete_variation_list_t
-ParamHeaderHelper::GetDiscreteResponses(paramId_t i,
+template <typename VP>
+typename ParamHeaderHelperT<VP>::discrete_variation_list_t
+ParamHeaderHelperT<VP>::GetDiscreteResponses(paramId_t i,
                                         event_unit_response_t const &eur,
                                         SystParamHeader const &hdr) const {
 
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!ContainterHasParam(eur, i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << i
-                  << ", but the relevant event response was not passed."
-                  << std::endl;
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-      }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "MissingEventResponse",
+                             "Requested header for parameter " << i
+                                 << ", but the relevant event response was not "
+                                    "passed.");
       return {};
     }
   }
 
-  return ParamHeaderHelper::GetDiscreteResponses(
+  return GetDiscreteResponses(
       i, GetParamElementFromContainer(eur, i).responses, hdr);
 }
-ParamHeaderHelper::discrete_variation_list_t
-ParamHeaderHelper::GetDiscreteResponses(
+template <typename VP>
+typename ParamHeaderHelperT<VP>::discrete_variation_list_t
+ParamHeaderHelperT<VP>::GetDiscreteResponses(
     paramId_t i, event_unit_response_t const &eur) const {
   return GetDiscreteResponses(i, eur, GetHeader(i));
 }
 
-double ParamHeaderHelper::GetDiscreteResponse(
+template <typename VP>
+double ParamHeaderHelperT<VP>::GetDiscreteResponse(
     paramId_t i, size_t j,
     discrete_variation_list_t const &event_responses) const {
 
-  if (fChkErr.fCare == ParamValidationAndErrorResponse::kHare) {
-    if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-      std::cout
-          << "["
-          << ((fChkErr.fPedantry ==
-               ParamValidationAndErrorResponse::kNotOnMyWatch)
-                  ? "ERROR"
-                  : "WARN")
-          << "]: The GetDiscreteResponse interface is extremely "
-             "inefficienct. The advised practice is to use "
-             "GetDiscreteResponses to get all variations for a given set of "
-             "events and then use or cache the results."
-          << std::endl;
-      if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
-        throw;
-      }
-    }
+  if (Care() == ParamValidationAndErrorResponse::kHare) {
+    SYSTTOOLS_CHECK_FAILED(
+        fChkErr, "InefficientInterface",
+        "The GetDiscreteResponse interface is extremely inefficienct. The "
+        "advised practice is to use GetDiscreteResponses to get all "
+        "variations for a given set of events and then use or cache the "
+        "results.");
   }
 
   return GetDiscreteResponses(i, event_responses)[j];
 }
 
+template <typename VP>
 double
-ParamHeaderHelper::GetDiscreteResponse(paramId_t i, size_t j,
+ParamHeaderHelperT<VP>::GetDiscreteResponse(paramId_t i, size_t j,
                                        event_unit_response_t const &eur) const {
 
   // Manually do this check here (from GetSpline) as it seems to be the path of
   // least duplication.
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     if (!ContainterHasParam(eur, i)) {
-      if (fChkErr.fPedantry <= ParamValidationAndErrorResponse::kMeh) {
-        std::cout << "["
-                  << ((fChkErr.fPedantry ==
-                       ParamValidationAndErrorResponse::kNotOnMyWatch)
-                          ? "ERROR"
-                          : "WARN")
-                  << "]: Requested header for parameter " << i
-                  << ", but the relevant event response was not passed."
-                  << std::endl;
-        std::cout << "[INFO]: Recieved response info for: " << std::endl;
-        for (auto &ivs : eur) {
-          std::cout << "\t" << ivs.pid << std::endl;
-        }
-        if (fChkErr.fPedantry ==
-            ParamValidationAndErrorResponse::kNotOnMyWatch) {
-          throw;
-        }
-        // If for some reason we have the header info and it is a weight header,
-        // respect the error response settings.
-        if (IsWeightResponse(i)) {
-          return fChkErr.fErrorResponse ==
-                         ParamValidationAndErrorResponse::kUnityWeight
-                     ? 1
-                     : 0;
-        } else { // otherwise just reply with a 0.
-          return 0;
-        }
+      SYSTTOOLS_CHECK_FAILED(fChkErr, "MissingEventResponse",
+                             "Requested header for parameter "
+                                 << i
+                                 << ", but the relevant event response was "
+                                    "not passed. Received responses for: "
+                                 << DescribeEventUnitParams(eur));
+      // If for some reason we have the header info and it is a weight header,
+      // respect the error response settings.
+      if (IsWeightResponse(i)) {
+        return fChkErr.fErrorResponse ==
+                       ParamValidationAndErrorResponse::kUnityWeight
+                   ? 1
+                   : 0;
+      } else { // otherwise just reply with a 0.
+        return 0;
       }
     }
   }
@@ -895,12 +760,13 @@ ParamHeaderHelper::GetDiscreteResponse(paramId_t i, size_t j,
                              GetParamElementFromContainer(eur, i).responses);
 }
 
+template <typename VP>
 double
-ParamHeaderHelper::GetDiscreteResponse(param_list_t const &ilist, size_t j,
+ParamHeaderHelperT<VP>::GetDiscreteResponse(param_list_t const &ilist, size_t j,
                                        event_unit_response_t const &eur) const {
 
   double response_weight = 1;
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     param_list_t ilist_cpy = CheckParamList(ilist, false, true);
     for (auto &i : ilist_cpy) {
       // Use this form to allow for lazy handing off of checking.
@@ -916,8 +782,9 @@ ParamHeaderHelper::GetDiscreteResponse(param_list_t const &ilist, size_t j,
   return response_weight;
 }
 
+template <typename VP>
 std::vector<double>
-ParamHeaderHelper::GetDiscreteResponses(paramId_t i, size_t j,
+ParamHeaderHelperT<VP>::GetDiscreteResponses(paramId_t i, size_t j,
                                         EventResponse const &er) const {
   std::vector<double> rtn;
   for (auto &eur : er) {
@@ -927,9 +794,11 @@ ParamHeaderHelper::GetDiscreteResponses(paramId_t i, size_t j,
   return rtn;
 }
 
+template <typename VP>
 std::vector<double>
-ParamHeaderHelper::GetDiscreteResponses(param_list_t const &ilist, size_t j,
-                                        EventResponse const &er) const {
+ParamHeaderHelperT<VP>::GetDiscreteResponses(param_list_t const &ilist,
+                                             size_t j,
+                                             EventResponse const &er) const {
   std::vector<double> rtn;
   for (auto &eur : er) {
     rtn.push_back(GetDiscreteResponse(ilist, j, eur));
@@ -937,8 +806,9 @@ ParamHeaderHelper::GetDiscreteResponses(param_list_t const &ilist, size_t j,
   return rtn;
 }
 
-std::vector<ParamHeaderHelper::discrete_variation_list_t>
-ParamHeaderHelper::GetAllDiscreteResponses(paramId_t i,
+template <typename VP>
+std::vector<typename ParamHeaderHelperT<VP>::discrete_variation_list_t>
+ParamHeaderHelperT<VP>::GetAllDiscreteResponses(paramId_t i,
                                            EventResponse const &er) const {
   std::vector<std::vector<double>> rtn;
   for (auto &eur : er) {
@@ -947,14 +817,15 @@ ParamHeaderHelper::GetAllDiscreteResponses(paramId_t i,
   return rtn;
 }
 
-std::vector<ParamHeaderHelper::discrete_variation_list_t>
-ParamHeaderHelper::GetAllDiscreteResponses(param_list_t const &ilist,
+template <typename VP>
+std::vector<typename ParamHeaderHelperT<VP>::discrete_variation_list_t>
+ParamHeaderHelperT<VP>::GetAllDiscreteResponses(param_list_t const &ilist,
                                            EventResponse const &er) const {
 
   size_t nvariations = GetNDiscreteVariations(ilist.front());
   std::vector<std::vector<double>> rtn;
 
-  if (fChkErr.fCare <= ParamValidationAndErrorResponse::kFrog) {
+  if (Care() <= ParamValidationAndErrorResponse::kFrog) {
     param_list_t ilist_cpy = CheckParamList(ilist, false, true);
     for (auto &eur : er) {
       rtn.emplace_back(nvariations, 1);
@@ -980,8 +851,9 @@ ParamHeaderHelper::GetAllDiscreteResponses(param_list_t const &ilist,
   return rtn;
 }
 
-std::map<paramId_t, ParamHeaderHelper::discrete_variation_list_t>
-ParamHeaderHelper::GetDiscreteVariationParameterValues(
+template <typename VP>
+std::map<paramId_t, typename ParamHeaderHelperT<VP>::discrete_variation_list_t>
+ParamHeaderHelperT<VP>::GetDiscreteVariationParameterValues(
     param_list_t const &ilist) const {
   std::map<paramId_t, discrete_variation_list_t> discrete_var_param_values;
   for (auto const &i : ilist) {
@@ -990,7 +862,8 @@ ParamHeaderHelper::GetDiscreteVariationParameterValues(
   return discrete_var_param_values;
 }
 
-std::string ParamHeaderHelper::GetHeaderInfo() const {
+template <typename VP>
+std::string ParamHeaderHelperT<VP>::GetHeaderInfo() const {
   std::stringstream ss("");
 
   for (paramId_t p : GetParameters()) {
@@ -1002,8 +875,9 @@ std::string ParamHeaderHelper::GetHeaderInfo() const {
   }
   return ss.str();
 }
+template <typename VP>
 std::string
-ParamHeaderHelper::GetEventResponseInfo(event_unit_response_t eur) const {
+ParamHeaderHelperT<VP>::GetEventResponseInfo(event_unit_response_t eur) const {
   std::stringstream ss("");
 
   for (paramId_t p : GetParameters()) {
@@ -1038,4 +912,12 @@ ParamHeaderHelper::GetEventResponseInfo(event_unit_response_t eur) const {
   return ss.str();
 }
 
+template class ParamHeaderHelperT<RuntimeValidationPolicy>;
+template class ParamHeaderHelperT<
+    StaticValidationPolicy<ParamValidationAndErrorResponse::kTortoise>>;
+template class ParamHeaderHelperT<
+    StaticValidationPolicy<ParamValidationAndErrorResponse::kFrog>>;
+template class ParamHeaderHelperT<
+    StaticValidationPolicy<ParamValidationAndErrorResponse::kHare>>;
+
 } // namespace systtools
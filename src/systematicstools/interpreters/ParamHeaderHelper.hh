@@ -4,20 +4,83 @@
 #include "systematicstools/interface/SystMetaData.hh"
 #include "systematicstools/interface/types.hh"
 
+#include "systematicstools/interpreters/InterpolationSchemes.hh"
 #include "systematicstools/interpreters/PolyResponse.hh"
 
 #include "systematicstools/interpreters/ParamValidationAndErrorResponse.hh"
 
+#include "systematicstools/utility/MemoryFootprint.hh"
+
 #include "TSpline.h"
 
+#include <type_traits>
+
 namespace systtools {
 
-class ParamHeaderHelper {
+namespace footprint {
+///\brief The per-knot polynomials allocated by a TSpline3.
+inline size_t HeapBytes(TSpline3 const &spl) {
+  return size_t(spl.GetNp()) * sizeof(TSplinePoly3);
+}
+} // namespace footprint
+
+///\brief Validation policy that reads the care level from the
+/// ParamValidationAndErrorResponse instance at runtime.
+///
+/// Used by ParamHeaderHelper, whose care level can be changed with
+/// SetCareLevel.
+struct RuntimeValidationPolicy {
+  static constexpr bool kIsStatic = false;
+  static ParamValidationAndErrorResponse::CareLevel
+  GetCareLevel(ParamValidationAndErrorResponse const &chkerr) {
+    return chkerr.fCare;
+  }
+};
+
+///\brief Validation policy with a care level fixed at compile time.
+///
+/// Checks that are not required at care level CL are compiled out of every
+/// ParamHeaderHelperT<StaticValidationPolicy<CL>> accessor. The reaction to
+/// failed checks (fPedantry, fErrorResponse) is still configured at runtime.
+template <ParamValidationAndErrorResponse::CareLevel CL>
+struct StaticValidationPolicy {
+  static constexpr bool kIsStatic = true;
+  static constexpr ParamValidationAndErrorResponse::CareLevel kCareLevel = CL;
+  static constexpr ParamValidationAndErrorResponse::CareLevel
+  GetCareLevel(ParamValidationAndErrorResponse const &) {
+    return CL;
+  }
+};
+
+///\brief Helper class for interpreting parameter headers and event
+/// responses.
+///
+/// The validation policy, VP, determines how the care level is determined,
+/// see RuntimeValidationPolicy and StaticValidationPolicy. Most users should
+/// use the ParamHeaderHelper or StaticParamHeaderHelper aliases.
+template <typename VP> class ParamHeaderHelperT {
 
   param_header_map_t fHeaders;
   ParamValidationAndErrorResponse fChkErr;
+  ///\brief The spline parameters that declare an InterpolationScheme other
+  /// than kCubicSpline, resolved once, when the headers are set.
+  std::map<paramId_t, InterpolationScheme> fSchemes;
+
+  void ResolveInterpolationSchemes();
+
+  ///\brief The care level in effect, a compile-time constant for static
+  /// validation policies.
+  constexpr ParamValidationAndErrorResponse::CareLevel Care() const {
+    return VP::GetCareLevel(fChkErr);
+  }
+
+  void SyncCareLevel() {
+    fChkErr.fCare = VP::GetCareLevel(fChkErr);
+  }
 
 public:
+  typedef VP validation_policy_t;
+
   typedef std::vector<double> spline_t;
   typedef std::map<paramId_t, TSpline3> param_tspline_map_t;
   typedef std::vector<double> discrete_variation_list_t;
@@ -27,24 +90,49 @@ public:
   ///\note a param_header_map_t instance can be retrieved from a parameter headers FHiCL document by systtools::BuildParameterHeaders, found in utility/ParameterAndProviderConfigurationUtility.hh
   ///
   /// Headers can be set/overriden after construction by ParamHeaderHelper::SetHeaders.
-  ParamHeaderHelper(param_header_map_t headers = {},
-                    ParamValidationAndErrorResponse chkerrs =
-                        ParamValidationAndErrorResponse())
-      : fHeaders(headers), fChkErr(chkerrs) {}
-  ParamHeaderHelper(param_header_map_t &&headers,
-                    ParamValidationAndErrorResponse chkerrs =
-                        ParamValidationAndErrorResponse())
-      : fHeaders(std::move(headers)), fChkErr(chkerrs) {}
-
-  void SetHeaders(param_header_map_t const &headers) { fHeaders = headers; }
+  ///
+  ///\note throws invalid_interpolation_scheme, here or in SetHeaders, if a
+  /// spline parameter declares an unknown InterpolationScheme.
+  ParamHeaderHelperT(param_header_map_t const &headers = {},
+                     ParamValidationAndErrorResponse chkerrs =
+                         ParamValidationAndErrorResponse())
+      : fHeaders(headers), fChkErr(chkerrs) {
+    SyncCareLevel();
+    ResolveInterpolationSchemes();
+  }
+  ParamHeaderHelperT(param_header_map_t &&headers,
+                     ParamValidationAndErrorResponse chkerrs =
+                         ParamValidationAndErrorResponse())
+      : fHeaders(std::move(headers)), fChkErr(chkerrs) {
+    SyncCareLevel();
+    ResolveInterpolationSchemes();
+  }
+
+  void SetHeaders(param_header_map_t const &headers) {
+    fHeaders = headers;
+    ResolveInterpolationSchemes();
+  }
   void SetHeaders(param_header_map_t &&headers) {
     fHeaders = std::move(headers);
+    ResolveInterpolationSchemes();
+  }
+  param_header_map_t const &GetHeaders() const { return fHeaders; }
+
+  ///\brief The memory owned by the headers, see
+  /// MemoryFootprint(param_header_map_t const &).
+  MemoryBreakdown MemoryFootprint() const {
+    MemoryBreakdown mb = systtools::MemoryFootprint(fHeaders);
+    mb.Add("maps", footprint::NodeBytes(fSchemes));
+    return mb;
   }
-  param_header_map_t const &GetHeaders() { return fHeaders; }
 
+  ///\note For static validation policies, the care level of ChkErr is
+  /// ignored.
   void SetChkErr(ParamValidationAndErrorResponse const &ChkErr) {
     fChkErr = ChkErr;
+    SyncCareLevel();
   }
+  ParamValidationAndErrorResponse const &GetChkErr() const { return fChkErr; }
 
   ///\brief Get the header object for parameter i
   SystParamHeader const &GetHeader(paramId_t i) const;
@@ -135,6 +223,9 @@ public:
   ///\brief Get a TSpline object for a given parameter for a given event from
   /// the passed vector of responses.
   ///
+  /// The spline interpolates with the InterpolationScheme declared in the
+  /// header opts, the not-a-knot cubic spline by default.
+  ///
   ///\note At higher care levels, the passing of non-spline parameters will
   /// checked for.
   TSpline3 GetSpline(paramId_t, spline_t const &event_responses = {}) const;
@@ -152,7 +243,9 @@ public:
   PolyResponse<n> GetPolyResponse(paramId_t i,
                                   event_unit_response_t const &eur) const {
     if (!IsSplineParam(i)) {
-      throw;
+      throw failed_parameter_check()
+          << "[ERROR]: Requested PolyResponse for parameter " << i
+          << ", but it is not a splineable parameter.";
     }
     return PolyResponse<n>(GetHeader(i).paramVariations,
                            GetParamElementFromContainer(eur, i).responses);
@@ -227,6 +320,21 @@ public:
   double GetTotalResponse(param_value_list_t const &,
                           event_unit_response_t const &) const;
 
+  ///\brief Gets the derivative of the splined response for parameter i,
+  /// with respect to its value, at v, given the passed spline information.
+  ///
+  /// Outside of any parameter limits at the kTortoise care level, where the
+  /// response is evaluated at the limit, the derivative is 0.
+  ///
+  ///\note As for GetParameterResponse, this builds a spline for each call;
+  /// fits should use EventSplineCache::GetTotalEventWeightsAndGradient.
+  double GetParameterResponseDerivative(
+      paramId_t, double, spline_t const &event_responses = {}) const;
+  ///\brief Gets the derivative of the splined response for parameter i, with
+  /// respect to its value, at v, given the passed event unit information.
+  double GetParameterResponseDerivative(paramId_t i, double v,
+                                        event_unit_response_t const &) const;
+
   ///\brief Gets the splined response for parameter i, set to value v, for each
   /// event unit in the passed event response.
   ///
@@ -366,9 +474,17 @@ public:
   /// systematics.
   /// * kFrog: Check that parameters exist and are used correctly (spline type).
   /// * kHare: Assume everything is correct.
-  void SetCareLevel(ParamValidationAndErrorResponse::CareLevel c) {
+  ///
+  ///\note Only available for the runtime validation policy, for static
+  /// policies the care level is fixed by the type.
+  template <typename P = VP>
+  typename std::enable_if<!P::kIsStatic>::type
+  SetCareLevel(ParamValidationAndErrorResponse::CareLevel c) {
     fChkErr.fCare = c;
   }
+  ParamValidationAndErrorResponse::CareLevel GetCareLevel() const {
+    return Care();
+  }
   ///\brief How to react to the result of usage checks
   ///
   ///\note This defines how to react to failed checks, as opposed to fCare,
@@ -424,6 +540,16 @@ private:
   TSpline3 GetSpline(paramId_t, event_unit_response_t const &,
                      SystParamHeader const &) const;
 
+  ///\brief Replaces the cubic spline coefficients of the first NKnots knots
+  /// of spl, built from the scratch knots and responses, with those of the
+  /// InterpolationScheme declared for parameter i, if it is not kCubicSpline.
+  ///
+  /// TSpline3 always builds its own cubic coefficients first, code that
+  /// evaluates many responses should use the flat coefficients of
+  /// EventSplineCache or InterpolatedResponse instead.
+  void ApplyInterpolationScheme(TSpline3 &spl, paramId_t i,
+                                size_t NKnots) const;
+
   ///\brief Used internally to skip getting a header that we have already got.
   ///
   /// Probably reeks of premature optimization.
@@ -464,7 +590,27 @@ private:
 
   mutable spline_t scratch_spline_t1;
   mutable spline_t scratch_spline_t2;
+  mutable spline_t scratch_spline_t3;
   mutable discrete_variation_list_t scratch_discrete_variation_list_t1;
-}; // namespace systtools
+};
+
+///\brief Parameter header helper with a care level configured at runtime.
+typedef ParamHeaderHelperT<RuntimeValidationPolicy> ParamHeaderHelper;
+
+///\brief Parameter header helper with a care level fixed at compile time.
+///
+/// e.g. StaticParamHeaderHelper<ParamValidationAndErrorResponse::kHare> for
+/// production use, where all parameter usage checks are compiled out.
+template <ParamValidationAndErrorResponse::CareLevel CL>
+using StaticParamHeaderHelper = ParamHeaderHelperT<StaticValidationPolicy<CL>>;
+
+extern template class ParamHeaderHelperT<RuntimeValidationPolicy>;
+extern template class ParamHeaderHelperT<
+    StaticValidationPolicy<ParamValidationAndErrorResponse::kTortoise>>;
+extern template class ParamHeaderHelperT<
+    StaticValidationPolicy<ParamValidationAndErrorResponse::kFrog>>;
+extern template class ParamHeaderHelperT<
+    StaticValidationPolicy<ParamValidationAndErrorResponse::kHare>>;
+
 } // namespace systtools
 #endif
@@ -1,10 +1,23 @@
 #include "systematicstools/interpreters/ParamValidationAndErrorResponse.hh"
 
 #include <cmath>
-#include <iostream>
+#include <string>
 
 using namespace systtools;
 
+namespace {
+///\brief Describes the spline knot or variation index of a checked response,
+/// if one was passed.
+std::string DescribeIndex(SystParamHeader const &hdr, size_t idx) {
+  if (idx == std::numeric_limits<size_t>::max()) {
+    return "";
+  }
+  return std::string(" for ") +
+         (hdr.isSplineable ? "spline knot " : "variation ") +
+         std::to_string(idx);
+}
+} // namespace
+
 double ParamValidationAndErrorResponse::CheckResponse(
     double r, SystParamHeader const &hdr, size_t idx) const {
   // Can only really check weight response as lateral systematics could be
@@ -13,24 +26,11 @@ double ParamValidationAndErrorResponse::CheckResponse(
     return r;
   }
   if (!fAllowNegativeWeights && (r < 0)) {
-    if (fPedantry <= kMeh) {
-      if (idx == std::numeric_limits<size_t>::max()) { // single value check
-        std::cout << "[" << ((fPedantry == kNotOnMyWatch) ? "ERROR" : "WARN")
-                  << "]: The weight response of parameter " << hdr.prettyName
-                  << " can be negative: " << r
-                  << ", and negative weights are not enabled." << std::endl;
-      } else {
-        std::cout << "[" << ((fPedantry == kNotOnMyWatch) ? "ERROR" : "WARN")
-                  << "]: The weight response of parameter " << hdr.prettyName
-                  << " for "
-                  << (hdr.isSplineable ? "spline knot " : "variation ") << idx
-                  << " is negative: " << r
-                  << ", and negative weights are not enabled." << std::endl;
-      }
-      if (fPedantry == kNotOnMyWatch) {
-        throw;
-      }
-    }
+    SYSTTOOLS_CHECK_FAILED(
+        *this, "NegativeWeightResponse",
+        "The weight response of parameter "
+            << hdr.prettyName << DescribeIndex(hdr, idx) << " is negative: "
+            << r << ", and negative weights are not enabled.");
     // Force default
     switch (fErrorResponse) {
     case kZeroResponse: {
@@ -49,24 +49,11 @@ double ParamValidationAndErrorResponse::CheckResponse(
   }
 
   if (fabs(r) < fSmallWeight) {
-    if (fPedantry <= kMeh) {
-      if (idx == std::numeric_limits<size_t>::max()) { // single value check
-        std::cout << "[" << ((fPedantry == kNotOnMyWatch) ? "ERROR" : "WARN")
-                  << "]: The weight response of parameter " << hdr.prettyName
-                  << " is below the low weight limit set: |" << r << "| < "
-                  << fSmallWeight << std::endl;
-      } else {
-        std::cout << "[" << ((fPedantry == kNotOnMyWatch) ? "ERROR" : "WARN")
-                  << "]: The weight response of parameter " << hdr.prettyName
-                  << " for "
-                  << (hdr.isSplineable ? "spline knot " : "variation ") << idx
-                  << " is below the low weight limit set: |" << r << "| < "
-                  << fSmallWeight << std::endl;
-      }
-      if (fPedantry == kNotOnMyWatch) {
-        throw;
-      }
-    }
+    SYSTTOOLS_CHECK_FAILED(*this, "SmallWeightResponse",
+                           "The weight response of parameter "
+                               << hdr.prettyName << DescribeIndex(hdr, idx)
+                               << " is below the low weight limit set: |" << r
+                               << "| < " << fSmallWeight);
     // Force default
     switch (fErrorResponse) {
     case kZeroResponse: {
@@ -85,24 +72,11 @@ double ParamValidationAndErrorResponse::CheckResponse(
   }
 
   if (fabs(r) > fLargeWeight) {
-    if (fPedantry <= kMeh) {
-      if (idx == std::numeric_limits<size_t>::max()) { // single value check
-        std::cout << "[" << ((fPedantry == kNotOnMyWatch) ? "ERROR" : "WARN")
-                  << "]: The weight response of parameter " << hdr.prettyName
-                  << " is above the high weight limit set: |" << r << "| > "
-                  << fLargeWeight << std::endl;
-      } else {
-        std::cout << "[" << ((fPedantry == kNotOnMyWatch) ? "ERROR" : "WARN")
-                  << "]: The weight response of parameter " << hdr.prettyName
-                  << " for "
-                  << (hdr.isSplineable ? "spline knot " : "variation ") << idx
-                  << " is above the high weight limit set: |" << r << "| > "
-                  << fLargeWeight << std::endl;
-      }
-      if (fPedantry == kNotOnMyWatch) {
-        throw;
-      }
-    }
+    SYSTTOOLS_CHECK_FAILED(*this, "LargeWeightResponse",
+                           "The weight response of parameter "
+                               << hdr.prettyName << DescribeIndex(hdr, idx)
+                               << " is above the high weight limit set: |" << r
+                               << "| > " << fLargeWeight);
 
     // Force default
     switch (fErrorResponse) {
@@ -3,8 +3,17 @@
 
 #include "systematicstools/interface/SystMetaData.hh"
 
+#include "systematicstools/utility/Diagnostics.hh"
+#include "systematicstools/utility/exceptions.hh"
+
 #include <limits>
 
+namespace systtools {
+///\brief Exception raised by failed parameter usage or response checks when
+/// fPedantry == kNotOnMyWatch.
+NEW_SYSTTOOLS_EXCEPT(failed_parameter_check);
+} // namespace systtools
+
 struct ParamValidationAndErrorResponse {
   ParamValidationAndErrorResponse()
       : fCare(kFrog), fPedantry(kMeh), fErrorResponse(kUnityWeight),
@@ -83,4 +92,23 @@ struct ParamValidationAndErrorResponse {
                        size_t idx = std::numeric_limits<size_t>::max()) const;
 };
 
+///\brief Reacts to a failed parameter usage or response check according to
+/// the pedantry level of CHKERR.
+///
+/// * kNotOnMyWatch: throws systtools::failed_parameter_check.
+/// * kMeh: posts a kWarn SYSTTOOLS_DIAG message of type TYPE.
+/// * kAnythingGoes: does nothing.
+///
+/// MSG is a stream expression that is only formatted when it is used.
+#define SYSTTOOLS_CHECK_FAILED(CHKERR, TYPE, MSG)                              \
+  do {                                                                         \
+    if ((CHKERR).fPedantry ==                                                  \
+        ParamValidationAndErrorResponse::kNotOnMyWatch) {                      \
+      throw systtools::failed_parameter_check() << "[ERROR]: " << MSG;         \
+    }                                                                          \
+    if ((CHKERR).fPedantry == ParamValidationAndErrorResponse::kMeh) {         \
+      SYSTTOOLS_DIAG(kWarn, TYPE, MSG);                                        \
+    }                                                                          \
+  } while (false)
+
 #endif
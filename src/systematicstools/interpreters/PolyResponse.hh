@@ -33,6 +33,29 @@ template <size_t n> struct PolyResponse : std::array<double, n + 1> {
     }
     return val;
   }
+
+  ///\brief The derivative of the polynomial at x.
+  double deriv(double x) const {
+    double val = 0;
+    double xpow = 1;
+    for (size_t dim = 1; dim < (n + 1); ++dim) {
+      val += double(dim) * this->at(dim) * xpow;
+      xpow *= x;
+    }
+    return val;
+  }
+
+  ///\brief Evaluates the polynomial at x, and sets d to its derivative, using
+  /// Horner's scheme for both.
+  double eval_with_deriv(double x, double &d) const {
+    double val = this->at(n);
+    d = 0;
+    for (size_t dim = n; dim-- > 0;) {
+      d = d * x + val;
+      val = val * x + this->at(dim);
+    }
+    return val;
+  }
 };
 } // namespace systtools
 
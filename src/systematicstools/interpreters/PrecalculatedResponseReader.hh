@@ -1,6 +1,8 @@
 #ifndef SYSTTOOLS_INTERPRETERS_PRECALCULATEDRESPONSEHELPER_SEEN
 #define SYSTTOOLS_INTERPRETERS_PRECALCULATEDRESPONSEHELPER_SEEN
 
+#include "systematicstools/interface/EncodedEventResponse.hh"
+#include "systematicstools/interface/EventResponseIndex.hh"
 #include "systematicstools/interface/EventResponse_product.hh"
 #include "systematicstools/interface/types.hh"
 
@@ -11,7 +13,9 @@
 #include "TFile.h"
 #include "TTree.h"
 
+#include <cmath>
 #include <iomanip>
+#include <memory>
 #include <vector>
 
 namespace systtools {
@@ -25,6 +29,7 @@ public:
   NEW_SYSTTOOLS_EXCEPT(entry_overflow);
   NEW_SYSTTOOLS_EXCEPT(missing_TBranches);
   NEW_SYSTTOOLS_EXCEPT(too_many_headers);
+  NEW_SYSTTOOLS_EXCEPT(unsupported_encoding);
 
 private:
   TFile *file;
@@ -40,19 +45,39 @@ private:
   ///\note This is a 1D vector that is passed to the TTree as a 2D object, array
   /// stacking follows C standard for stack-allocated two dimensional arrays.
   std::vector<Double_t> coeffs_1D;
+  /// Tree variable to hold responses in ResponseEncoding::kFloat mode.
+  ///
+  ///\note The constant coefficient is stored as a delta from unity, all other
+  /// coefficients are stored as is.
+  std::vector<Float_t> delta_coeffs_1D;
+
+  ResponseEncoding fEncoding = ResponseEncoding::kDouble;
+  std::map<paramId_t, ResponseEncodingSpec> fSpecs;
+  size_t fNPrecisionViolations = 0;
+
+  /// Event keys recorded for each filled entry in write mode.
+  std::vector<EventKey> fWrittenKeys;
+  size_t fNFilled = 0;
 
   void AllocateVectors(size_t NHeaders) {
     ids.clear();
     coeffs_1D.clear();
+    delta_coeffs_1D.clear();
 
     std::fill_n(std::back_inserter(ids), NHeaders, 0);
     std::fill_n(std::back_inserter(coeffs_1D), NHeaders * NCoeffs, 0);
+    if (fEncoding == ResponseEncoding::kFloat) {
+      std::fill_n(std::back_inserter(delta_coeffs_1D), NHeaders * NCoeffs, 0);
+    }
   }
 
   void SetBranchAddresses(TTree *tree) {
+    bool const IsFloat = (fEncoding == ResponseEncoding::kFloat);
     if (tree->SetBranchAddress("nids", &NIds) ||
         tree->SetBranchAddress("ids", ids.data()) ||
-        tree->SetBranchAddress("responses", coeffs_1D.data())) {
+        (IsFloat ? tree->SetBranchAddress("delta_responses",
+                                          delta_coeffs_1D.data())
+                 : tree->SetBranchAddress("responses", coeffs_1D.data()))) {
       throw missing_TBranches()
           << "[ERROR]: When trying to read precalculated response tree, failed "
              "to load all branches.";
@@ -61,9 +86,21 @@ private:
 
 public:
   PrecalculatedResponseReader() : file(nullptr), tree(nullptr) {}
+  PrecalculatedResponseReader(PrecalculatedResponseReader const &) = delete;
+  PrecalculatedResponseReader &
+  operator=(PrecalculatedResponseReader const &) = delete;
+  ~PrecalculatedResponseReader() {
+    if (file) {
+      file->Close();
+      delete file;
+    }
+  }
 
   ///\brief Constructor for instantiating a PrecalculatedResponseReader in read
   /// mode
+  ///
+  /// The storage precision is detected from the branches present on the input
+  /// tree.
   PrecalculatedResponseReader(std::string const &file_name,
                               std::string const &tree_name, size_t NHeaders) {
 
@@ -80,10 +117,22 @@ public:
           << " from file named: " << std::quoted(file_name);
     }
 
+    fEncoding = tree->GetBranch("delta_responses") ? ResponseEncoding::kFloat
+                                                   : ResponseEncoding::kDouble;
+
     AllocateVectors(NHeaders);
     SetBranchAddresses(tree);
   }
 
+  ResponseEncoding GetEncoding() const { return fEncoding; }
+
+  ///\brief The number of coefficients written with a larger error than the
+  /// ResponseEncodingMaxAbsError declared on the corresponding header.
+  ///
+  /// Parameters without a lossy encoding declaration are counted as violated
+  /// whenever the stored coefficient differs from the calculated one.
+  size_t GetNPrecisionViolations() const { return fNPrecisionViolations; }
+
   /// Gets the number of entries in an input tree when in read mode.
   size_t GetEntries() {
     if (!file || !tree) {
@@ -115,6 +164,14 @@ public:
     }
 
     tree->GetEntry(entry);
+    if (fEncoding == ResponseEncoding::kFloat) {
+      for (size_t c = 0; c < (size_t(NIds) * NCoeffs); ++c) {
+        coeffs_1D[c] = delta_coeffs_1D[c];
+      }
+      for (size_t p = 0; p < size_t(NIds); ++p) {
+        coeffs_1D[p * NCoeffs] += 1;
+      }
+    }
     std::vector<ParamPolyResponses> evresps;
     for (size_t p = 0; p < NIds; ++p) {
       evresps.push_back(ParamPolyResponses{
@@ -128,25 +185,89 @@ public:
   ///
   ///\note The tree ownership is not passed. The caller is responsible for
   /// proper storage and writing of the TTree.
+  ///
+  ///\note With ResponseEncoding::kFloat, coefficients are written as single
+  /// precision to a delta_responses branch, see GetNPrecisionViolations.
+  /// ResponseEncoding::kInt16 is not supported for fitted coefficients.
   static std::unique_ptr<PrecalculatedResponseReader<Order>>
-  MakeTreeWriter(param_header_map_t headers, TTree *tree) {
+  MakeTreeWriter(param_header_map_t headers, TTree *tree,
+                 ResponseEncoding encoding = ResponseEncoding::kDouble) {
+
+    if (encoding == ResponseEncoding::kInt16) {
+      throw unsupported_encoding()
+          << "[ERROR]: PrecalculatedResponseReader cannot store fitted "
+             "response coefficients with encoding: "
+          << to_str(encoding);
+    }
 
     std::unique_ptr<PrecalculatedResponseReader<Order>> wrtr =
         std::make_unique<PrecalculatedResponseReader<Order>>();
 
     wrtr->fHeaders = headers;
+    wrtr->fEncoding = encoding;
+    for (auto const &hdr_it : headers) {
+      wrtr->fSpecs[hdr_it.first] =
+          GetResponseEncodingSpec(hdr_it.second.Header);
+    }
 
     wrtr->AllocateVectors(headers.size());
     wrtr->tree = tree;
 
     wrtr->tree->Branch("nids", &wrtr->NIds, "nids/I");
     wrtr->tree->Branch("ids", wrtr->ids.data(), "ids[nids]/I");
-    std::string rspb = std::string("responses[nids][") +
-                       std::to_string(NCoeffs) + "]/D";
-    wrtr->tree->Branch("responses", wrtr->coeffs_1D.data(), rspb.c_str());
+    if (encoding == ResponseEncoding::kFloat) {
+      std::string rspb = std::string("delta_responses[nids][") +
+                         std::to_string(NCoeffs) + "]/F";
+      wrtr->tree->Branch("delta_responses", wrtr->delta_coeffs_1D.data(),
+                         rspb.c_str());
+    } else {
+      std::string rspb = std::string("responses[nids][") +
+                         std::to_string(NCoeffs) + "]/D";
+      wrtr->tree->Branch("responses", wrtr->coeffs_1D.data(), rspb.c_str());
+    }
 
     return wrtr;
   }
+  ///\brief As AddEventResponses(event_unit_response_t), but also records key
+  /// so that the entry can be found with an EventResponseIndex built by
+  /// BuildIndex.
+  void AddEventResponses(event_unit_response_t eur, EventKey const &key) {
+    if (fWrittenKeys.size() != fNFilled) {
+      throw in_wrong_mode()
+          << "[ERROR]: Attempted to fill keyed event response "
+          << to_str(key) << " after " << (fNFilled - fWrittenKeys.size())
+          << " un-keyed event responses were filled.";
+    }
+    fWrittenKeys.push_back(key);
+    AddEventResponses(std::move(eur));
+  }
+
+  ///\brief Builds a finalized index of all keyed entries filled so far.
+  ///
+  /// The index refers to the written tree as being in file_name. Indices for
+  /// many output files can be combined with EventResponseIndex::Merge.
+  EventResponseIndex BuildIndex(std::string const &file_name) const {
+    if (file) {
+      throw in_wrong_mode()
+          << "[ERROR]: Attempted to build an index from a "
+             "PrecalculatedResponseReader not instantiated by "
+             "PrecalculatedResponseReader::MakeTreeWriter.";
+    }
+    if (fWrittenKeys.size() != fNFilled) {
+      throw in_wrong_mode()
+          << "[ERROR]: Attempted to build an index, but only "
+          << fWrittenKeys.size() << "/" << fNFilled
+          << " filled event responses were keyed.";
+    }
+    EventResponseIndex idx(tree->GetName());
+    uint32_t fidx = idx.AddFile(file_name);
+    for (size_t e_it = 0; e_it < fWrittenKeys.size(); ++e_it) {
+      idx.Add(fWrittenKeys[e_it], fidx, e_it);
+    }
+    idx.Finalize();
+    return idx;
+  }
+
   ///\brief Converts discrete, splineable event responses to parameterized
   /// response functions and fills them to the tree.
   void AddEventResponses(event_unit_response_t eur) {
@@ -159,7 +280,7 @@ public:
 
     std::fill_n(coeffs_1D.data(), fHeaders.size() * NCoeffs, 0);
 
-    ScrubUnityEventResponses(eur);
+    ScrubUnityEventResponses(eur, fHeaders);
     NIds = 0;
     for (auto const &pr : eur) {
       if (fHeaders.find(pr.pid) == fHeaders.end()) {
@@ -176,10 +297,92 @@ public:
           PolyResponse<Order>(hdr.paramVariations, pr.responses);
 
       std::copy_n(&poly[0], NCoeffs, &coeffs_1D[NIds * NCoeffs]);
+      if (fEncoding == ResponseEncoding::kFloat) {
+        double MaxAbsError = fSpecs[pr.pid].MaxAbsError;
+        for (size_t c = 0; c < NCoeffs; ++c) {
+          double v = poly[c] - ((c == 0) ? 1 : 0);
+          Float_t fv = Float_t(v);
+          delta_coeffs_1D[NIds * NCoeffs + c] = fv;
+          if (!(std::fabs(double(fv) - v) <= MaxAbsError)) {
+            fNPrecisionViolations++;
+          }
+        }
+      }
       NIds++;
     }
     tree->Fill();
+    fNFilled++;
+  }
+};
+
+///\brief Random access to precalculated responses by EventKey across a chain
+/// of response files described by an EventResponseIndex.
+///
+/// One input file is held open at a time. Batched lookups are read in
+/// (file, entry) order, so that I/O is near-sequential however the keys are
+/// ordered.
+template <size_t Order> class IndexedPrecalculatedResponseReader {
+public:
+  typedef PrecalculatedResponseReader<Order> reader_t;
+  typedef std::vector<typename reader_t::ParamPolyResponses>
+      event_poly_response_t;
+
+  IndexedPrecalculatedResponseReader(EventResponseIndex index, size_t NHeaders)
+      : fIndex(std::move(index)), fNHeaders(NHeaders) {
+    if (!fIndex.IsFinalized()) {
+      fIndex.Finalize();
+    }
+  }
+  ///\brief Loads the index from a sidecar written by EventResponseIndex::Save.
+  IndexedPrecalculatedResponseReader(std::string const &sidecar_name,
+                                     size_t NHeaders)
+      : IndexedPrecalculatedResponseReader(
+            EventResponseIndex::Load(sidecar_name), NHeaders) {}
+
+  EventResponseIndex const &GetIndex() const { return fIndex; }
+
+  bool HasEventResponse(EventKey const &key) const {
+    return fIndex.Find(key);
   }
+
+  ///\brief Gets the precalculated responses for key.
+  ///
+  ///\note throws event_key_not_found if key is not indexed.
+  event_poly_response_t GetEventResponse(EventKey const &key) {
+    return GetEventResponse(fIndex.Get(key));
+  }
+
+  ///\brief Gets the precalculated responses for a batch of keys, returned in
+  /// the same order as keys.
+  std::vector<event_poly_response_t>
+  GetEventResponses(std::vector<EventKey> const &keys) {
+    std::vector<size_t> order;
+    std::vector<EventResponseIndex::Location> locs =
+        fIndex.FindBatch(keys, order);
+
+    std::vector<event_poly_response_t> resps(keys.size());
+    for (size_t l_it = 0; l_it < locs.size(); ++l_it) {
+      resps[order[l_it]] = GetEventResponse(locs[l_it]);
+    }
+    return resps;
+  }
+
+private:
+  event_poly_response_t
+  GetEventResponse(EventResponseIndex::Location const &loc) {
+    if (!fReader || (fOpenFile != loc.file)) {
+      fReader.reset();
+      fReader = std::make_unique<reader_t>(fIndex.GetFileName(loc.file),
+                                           fIndex.GetTreeName(), fNHeaders);
+      fOpenFile = loc.file;
+    }
+    return fReader->GetEventResponse(loc.entry);
+  }
+
+  EventResponseIndex fIndex;
+  size_t fNHeaders;
+  std::unique_ptr<reader_t> fReader;
+  uint32_t fOpenFile = 0;
 };
 } // namespace systtools
 
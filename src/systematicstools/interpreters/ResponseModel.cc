@@ -0,0 +1,115 @@
+#include "systematicstools/interpreters/ResponseModel.hh"
+
+#include <cmath>
+#include <iomanip>
+
+namespace systtools {
+
+std::string to_str(ResponseModel model) {
+  if (model == ResponseModel::kSpline) {
+    return "spline";
+  }
+  size_t order = GetPolyOrder(model);
+  if ((order < 1) || (order > kMaxResponsePolyOrder)) {
+    return "unknown";
+  }
+  return "poly" + std::to_string(order);
+}
+
+ResponseModel GetResponseModel(SystParamHeader const &hdr) {
+  std::string_view modelstr;
+  if (!hdr.opts.FindKV(kResponseModelOptKey, modelstr) ||
+      (modelstr == "spline")) {
+    return ResponseModel::kSpline;
+  }
+  if ((modelstr.size() == 5) && (modelstr.substr(0, 4) == "poly") &&
+      (modelstr[4] >= '1') &&
+      (modelstr[4] <= char('0' + kMaxResponsePolyOrder))) {
+    return GetPolyResponseModel(size_t(modelstr[4] - '0'));
+  }
+  throw invalid_response_model()
+      << "[ERROR]: SystParamHeader(" << hdr.systParamId << ":"
+      << std::quoted(hdr.prettyName) << ") declares unknown "
+      << kResponseModelOptKey << ": " << std::quoted(modelstr)
+      << ", expected one of spline, or poly1 to poly"
+      << kMaxResponsePolyOrder << ".";
+}
+
+void SetResponseModel(SystParamHeader &hdr, ResponseModel model) {
+  hdr.opts.SetKV(kResponseModelOptKey, to_str(model));
+}
+
+size_t FitPolyCoeffs(double const *x, double const *y, size_t n, size_t order,
+                     double *coeffs) {
+  std::fill_n(coeffs, order + 1, 0);
+  if (!n) {
+    return 0;
+  }
+  order = std::min(order, std::min(n - 1, kMaxResponsePolyOrder));
+  size_t const NCoeffs = order + 1;
+
+  // Normal equations, A a = b, in t = (x - shift) / scale.
+  double shift = (x[0] + x[n - 1]) / 2;
+  double scale = (n > 1) ? ((x[n - 1] - x[0]) / 2) : 1;
+  if (!(scale > 0)) {
+    scale = 1;
+  }
+  double A[kMaxResponsePolyOrder + 1][kMaxResponsePolyOrder + 2] = {};
+  for (size_t p_it = 0; p_it < n; ++p_it) {
+    double t = (x[p_it] - shift) / scale;
+    double tpow[2 * kMaxResponsePolyOrder + 1];
+    tpow[0] = 1;
+    for (size_t k = 1; k <= (2 * order); ++k) {
+      tpow[k] = tpow[k - 1] * t;
+    }
+    for (size_t j = 0; j < NCoeffs; ++j) {
+      for (size_t k = 0; k < NCoeffs; ++k) {
+        A[j][k] += tpow[j + k];
+      }
+      A[j][NCoeffs] += y[p_it] * tpow[j];
+    }
+  }
+
+  // Gaussian elimination with partial pivoting on the augmented matrix.
+  for (size_t c = 0; c < NCoeffs; ++c) {
+    size_t pivot = c;
+    for (size_t r = c + 1; r < NCoeffs; ++r) {
+      if (std::fabs(A[r][c]) > std::fabs(A[pivot][c])) {
+        pivot = r;
+      }
+    }
+    if (pivot != c) {
+      for (size_t k = 0; k <= NCoeffs; ++k) {
+        std::swap(A[c][k], A[pivot][k]);
+      }
+    }
+    for (size_t r = c + 1; r < NCoeffs; ++r) {
+      double f = A[r][c] / A[c][c];
+      for (size_t k = c; k <= NCoeffs; ++k) {
+        A[r][k] -= f * A[c][k];
+      }
+    }
+  }
+  double a[kMaxResponsePolyOrder + 1];
+  for (size_t c = NCoeffs; c-- > 0;) {
+    double sum = A[c][NCoeffs];
+    for (size_t k = c + 1; k < NCoeffs; ++k) {
+      sum -= A[c][k] * a[k];
+    }
+    a[c] = sum / A[c][c];
+  }
+
+  // Expand sum_k a_k ((x - shift) / scale)^k in powers of x.
+  for (size_t k = 0; k < NCoeffs; ++k) {
+    double ak = a[k] / std::pow(scale, double(k));
+    // binom * (-shift)^(k - j), for j = k down to 0.
+    double term = 1;
+    for (size_t j = k + 1; j-- > 0;) {
+      coeffs[j] += ak * term;
+      term *= -shift * double(j) / double(k - j + 1);
+    }
+  }
+  return order;
+}
+
+} // namespace systtools
@@ -0,0 +1,122 @@
+#ifndef SYSTTOOLS_INTERPRETERS_RESPONSEMODEL_SEEN
+#define SYSTTOOLS_INTERPRETERS_RESPONSEMODEL_SEEN
+
+#include "systematicstools/interface/SystParamHeader.hh"
+#include "systematicstools/interface/types.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace systtools {
+
+///\brief Exception raised when a header declares an unknown response model.
+NEW_SYSTTOOLS_EXCEPT(invalid_response_model);
+
+///\brief The function used to represent a spline parameter's response when it
+/// is cached.
+///
+/// * kSpline: Interpolates the responses at the knots with the declared
+/// InterpolationScheme, the default.
+/// * kPoly1 ... kPoly5: A least squares polynomial fit, of that order, to the
+/// responses at the knots. Evaluation needs no knot search, and so is
+/// cheaper than any interpolation, but it only reproduces the responses
+/// approximately. See ResponseModelSelector.
+enum class ResponseModel { kSpline, kPoly1, kPoly2, kPoly3, kPoly4, kPoly5 };
+
+/// SystParamHeader::opts key used to declare a ResponseModel
+/// (spline/poly1/.../poly5).
+constexpr char const *kResponseModelOptKey = "ResponseModel";
+
+///\brief The highest order of polynomial response model.
+constexpr size_t kMaxResponsePolyOrder = 5;
+
+std::string to_str(ResponseModel);
+
+///\brief The polynomial order of a model, 0 for kSpline.
+inline size_t GetPolyOrder(ResponseModel model) {
+  return size_t(model) - size_t(ResponseModel::kSpline);
+}
+///\brief The polynomial model of order, 1 <= order <= kMaxResponsePolyOrder.
+inline ResponseModel GetPolyResponseModel(size_t order) {
+  return ResponseModel(size_t(ResponseModel::kSpline) + order);
+}
+
+///\brief Gets the response model declared for a parameter, kSpline if none is
+/// declared.
+///
+///\note throws invalid_response_model for unknown models.
+ResponseModel GetResponseModel(SystParamHeader const &hdr);
+
+///\brief Declares the response model of a parameter.
+void SetResponseModel(SystParamHeader &hdr, ResponseModel);
+
+///\brief Evaluates the polynomial with coefficients c[0] ... c[order] at v.
+inline double EvalPolyCoeffs(double const *c, size_t order, double v) {
+  double val = c[order];
+  for (size_t i = order; i-- > 0;) {
+    val = (val * v) + c[i];
+  }
+  return val;
+}
+
+///\brief Evaluates the derivative of the polynomial with coefficients
+/// c[0] ... c[order] at v.
+inline double EvalPolyCoeffsDerivative(double const *c, size_t order,
+                                       double v) {
+  if (!order) {
+    return 0;
+  }
+  double val = double(order) * c[order];
+  for (size_t i = order - 1; i > 0; --i) {
+    val = (val * v) + (double(i) * c[i]);
+  }
+  return val;
+}
+
+///\brief Least squares fit of a polynomial of order to the n points (x, y),
+/// writing the order + 1 coefficients of increasing powers of x to coeffs.
+///
+/// The fit is made in x shifted and scaled to [-1, 1], so is well
+/// conditioned for any spread of knots. If there are too few points for the
+/// order, the highest order that they determine is used, and the remaining
+/// coefficients are 0. Returns the order used.
+///
+///\note x must be strictly increasing.
+size_t FitPolyCoeffs(double const *x, double const *y, size_t n, size_t order,
+                     double *coeffs);
+
+///\brief ROOT-free polynomial response function, with its order chosen at
+/// runtime, up to kMaxResponsePolyOrder.
+///
+/// Unlike PolyResponse, which fits with TF1, the fit is deterministic and
+/// allocation-free, so can be made for every cached event.
+class ResponsePolynomial {
+  std::array<double, kMaxResponsePolyOrder + 1> fCoeffs;
+  size_t fOrder;
+
+public:
+  ResponsePolynomial() : fCoeffs{}, fOrder(0) {}
+  ///\brief Fits a polynomial of order, or less, see FitPolyCoeffs.
+  ResponsePolynomial(double const *x, double const *y, size_t n, size_t order)
+      : fCoeffs{} {
+    fOrder = FitPolyCoeffs(x, y, n, std::min(order, kMaxResponsePolyOrder),
+                           fCoeffs.data());
+  }
+
+  size_t GetOrder() const { return fOrder; }
+  double const *GetCoeffs() const { return fCoeffs.data(); }
+
+  double Eval(double v) const {
+    return EvalPolyCoeffs(fCoeffs.data(), fOrder, v);
+  }
+  double Derivative(double v) const {
+    return EvalPolyCoeffsDerivative(fCoeffs.data(), fOrder, v);
+  }
+};
+
+} // namespace systtools
+
+#endif
@@ -0,0 +1,170 @@
+#include "systematicstools/interpreters/ResponseModelSelector.hh"
+
+#include <cmath>
+
+namespace systtools {
+
+constexpr size_t ResponseModelSelector::kNCandidates;
+
+std::array<ResponseModelSelector::Candidate,
+           ResponseModelSelector::kNCandidates> const &
+ResponseModelSelector::GetCandidates() {
+  static std::array<Candidate, kNCandidates> const candidates{
+      {{ResponseModel::kPoly1, InterpolationScheme::kCubicSpline},
+       {ResponseModel::kPoly2, InterpolationScheme::kCubicSpline},
+       {ResponseModel::kPoly3, InterpolationScheme::kCubicSpline},
+       {ResponseModel::kPoly4, InterpolationScheme::kCubicSpline},
+       {ResponseModel::kPoly5, InterpolationScheme::kCubicSpline},
+       {ResponseModel::kSpline, InterpolationScheme::kLinear}}};
+  return candidates;
+}
+
+double ResponseModelSelector::ParamResiduals::GetRMSResidual(
+    size_t c_it) const {
+  return NPoints ? std::sqrt(SumSqResidual[c_it] / double(NPoints)) : 0;
+}
+
+ResponseModelSelector::ResponseModelSelector(
+    param_header_map_t const &headers, Config const &cfg)
+    : fConfig(cfg) {
+  for (auto const &hdr_it : headers) {
+    SystParamHeader const &hdr = hdr_it.second.Header;
+    if (!hdr.isSplineable || hdr.isResponselessParam ||
+        (hdr.paramVariations.size() < 2)) {
+      continue;
+    }
+    Param p;
+    p.Residuals.pid = hdr_it.first;
+    p.Residuals.NResponseSets = 0;
+    p.Residuals.NSkipped = 0;
+    p.Residuals.NPoints = 0;
+    p.Residuals.MaxAbsResidual.fill(0);
+    p.Residuals.SumSqResidual.fill(0);
+    p.Scheme = GetInterpolationScheme(hdr);
+    p.DiffersEventByEvent = hdr.differsEventByEvent;
+    p.Knots = hdr.paramVariations.get();
+
+    size_t NKnots = p.Knots.size();
+    size_t NSteps = fConfig.NPointsPerInterval + 1;
+    for (size_t k_it = 0; (k_it + 1) < NKnots; ++k_it) {
+      double h = p.Knots[k_it + 1] - p.Knots[k_it];
+      for (size_t s_it = 0; s_it < NSteps; ++s_it) {
+        p.PointKnots.push_back(k_it);
+        p.PointDx.push_back(h * double(s_it) / double(NSteps));
+      }
+    }
+    p.PointKnots.push_back(NKnots - 2);
+    p.PointDx.push_back(p.Knots[NKnots - 1] - p.Knots[NKnots - 2]);
+
+    Param &added = fParams.emplace(hdr_it.first, std::move(p)).first->second;
+    if (!hdr.differsEventByEvent) {
+      Compare(added, hdr.responses);
+    }
+  }
+}
+
+void ResponseModelSelector::Add(event_unit_response_t const &eur) {
+  for (ParamResponses const &pr : eur) {
+    auto p_it = fParams.find(pr.pid);
+    // Parameters that do not differ event by event were compared on
+    // construction.
+    if ((p_it == fParams.end()) || !p_it->second.DiffersEventByEvent) {
+      continue;
+    }
+    Compare(p_it->second, pr.responses);
+  }
+}
+
+void ResponseModelSelector::Add(EventResponse const &er) {
+  for (event_unit_response_t const &eur : er) {
+    Add(eur);
+  }
+}
+
+void ResponseModelSelector::Compare(Param &p,
+                                    std::vector<double> const &responses) {
+  size_t NKnots = p.Knots.size();
+  if (responses.size() != NKnots) {
+    p.Residuals.NSkipped++;
+    return;
+  }
+  fRefCoeffs.resize(kNSplineCoeffs * NKnots);
+  fLinearCoeffs.resize(kNSplineCoeffs * NKnots);
+  BuildInterpolationCoeffs(p.Scheme, p.Knots.data(), responses.data(), NKnots,
+                           fRefCoeffs.data());
+  LinearInterpolation::Build(p.Knots.data(), responses.data(), NKnots,
+                             fLinearCoeffs.data());
+  std::array<ResponsePolynomial, kMaxResponsePolyOrder> polys;
+  for (size_t o_it = 0; o_it < kMaxResponsePolyOrder; ++o_it) {
+    polys[o_it] = ResponsePolynomial(p.Knots.data(), responses.data(), NKnots,
+                                     o_it + 1);
+  }
+
+  std::array<Candidate, kNCandidates> const &candidates = GetCandidates();
+  ParamResiduals &res = p.Residuals;
+  for (size_t pt_it = 0; pt_it < p.PointKnots.size(); ++pt_it) {
+    size_t k = p.PointKnots[pt_it];
+    double dx = p.PointDx[pt_it];
+    double v = p.Knots[k] + dx;
+    double ref = EvalSplineCoeffs(fRefCoeffs.data(), k, dx);
+    for (size_t c_it = 0; c_it < kNCandidates; ++c_it) {
+      size_t order = GetPolyOrder(candidates[c_it].Model);
+      double resp = order ? polys[order - 1].Eval(v)
+                          : LinearInterpolation::Eval(fLinearCoeffs.data(), k,
+                                                      dx);
+      double r = std::fabs(resp - ref);
+      // Written so that a NaN residual is kept, and never accepted.
+      if (!(r <= res.MaxAbsResidual[c_it])) {
+        res.MaxAbsResidual[c_it] = r;
+      }
+      res.SumSqResidual[c_it] += r * r;
+    }
+  }
+  res.NPoints += p.PointKnots.size();
+  res.NResponseSets++;
+}
+
+std::vector<ResponseModelSelector::ParamResiduals>
+ResponseModelSelector::GetResiduals() const {
+  std::vector<ParamResiduals> rtn;
+  for (auto const &p_it : fParams) {
+    rtn.push_back(p_it.second.Residuals);
+  }
+  return rtn;
+}
+
+std::vector<ResponseModelSelector::Selection>
+ResponseModelSelector::Select(param_header_map_t &headers) const {
+  std::vector<Selection> rtn;
+  std::array<Candidate, kNCandidates> const &candidates = GetCandidates();
+  for (auto const &p_it : fParams) {
+    Param const &p = p_it.second;
+    auto hdr_it = headers.find(p_it.first);
+    if (!p.Residuals.NResponseSets || (hdr_it == headers.end())) {
+      continue;
+    }
+    SystParamHeader &hdr = hdr_it->second.Header;
+
+    Selection sel{p_it.first, ResponseModel::kSpline, p.Scheme, false, 0};
+    for (size_t c_it = 0; c_it < kNCandidates; ++c_it) {
+      if (p.Residuals.MaxAbsResidual[c_it] <= fConfig.Tolerance) {
+        sel.Model = candidates[c_it].Model;
+        if (sel.Model == ResponseModel::kSpline) {
+          sel.Scheme = candidates[c_it].Scheme;
+        }
+        sel.Accepted = true;
+        sel.MaxAbsResidual = p.Residuals.MaxAbsResidual[c_it];
+        break;
+      }
+    }
+
+    SetResponseModel(hdr, sel.Model);
+    if (sel.Scheme != p.Scheme) {
+      SetInterpolationScheme(hdr, sel.Scheme);
+    }
+    rtn.push_back(sel);
+  }
+  return rtn;
+}
+
+} // namespace systtools
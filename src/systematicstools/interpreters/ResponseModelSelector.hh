@@ -0,0 +1,127 @@
+#ifndef SYSTTOOLS_INTERPRETERS_RESPONSEMODELSELECTOR_SEEN
+#define SYSTTOOLS_INTERPRETERS_RESPONSEMODELSELECTOR_SEEN
+
+#include "systematicstools/interface/EventResponse_product.hh"
+#include "systematicstools/interface/SystMetaData.hh"
+#include "systematicstools/interface/types.hh"
+
+#include "systematicstools/interpreters/InterpolationSchemes.hh"
+#include "systematicstools/interpreters/ResponseModel.hh"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace systtools {
+
+///\brief Chooses, for each spline parameter, the cheapest representation of
+/// its responses that reproduces the interpolated responses of a sample of
+/// events to within a tolerance.
+///
+/// The candidates, in order of increasing evaluation cost, are the
+/// polynomial response models of orders 1 to 5, which need no knot search,
+/// and then linear interpolation. Each is compared to the parameter's
+/// declared InterpolationScheme at the knots and at
+/// Config::NPointsPerInterval points within each knot interval, for every
+/// event unit response passed to Add. Parameters that do not differ event by
+/// event are compared once, using their header responses.
+///
+/// Select records the choice in the header opts, as a ResponseModel, or for
+/// linear interpolation, as an InterpolationScheme. Parameters for which no
+/// candidate is within tolerance keep their declared interpolation.
+/// EventSplineCache honours both options.
+///
+///\note The tolerance is on the absolute difference between responses, for
+/// weight responses this is the difference in the weight.
+class ResponseModelSelector {
+public:
+  struct Config {
+    ///\brief The largest absolute difference from the interpolated response
+    /// that is accepted.
+    double Tolerance;
+    ///\brief The points compared within each knot interval, in addition to
+    /// the knots.
+    size_t NPointsPerInterval;
+
+    Config() : Tolerance(1E-3), NPointsPerInterval(8) {}
+  };
+
+  ///\brief A candidate representation, Scheme is only used when Model is
+  /// kSpline.
+  struct Candidate {
+    ResponseModel Model;
+    InterpolationScheme Scheme;
+  };
+  static constexpr size_t kNCandidates = kMaxResponsePolyOrder + 1;
+  ///\brief The candidates, in order of increasing evaluation cost.
+  static std::array<Candidate, kNCandidates> const &GetCandidates();
+
+  ///\brief The residuals of each candidate for one parameter.
+  struct ParamResiduals {
+    paramId_t pid;
+    ///\brief The number of response sets compared.
+    size_t NResponseSets;
+    ///\brief The number of response sets skipped because their number of
+    /// responses differed from the number of knots.
+    size_t NSkipped;
+    ///\brief The number of points compared.
+    size_t NPoints;
+    std::array<double, kNCandidates> MaxAbsResidual;
+    std::array<double, kNCandidates> SumSqResidual;
+
+    double GetRMSResidual(size_t c_it) const;
+  };
+
+  ///\brief The representation chosen for one parameter.
+  struct Selection {
+    paramId_t pid;
+    ResponseModel Model;
+    InterpolationScheme Scheme;
+    ///\brief Whether a candidate was within tolerance.
+    bool Accepted;
+    ///\brief The largest residual of the chosen candidate, 0 if none was
+    /// accepted.
+    double MaxAbsResidual;
+  };
+
+  ///\note throws invalid_interpolation_scheme if a header declares an unknown
+  /// interpolation scheme.
+  ResponseModelSelector(param_header_map_t const &headers,
+                        Config const &cfg = Config());
+
+  ///\brief Compares the candidates for each spline parameter response of an
+  /// event unit.
+  void Add(event_unit_response_t const &eur);
+  void Add(EventResponse const &er);
+
+  ///\brief The residuals, in parameter Id order.
+  std::vector<ParamResiduals> GetResiduals() const;
+
+  ///\brief Chooses the cheapest candidate within tolerance for every
+  /// parameter that has been compared, and records the choice in the opts of
+  /// its header in headers.
+  std::vector<Selection> Select(param_header_map_t &headers) const;
+
+private:
+  struct Param {
+    ParamResiduals Residuals;
+    InterpolationScheme Scheme;
+    bool DiffersEventByEvent;
+    std::vector<double> Knots;
+    ///\brief The interval and offset into it of each compared point.
+    std::vector<size_t> PointKnots;
+    std::vector<double> PointDx;
+  };
+
+  void Compare(Param &p, std::vector<double> const &responses);
+
+  Config fConfig;
+  std::map<paramId_t, Param> fParams;
+
+  std::vector<double> fRefCoeffs;
+  std::vector<double> fLinearCoeffs;
+};
+
+} // namespace systtools
+
+#endif
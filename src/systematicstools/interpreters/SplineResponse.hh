@@ -0,0 +1,336 @@
+#ifndef SYSTTOOLS_INTERPRETERS_SPLINERESPONSE_SEEN
+#define SYSTTOOLS_INTERPRETERS_SPLINERESPONSE_SEEN
+
+#include "systematicstools/utility/MemoryFootprint.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace systtools {
+
+///\brief The number of coefficients stored per knot by BuildSplineCoeffs.
+static const size_t kNSplineCoeffs = 4;
+
+///\brief Builds cubic spline coefficients through the n points (x, y).
+///
+/// For each knot, i, four coefficients are written to
+/// coeffs[kNSplineCoeffs*i ... kNSplineCoeffs*i + 3], such that within the
+/// interval [x_i, x_{i+1}]:
+///
+///   f(v) = y_i + dx*(b_i + dx*(c_i + dx*d_i)), dx = v - x_i
+///
+/// The not-a-knot end conditions are used, which reproduces the coefficients
+/// of a TSpline3 built from the same arrays without end-point derivatives, so
+/// that responses evaluated from these coefficients match those from
+/// ParamHeaderHelper::GetSpline. n == 2 gives a straight line, and n == 3 a
+/// single parabola.
+///
+///\note x must be strictly increasing.
+inline void BuildSplineCoeffs(double const *x, double const *y, size_t n,
+                              double *coeffs) {
+  // Named access to the interleaved coefficient storage, Y, B, C, D follow
+  // the naming of the TSplinePoly3 members.
+  double *cf = coeffs;
+  auto Y = [cf](size_t i) -> double & { return cf[kNSplineCoeffs * i]; };
+  auto B = [cf](size_t i) -> double & { return cf[kNSplineCoeffs * i + 1]; };
+  auto C = [cf](size_t i) -> double & { return cf[kNSplineCoeffs * i + 2]; };
+  auto D = [cf](size_t i) -> double & { return cf[kNSplineCoeffs * i + 3]; };
+
+  for (size_t i = 0; i < n; ++i) {
+    Y(i) = y[i];
+    B(i) = 0;
+    C(i) = 0;
+    D(i) = 0;
+  }
+  if (n < 2) {
+    return;
+  }
+
+  // A tridiagonal linear system for the slopes at each knot is generated and
+  // then solved by gaussian elimination, with the slopes ending up in B.
+  // C and D are used initially for temporary storage. (de Boor, cubspl)
+  size_t l = n - 1;
+  for (size_t m = 1; m < n; ++m) {
+    C(m) = x[m] - x[m - 1];
+    D(m) = (Y(m) - Y(m - 1)) / C(m);
+  }
+
+  // First equation, from the not-a-knot condition at the left end.
+  if (n == 2) {
+    D(0) = 1;
+    C(0) = 1;
+    B(0) = 2 * D(1);
+  } else {
+    D(0) = C(2);
+    C(0) = C(1) + C(2);
+    B(0) = ((C(1) + 2 * C(0)) * D(1) * C(2) + C(1) * C(1) * D(2)) / C(0);
+  }
+
+  if (n == 2) {
+    B(1) = D(1);
+  } else {
+    // Interior knots, forward pass of gaussian elimination.
+    double g = 0;
+    for (size_t m = 1; m < l; ++m) {
+      g = -C(m + 1) / D(m - 1);
+      B(m) = g * B(m - 1) + 3 * (C(m) * D(m + 1) + C(m + 1) * D(m));
+      D(m) = g * C(m - 1) + 2 * (C(m) + C(m + 1));
+    }
+    // Last equation, from the not-a-knot condition at the right end.
+    if (n > 3) {
+      g = C(n - 2) + C(n - 1);
+      B(n - 1) = ((C(n - 1) + 2 * g) * D(n - 1) * C(n - 2) +
+                  C(n - 1) * C(n - 1) * (Y(n - 2) - Y(n - 3)) / C(n - 2)) /
+                 g;
+      g = -g / D(n - 2);
+      D(n - 1) = C(n - 2);
+    } else {
+      B(n - 1) = 2 * D(n - 1);
+      D(n - 1) = 1;
+      g = -1 / D(n - 2);
+    }
+    // Complete the forward pass.
+    D(n - 1) = g * C(n - 2) + D(n - 1);
+    B(n - 1) = (g * B(n - 2) + B(n - 1)) / D(n - 1);
+  }
+
+  // Back substitution.
+  for (size_t j = l; j-- > 0;) {
+    B(j) = (B(j) - C(j) * B(j + 1)) / D(j);
+  }
+
+  // Cubic coefficients in each interval from the values and slopes at its
+  // end points.
+  for (size_t i = 1; i < n; ++i) {
+    double dtau = x[i] - x[i - 1];
+    double divdf1 = (Y(i) - Y(i - 1)) / dtau;
+    double divdf3 = B(i - 1) + B(i) - 2 * divdf1;
+    C(i - 1) = (divdf1 - B(i - 1) - divdf3) / dtau;
+    D(i - 1) = (divdf3 / dtau) / dtau;
+  }
+  C(n - 1) = 0;
+  D(n - 1) = 0;
+}
+
+///\brief Finds the knot at the start of the interval used to evaluate a
+/// spline at v.
+///
+/// Values outside of the knot range are extrapolated with the first or last
+/// interval, as TSpline3::Eval does, and a value on an interior knot uses the
+/// interval to its left. The search is branch-free: the interval is the number
+/// of interior knots below v, which is counted by a binary search whose steps
+/// compile to conditional moves rather than unpredictable branches.
+inline size_t FindSplineKnot(double const *x, size_t n, double v) {
+  if (n < 3) {
+    return 0;
+  }
+  double const *interior = x + 1;
+  size_t lo = 0;
+  size_t len = n - 2;
+  while (len > 1) {
+    size_t half = len / 2;
+    lo = (interior[lo + half - 1] < v) ? (lo + half) : lo;
+    len -= half;
+  }
+  return lo + size_t(interior[lo] < v);
+}
+
+///\brief Finds the same knot as FindSplineKnot, for knots that are, to within
+/// rounding, uniformly spaced with inverse spacing inv_step, by direct index
+/// arithmetic.
+///
+/// The computed index is corrected by at most one knot against the knots
+/// themselves, so the result is identical to FindSplineKnot for any grid
+/// accepted by IsUniformKnotGrid.
+inline size_t FindUniformSplineKnot(double const *x, size_t n,
+                                    double inv_step, double v) {
+  if ((n < 2) || !(v > x[0])) {
+    return 0;
+  }
+  if (v >= x[n - 1]) {
+    return n - 2;
+  }
+  size_t k = std::min(size_t((v - x[0]) * inv_step), n - 2);
+  if (!(x[k] < v)) {
+    --k;
+  } else if (!(v <= x[k + 1])) {
+    ++k;
+  }
+  return k;
+}
+
+///\brief Whether the n knots x are uniformly spaced, such that
+/// FindUniformSplineKnot can be used.
+///
+/// Knots generated from a (start,end,step) descriptor accumulate rounding, so
+/// each knot may differ from the ideal grid by up to tolerance of a step.
+inline bool IsUniformKnotGrid(double const *x, size_t n,
+                              double tolerance = 1E-6) {
+  if (n < 3) {
+    return false;
+  }
+  double step = (x[n - 1] - x[0]) / double(n - 1);
+  if (!(step > 0)) {
+    return false;
+  }
+  for (size_t k_it = 1; k_it < (n - 1); ++k_it) {
+    if (std::fabs(x[k_it] - (x[0] + (double(k_it) * step))) >
+        (tolerance * step)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+///\brief Spline knots, with the interval lookup chosen once, when they are
+/// set, from their spacing.
+///
+/// Uniform grids use FindUniformSplineKnot, and irregular grids the
+/// branch-free binary search of FindSplineKnot. Both give identical results.
+class SplineKnots {
+  std::vector<double> fKnots;
+  double fInvStep;
+  bool fIsUniform;
+
+public:
+  SplineKnots() : fInvStep(0), fIsUniform(false) {}
+  SplineKnots(std::vector<double> knots) : fKnots(std::move(knots)) {
+    fIsUniform = IsUniformKnotGrid(fKnots.data(), fKnots.size());
+    fInvStep = fIsUniform ? (double(fKnots.size() - 1) /
+                             (fKnots.back() - fKnots.front()))
+                          : 0;
+  }
+
+  size_t Find(double v) const {
+    return fIsUniform
+               ? FindUniformSplineKnot(fKnots.data(), fKnots.size(), fInvStep,
+                                       v)
+               : FindSplineKnot(fKnots.data(), fKnots.size(), v);
+  }
+  bool IsUniform() const { return fIsUniform; }
+
+  std::vector<double> const &get() const { return fKnots; }
+  double const *data() const { return fKnots.data(); }
+  size_t size() const { return fKnots.size(); }
+  bool empty() const { return fKnots.empty(); }
+  double operator[](size_t k) const { return fKnots[k]; }
+};
+
+namespace footprint {
+inline size_t HeapBytes(SplineKnots const &knots) {
+  return HeapBytes(knots.get());
+}
+} // namespace footprint
+
+///\brief Evaluates the spline coefficients of knot k at distance dx from the
+/// knot.
+inline double EvalSplineCoeffs(double const *coeffs, size_t k, double dx) {
+  double const *p = coeffs + kNSplineCoeffs * k;
+  return p[0] + dx * (p[1] + dx * (p[2] + dx * p[3]));
+}
+
+///\brief Evaluates the derivative of the spline coefficients of knot k at
+/// distance dx from the knot.
+inline double EvalSplineCoeffsDerivative(double const *coeffs, size_t k,
+                                         double dx) {
+  double const *p = coeffs + kNSplineCoeffs * k;
+  return p[1] + dx * (2 * p[2] + dx * 3 * p[3]);
+}
+
+///\brief Evaluates the spline through knots x, with coefficients built by
+/// BuildSplineCoeffs, at v.
+inline double EvalSpline(double const *x, double const *coeffs, size_t n,
+                         double v) {
+  if (!n) {
+    return 0;
+  }
+  size_t k = FindSplineKnot(x, n, v);
+  return EvalSplineCoeffs(coeffs, k, v - x[k]);
+}
+
+///\brief Evaluates the derivative, with respect to v, of the spline through
+/// knots x at v.
+inline double EvalSplineDerivative(double const *x, double const *coeffs,
+                                   size_t n, double v) {
+  if (!n) {
+    return 0;
+  }
+  size_t k = FindSplineKnot(x, n, v);
+  return EvalSplineCoeffsDerivative(coeffs, k, v - x[k]);
+}
+
+///\brief Evaluates the spline through knots x at v, and sets deriv to its
+/// derivative, with a single knot search.
+inline double EvalSplineAndDerivative(double const *x, double const *coeffs,
+                                      size_t n, double v, double &deriv) {
+  if (!n) {
+    deriv = 0;
+    return 0;
+  }
+  size_t k = FindSplineKnot(x, n, v);
+  deriv = EvalSplineCoeffsDerivative(coeffs, k, v - x[k]);
+  return EvalSplineCoeffs(coeffs, k, v - x[k]);
+}
+
+///\brief ROOT-free, self-contained cubic spline response.
+///
+/// Equivalent to a TSpline3 built from the same knots and responses, see
+/// BuildSplineCoeffs.
+class SplineResponse {
+  SplineKnots fKnots;
+  std::vector<double> fCoeffs;
+
+public:
+  SplineResponse() {}
+  SplineResponse(std::vector<double> const &knots,
+                 std::vector<double> const &responses)
+      : fKnots(knots), fCoeffs(kNSplineCoeffs * knots.size()) {
+    BuildSplineCoeffs(fKnots.data(), responses.data(), fKnots.size(),
+                      fCoeffs.data());
+  }
+
+  size_t GetNKnots() const { return fKnots.size(); }
+  std::vector<double> const &GetKnots() const { return fKnots.get(); }
+  bool HasUniformKnots() const { return fKnots.IsUniform(); }
+  std::vector<double> const &GetCoeffs() const { return fCoeffs; }
+
+  ///\brief The memory owned by the knots and coefficients, reported as
+  /// "splines".
+  MemoryBreakdown MemoryFootprint() const {
+    MemoryBreakdown mb;
+    mb.Add("splines",
+           footprint::HeapBytes(fKnots) + footprint::HeapBytes(fCoeffs));
+    return mb;
+  }
+
+  double Eval(double v) const {
+    if (fKnots.empty()) {
+      return 0;
+    }
+    size_t k = fKnots.Find(v);
+    return EvalSplineCoeffs(fCoeffs.data(), k, v - fKnots[k]);
+  }
+  double Derivative(double v) const {
+    if (fKnots.empty()) {
+      return 0;
+    }
+    size_t k = fKnots.Find(v);
+    return EvalSplineCoeffsDerivative(fCoeffs.data(), k, v - fKnots[k]);
+  }
+  ///\brief Evaluates the response at v, and sets deriv to its derivative.
+  double EvalWithDerivative(double v, double &deriv) const {
+    if (fKnots.empty()) {
+      deriv = 0;
+      return 0;
+    }
+    size_t k = fKnots.Find(v);
+    deriv = EvalSplineCoeffsDerivative(fCoeffs.data(), k, v - fKnots[k]);
+    return EvalSplineCoeffs(fCoeffs.data(), k, v - fKnots[k]);
+  }
+};
+
+} // namespace systtools
+
+#endif
@@ -0,0 +1,384 @@
+#include "systematicstools/interpreters/ValidatedResponseView.hh"
+
+#include <sstream>
+
+namespace systtools {
+
+constexpr size_t ValidatedResponseView::npos;
+
+ValidatedResponseView::ValidatedResponseView(
+    param_header_map_t const &headers, EventResponse const &er,
+    ParamValidationAndErrorResponse const &chkerr)
+    : fHeaders(headers), fChkErr(chkerr), fNEventUnits(er.size()),
+      fNFailedValidations(0) {
+
+  std::vector<SystParamHeader const *> column_headers;
+  for (auto const &hdr_it : fHeaders) {
+    SystParamHeader const &hdr = hdr_it.second.Header;
+    if (hdr.isResponselessParam) {
+      continue;
+    }
+    Column col;
+    col.pid = hdr_it.first;
+    col.IsSpline = hdr.isSplineable;
+    col.IsWeight = hdr.isWeightSystematicVariation;
+    col.Unusable = false;
+    col.NResponses = hdr.paramVariations.size();
+    col.LowLimit = (hdr.paramValidityRange[0] != kDefaultDouble)
+                       ? hdr.paramValidityRange[0]
+                       : -std::numeric_limits<double>::infinity();
+    col.UpLimit = (hdr.paramValidityRange[1] != kDefaultDouble)
+                      ? hdr.paramValidityRange[1]
+                      : std::numeric_limits<double>::infinity();
+    col.Default = col.IsWeight ? 1 : 0;
+    col.GlobalOffset = npos;
+    col.ErrorOffset = npos;
+    col.Scheme = InterpolationScheme::kCubicSpline;
+
+    if (col.IsSpline) {
+      col.Knots = hdr.paramVariations.get();
+      try {
+        col.Scheme = GetInterpolationScheme(hdr);
+      } catch (invalid_interpolation_scheme const &) {
+        std::stringstream ss;
+        ss << "Spline parameter " << hdr.prettyName << " (" << col.pid
+           << ") declares an unknown " << kInterpolationOptKey << ".";
+        Fail(ss.str());
+        col.Unusable = true;
+      }
+      if (!col.NResponses) {
+        std::stringstream ss;
+        ss << "Spline parameter " << hdr.prettyName << " (" << col.pid
+           << ") has no knots.";
+        Fail(ss.str());
+        col.Unusable = true;
+      }
+      for (size_t k_it = 1; k_it < col.NResponses; ++k_it) {
+        if (!(col.Knots[k_it] > col.Knots[k_it - 1])) {
+          std::stringstream ss;
+          ss << "Spline parameter " << hdr.prettyName << " (" << col.pid
+             << ") knots are not strictly increasing: knot " << (k_it - 1)
+             << " = " << col.Knots[k_it - 1] << ", knot " << k_it << " = "
+             << col.Knots[k_it] << ".";
+          Fail(ss.str());
+          col.Unusable = true;
+          break;
+        }
+      }
+    }
+
+    if (!col.Unusable && !hdr.differsEventByEvent) {
+      col.GlobalOffset = AppendResponses(col, hdr, hdr.responses, npos);
+    }
+
+    fColumns.push_back(std::move(col));
+    fColumnParamIds.push_back(hdr_it.first);
+    column_headers.push_back(&hdr);
+  }
+
+  // Validate every event unit response once, slots are appended per event
+  // unit and then sorted by column.
+  fUnitSlotOffsets.reserve(fNEventUnits + 1);
+  fUnitSlotOffsets.push_back(0);
+  for (size_t eu_it = 0; eu_it < fNEventUnits; ++eu_it) {
+    size_t first_slot = fUnitSlots.size();
+    for (ParamResponses const &pr : er[eu_it]) {
+      size_t column = GetColumn(pr.pid);
+      if (column == npos) {
+        std::stringstream ss;
+        ss << "Event unit " << eu_it << " contains a response to parameter "
+           << pr.pid << ", but "
+           << (fHeaders.count(pr.pid) ? "it is a responseless parameter."
+                                      : "it is not currently configured.");
+        Fail(ss.str());
+        fNFailedValidations++;
+        continue;
+      }
+      Column &col = fColumns[column];
+      if (col.Unusable) {
+        fNFailedValidations++;
+        continue;
+      }
+      bool duplicate = false;
+      for (size_t s_it = first_slot; s_it < fUnitSlots.size(); ++s_it) {
+        if (fUnitSlots[s_it].column == column) {
+          duplicate = true;
+          break;
+        }
+      }
+      if (duplicate) {
+        std::stringstream ss;
+        ss << "Event unit " << eu_it
+           << " contains more than one response to parameter "
+           << column_headers[column]->prettyName << " (" << pr.pid
+           << "), only the first will be used.";
+        Fail(ss.str());
+        fNFailedValidations++;
+        continue;
+      }
+      size_t offset =
+          (col.GlobalOffset != npos)
+              ? col.GlobalOffset
+              : AppendResponses(col, *column_headers[column], pr.responses,
+                                eu_it);
+      fUnitSlots.push_back({column, offset});
+    }
+    std::sort(fUnitSlots.begin() + first_slot, fUnitSlots.end(),
+              [](Slot const &l, Slot const &r) { return l.column < r.column; });
+    fUnitSlotOffsets.push_back(fUnitSlots.size());
+  }
+
+  // Transpose the slots to per-column entries, event units are visited in
+  // order so each column is sorted by event unit.
+  fColumnEntryOffsets.assign(fColumns.size() + 1, 0);
+  for (Slot const &s : fUnitSlots) {
+    fColumnEntryOffsets[s.column + 1]++;
+  }
+  for (size_t c_it = 0; c_it < fColumns.size(); ++c_it) {
+    fColumnEntryOffsets[c_it + 1] += fColumnEntryOffsets[c_it];
+  }
+  fColumnEntries.resize(fUnitSlots.size());
+  std::vector<size_t> next(fColumnEntryOffsets.begin(),
+                           fColumnEntryOffsets.end() - 1);
+  for (size_t eu_it = 0; eu_it < fNEventUnits; ++eu_it) {
+    for (size_t s_it = fUnitSlotOffsets[eu_it];
+         s_it < fUnitSlotOffsets[eu_it + 1]; ++s_it) {
+      Slot const &s = fUnitSlots[s_it];
+      fColumnEntries[next[s.column]++] = {eu_it, s.offset};
+    }
+  }
+
+  fScratch.clear();
+  fScratch.shrink_to_fit();
+}
+
+size_t ValidatedResponseView::GetColumn(paramId_t pid) const {
+  auto it =
+      std::lower_bound(fColumnParamIds.begin(), fColumnParamIds.end(), pid);
+  if ((it == fColumnParamIds.end()) || (*it != pid)) {
+    return npos;
+  }
+  return size_t(std::distance(fColumnParamIds.begin(), it));
+}
+
+size_t ValidatedResponseView::AppendResponses(
+    Column &col, SystParamHeader const &hdr,
+    std::vector<double> const &responses, size_t eu) {
+
+  if (responses.size() != col.NResponses) {
+    std::stringstream ss;
+    ss << "Parameter " << hdr.prettyName << " (" << col.pid << ") has "
+       << responses.size() << " responses";
+    if (eu != npos) {
+      ss << " for event unit " << eu;
+    }
+    ss << ", but " << col.NResponses << " "
+       << (col.IsSpline ? "knots." : "variations.");
+    Fail(ss.str());
+    fNFailedValidations++;
+    return GetErrorOffset(col);
+  }
+
+  // As in ParamHeaderHelper, response values are only checked at kTortoise.
+  double const *y = responses.data();
+  if (fChkErr.fCare == ParamValidationAndErrorResponse::kTortoise) {
+    fScratch.resize(col.NResponses);
+    for (size_t r_it = 0; r_it < col.NResponses; ++r_it) {
+      fScratch[r_it] = fChkErr.CheckResponse(responses[r_it], hdr, r_it);
+    }
+    y = fScratch.data();
+  }
+
+  size_t offset = fCoeffs.size();
+  if (col.IsSpline) {
+    fCoeffs.resize(offset + kNSplineCoeffs * col.NResponses);
+    BuildInterpolationCoeffs(col.Scheme, col.Knots.data(), y, col.NResponses,
+                             fCoeffs.data() + offset);
+  } else {
+    fCoeffs.insert(fCoeffs.end(), y, y + col.NResponses);
+  }
+  return offset;
+}
+
+size_t ValidatedResponseView::GetErrorOffset(Column &col) {
+  if (col.ErrorOffset != npos) {
+    return col.ErrorOffset;
+  }
+  double err_response = (fChkErr.fErrorResponse ==
+                         ParamValidationAndErrorResponse::kZeroResponse)
+                            ? 0
+                            : col.Default;
+
+  col.ErrorOffset = fCoeffs.size();
+  if (col.IsSpline) {
+    // A constant spline, only the value coefficient is non-zero.
+    fCoeffs.resize(col.ErrorOffset + kNSplineCoeffs * col.NResponses, 0);
+    for (size_t k_it = 0; k_it < col.NResponses; ++k_it) {
+      fCoeffs[col.ErrorOffset + kNSplineCoeffs * k_it] = err_response;
+    }
+  } else {
+    fCoeffs.resize(col.ErrorOffset + col.NResponses, err_response);
+  }
+  return col.ErrorOffset;
+}
+
+MemoryBreakdown ValidatedResponseView::MemoryFootprint() const {
+  MemoryBreakdown mb = systtools::MemoryFootprint(fHeaders);
+  size_t ColumnBytes = footprint::HeapBytes(fColumns);
+  for (Column const &col : fColumns) {
+    ColumnBytes += footprint::HeapBytes(col.Knots);
+  }
+  mb.Add("columns", ColumnBytes + footprint::HeapBytes(fColumnParamIds));
+  mb.Add("coefficients", footprint::HeapBytes(fCoeffs));
+  mb.Add("index", footprint::HeapBytes(fUnitSlots) +
+                      footprint::HeapBytes(fUnitSlotOffsets) +
+                      footprint::HeapBytes(fColumnEntries) +
+                      footprint::HeapBytes(fColumnEntryOffsets));
+  return mb;
+}
+
+void ValidatedResponseView::Fail(std::string const &msg) const {
+  if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kNotOnMyWatch) {
+    throw invalid_event_response() << "[ERROR]: " << msg;
+  }
+  if (fChkErr.fPedantry == ParamValidationAndErrorResponse::kMeh) {
+    SYSTTOOLS_DIAG(kWarn, "InvalidEventResponse", msg);
+  }
+}
+
+bool ValidatedResponseView::Resolve(paramId_t pid, double v,
+                                    ResolvedParamValue &out,
+                                    bool RequireWeightResponse) const {
+  size_t column = GetColumn(pid);
+  if (column == npos) {
+    std::stringstream ss;
+    ss << "Requested response to parameter " << pid << ", but "
+       << (fHeaders.count(pid) ? "it is a responseless parameter."
+                               : "it is not currently configured.");
+    Fail(ss.str());
+    return false;
+  }
+  Column const &col = fColumns[column];
+  if (col.Unusable || !col.IsSpline ||
+      (RequireWeightResponse && !col.IsWeight)) {
+    std::stringstream ss;
+    ss << "Requested splined response to parameter "
+       << fHeaders.at(pid).Header.prettyName << " (" << pid << "), but it "
+       << (col.Unusable ? "has invalid knots."
+                        : (!col.IsSpline ? "is not a splineable parameter."
+                                         : "is not a weight parameter."));
+    Fail(ss.str());
+    return false;
+  }
+
+  if (fChkErr.fCare == ParamValidationAndErrorResponse::kTortoise) {
+    if ((v < col.LowLimit) || (v > col.UpLimit)) {
+      std::stringstream ss;
+      ss << "Parameter \"" << fHeaders.at(pid).Header.prettyName
+         << "\", evaluated at " << v << ", but specified "
+         << ((v < col.LowLimit) ? "lower" : "upper") << " bound at "
+         << ((v < col.LowLimit) ? col.LowLimit : col.UpLimit) << ".";
+      Fail(ss.str());
+      v = std::min(std::max(v, col.LowLimit), col.UpLimit);
+    }
+  }
+
+  size_t knot = col.Knots.Find(v);
+  out = {column, knot, v - col.Knots[knot]};
+  return true;
+}
+
+void ValidatedResponseView::Resolve(param_value_list_t const &vals,
+                                    resolved_param_value_list_t &out,
+                                    bool RequireWeightResponse) const {
+  out.clear();
+  ResolvedParamValue rpv;
+  for (ParamValue const &iv : vals) {
+    if (Resolve(iv.pid, iv.val, rpv, RequireWeightResponse)) {
+      out.push_back(rpv);
+    }
+  }
+  std::sort(out.begin(), out.end(),
+            [](ResolvedParamValue const &l, ResolvedParamValue const &r) {
+              return l.column < r.column;
+            });
+}
+
+void ValidatedResponseView::ScanParameterResponse(
+    paramId_t pid, double const *values, size_t NValues, double *out,
+    bool RequireWeightResponse) const {
+  // Locate the spline interval of each value once.
+  fScanKnots.resize(NValues);
+  fScanDx.resize(NValues);
+  size_t column = npos;
+  ResolvedParamValue rpv;
+  for (size_t v_it = 0; v_it < NValues; ++v_it) {
+    if (!Resolve(pid, values[v_it], rpv, RequireWeightResponse)) {
+      // As in Resolve, a parameter that cannot be evaluated is dropped.
+      std::fill(out, out + (fNEventUnits * NValues), 1.0);
+      return;
+    }
+    column = rpv.column;
+    fScanKnots[v_it] = rpv.knot;
+    fScanDx[v_it] = rpv.dx;
+  }
+  if (column == npos) {
+    return;
+  }
+
+  // Event units without a response take the default.
+  double Default = fColumns[column].Default;
+  Entry const *en = fColumnEntries.data() + fColumnEntryOffsets[column];
+  Entry const *ee = fColumnEntries.data() + fColumnEntryOffsets[column + 1];
+  size_t eu_it = 0;
+  for (Entry const *e = en; e != ee; ++e) {
+    std::fill(out + (eu_it * NValues), out + (e->eu * NValues), Default);
+    eu_it = e->eu + 1;
+  }
+  std::fill(out + (eu_it * NValues), out + (fNEventUnits * NValues), Default);
+
+  // Each value is a single polynomial, with the same dx, over every event
+  // unit, so the inner loop runs over the entries of the column.
+  size_t NEntries = size_t(ee - en);
+  for (size_t v_it = 0; v_it < NValues; ++v_it) {
+    double const *c = fCoeffs.data() + (kNSplineCoeffs * fScanKnots[v_it]);
+    double dx = fScanDx[v_it];
+    double *v_out = out + v_it;
+    for (size_t e_it = 0; e_it < NEntries; ++e_it) {
+      double const *p = c + en[e_it].offset;
+      v_out[en[e_it].eu * NValues] =
+          p[0] + dx * (p[1] + dx * (p[2] + dx * p[3]));
+    }
+  }
+}
+
+void ValidatedResponseView::Resolve(param_list_t const &pids,
+                                    resolved_param_list_t &out,
+                                    bool RequireWeightResponse) const {
+  out.clear();
+  for (paramId_t pid : pids) {
+    size_t column = GetColumn(pid);
+    if (column == npos) {
+      std::stringstream ss;
+      ss << "Requested response to parameter " << pid << ", but "
+         << (fHeaders.count(pid) ? "it is a responseless parameter."
+                                 : "it is not currently configured.");
+      Fail(ss.str());
+      continue;
+    }
+    Column const &col = fColumns[column];
+    if (col.IsSpline || (RequireWeightResponse && !col.IsWeight)) {
+      std::stringstream ss;
+      ss << "Requested discrete response to parameter "
+         << fHeaders.at(pid).Header.prettyName << " (" << pid << "), but it "
+         << (col.IsSpline ? "is a splineable parameter."
+                          : "is not a weight parameter.");
+      Fail(ss.str());
+      continue;
+    }
+    out.push_back(column);
+  }
+  std::sort(out.begin(), out.end());
+}
+
+} // namespace systtools
@@ -0,0 +1,327 @@
+#ifndef SYSTTOOLS_INTERPRETERS_VALIDATEDRESPONSEVIEW_SEEN
+#define SYSTTOOLS_INTERPRETERS_VALIDATEDRESPONSEVIEW_SEEN
+
+#include "systematicstools/interface/SystMetaData.hh"
+#include "systematicstools/interface/types.hh"
+
+#include "systematicstools/interpreters/InterpolationSchemes.hh"
+#include "systematicstools/interpreters/ParamHeaderHelper.hh"
+#include "systematicstools/interpreters/ParamValidationAndErrorResponse.hh"
+#include "systematicstools/interpreters/SplineResponse.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when validation of an EventResponse fails with
+/// fPedantry == kNotOnMyWatch.
+NEW_SYSTTOOLS_EXCEPT(invalid_event_response);
+
+///\brief A validated, read-only view of the responses in an EventResponse.
+///
+/// All of the checks that ParamHeaderHelper makes on each query are made once,
+/// on construction:
+///
+/// * Every response belongs to a configured, non-responseless parameter, and
+/// appears at most once per event unit.
+/// * The number of responses matches the number of knots or variations in the
+/// header.
+/// * At care level kTortoise, every weight response passes
+/// ParamValidationAndErrorResponse::CheckResponse, which, as in
+/// ParamHeaderHelper, is skipped at the other care levels.
+/// * Spline knots are strictly increasing.
+///
+/// Failures are reported according to fPedantry, and failing responses are
+/// replaced by the default response described by fErrorResponse. Spline
+/// coefficients are built once for every event unit, and responses to
+/// parameters that do not differ event by event are stored once.
+///
+/// Parameter-value lists are resolved to column slots by Resolve, after which
+/// the Get* methods perform no checks and no allocations. Responses are
+/// identical to those of ParamHeaderHelper::GetParameterResponse, including
+/// any declared InterpolationScheme, see BuildSplineCoeffs.
+///
+/// A parameter without a response in an event unit does not affect it, the
+/// response is 1 for weight parameters and 0 otherwise.
+class ValidatedResponseView {
+public:
+  ///\brief A parameter value, resolved to the column and spline interval used
+  /// to evaluate it.
+  struct ResolvedParamValue {
+    size_t column;
+    size_t knot;
+    double dx;
+  };
+  typedef std::vector<ResolvedParamValue> resolved_param_value_list_t;
+  typedef std::vector<size_t> resolved_param_list_t;
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  ValidatedResponseView(param_header_map_t const &headers,
+                        EventResponse const &er,
+                        ParamValidationAndErrorResponse const &chkerr =
+                            ParamValidationAndErrorResponse());
+  template <typename VP>
+  ValidatedResponseView(ParamHeaderHelperT<VP> const &phh,
+                        EventResponse const &er)
+      : ValidatedResponseView(phh.GetHeaders(), er, phh.GetChkErr()) {}
+
+  size_t GetNEventUnits() const { return fNEventUnits; }
+  size_t GetNColumns() const { return fColumns.size(); }
+  ///\brief The number of stored (event unit, parameter) responses.
+  size_t GetNEntries() const { return fUnitSlots.size(); }
+  ///\brief The number of responses replaced by the default response during
+  /// validation.
+  size_t GetNFailedValidations() const { return fNFailedValidations; }
+
+  ///\brief The allocated memory, reported as "headers" and "maps" for the
+  /// copied headers, "columns" for the per-parameter metadata, "coefficients"
+  /// for the spline coefficients and discrete responses, and "index" for the
+  /// per event unit and per column lookup tables.
+  MemoryBreakdown MemoryFootprint() const;
+
+  ///\brief Gets the column holding the responses of parameter pid, or npos if
+  /// it has none.
+  size_t GetColumn(paramId_t pid) const;
+  paramId_t GetColumnParamId(size_t column) const {
+    return fColumns[column].pid;
+  }
+  size_t GetNDiscreteVariations(size_t column) const {
+    return fColumns[column].NResponses;
+  }
+
+  ///\brief Resolves a parameter-value list to spline columns and intervals.
+  ///
+  /// Unknown, non-spline, or if RequireWeightResponse, non-weight parameters
+  /// are reported and dropped. At care level kTortoise, values outside of the
+  /// parameter validity range are reported and moved to the nearest boundary.
+  ///
+  /// The result is sorted by column and does not allocate if out already has
+  /// sufficient capacity.
+  void Resolve(param_value_list_t const &, resolved_param_value_list_t &out,
+               bool RequireWeightResponse = true) const;
+  resolved_param_value_list_t Resolve(param_value_list_t const &vals,
+                                      bool RequireWeightResponse = true) const {
+    resolved_param_value_list_t out;
+    Resolve(vals, out, RequireWeightResponse);
+    return out;
+  }
+
+  ///\brief Resolves a single parameter value, returning false, after
+  /// reporting, if the parameter cannot be evaluated.
+  bool Resolve(paramId_t pid, double v, ResolvedParamValue &out,
+               bool RequireWeightResponse = true) const;
+
+  ///\brief Resolves a parameter list to discrete response columns.
+  ///
+  /// Unknown, spline, or if RequireWeightResponse, non-weight parameters are
+  /// reported and dropped.
+  void Resolve(param_list_t const &, resolved_param_list_t &out,
+               bool RequireWeightResponse = true) const;
+  resolved_param_list_t Resolve(param_list_t const &pids,
+                                bool RequireWeightResponse = true) const {
+    resolved_param_list_t out;
+    Resolve(pids, out, RequireWeightResponse);
+    return out;
+  }
+
+  ///\brief Gets the splined response to a single resolved parameter value for
+  /// event unit eu.
+  double GetParameterResponse(ResolvedParamValue const &rpv, size_t eu) const {
+    Slot const *s = FindSlot(rpv.column, eu);
+    return s ? EvalSplineCoeffs(fCoeffs.data() + s->offset, rpv.knot, rpv.dx)
+             : fColumns[rpv.column].Default;
+  }
+
+  ///\brief Gets the multiplicatively combined, splined response to all
+  /// resolved parameter values for event unit eu.
+  double GetTotalResponse(resolved_param_value_list_t const &rpvs,
+                          size_t eu) const {
+    double response_weight = 1;
+    Slot const *s = fUnitSlots.data() + fUnitSlotOffsets[eu];
+    Slot const *e = fUnitSlots.data() + fUnitSlotOffsets[eu + 1];
+    for (ResolvedParamValue const &rpv : rpvs) {
+      while ((s != e) && (s->column < rpv.column)) {
+        ++s;
+      }
+      if (s == e) {
+        break;
+      }
+      if (s->column == rpv.column) {
+        response_weight *=
+            EvalSplineCoeffs(fCoeffs.data() + s->offset, rpv.knot, rpv.dx);
+      }
+    }
+    return response_weight;
+  }
+
+  ///\brief Fills out[0 ... GetNEventUnits()) with the total response of each
+  /// event unit.
+  ///
+  /// Evaluates column by column, which is faster than calling
+  /// GetTotalResponse for every event unit.
+  void GetTotalResponses(resolved_param_value_list_t const &rpvs,
+                         double *out) const {
+    std::fill(out, out + fNEventUnits, 1.0);
+    for (ResolvedParamValue const &rpv : rpvs) {
+      Entry const *en = fColumnEntries.data() + fColumnEntryOffsets[rpv.column];
+      Entry const *ee =
+          fColumnEntries.data() + fColumnEntryOffsets[rpv.column + 1];
+      for (; en != ee; ++en) {
+        out[en->eu] *=
+            EvalSplineCoeffs(fCoeffs.data() + en->offset, rpv.knot, rpv.dx);
+      }
+    }
+  }
+
+  ///\brief Evaluates the splined response of parameter pid at each of
+  /// values[0 ... NValues) for every event unit, in a single pass over the
+  /// event units.
+  ///
+  /// The response of event unit eu at values[k] is written to
+  /// out[eu * NValues + k], which must have room for GetNEventUnits() *
+  /// NValues entries. Values are resolved, as by Resolve, once per call, and
+  /// then, for each value, the inner loop runs over the event units with a
+  /// response, with a fixed spline interval and offset into it. If pid cannot
+  /// be evaluated, it is reported and every response is 1, as if it had been
+  /// dropped by Resolve.
+  ///
+  ///\note Uses internal buffers, so concurrent scans on the same view are not
+  /// thread safe.
+  void ScanParameterResponse(paramId_t pid, double const *values,
+                             size_t NValues, double *out,
+                             bool RequireWeightResponse = true) const;
+  std::vector<double>
+  ScanParameterResponse(paramId_t pid, std::vector<double> const &values,
+                        bool RequireWeightResponse = true) const {
+    std::vector<double> out(fNEventUnits * values.size());
+    ScanParameterResponse(pid, values.data(), values.size(), out.data(),
+                          RequireWeightResponse);
+    return out;
+  }
+
+  ///\brief Gets the response at variation j of the discrete parameter in
+  /// column for event unit eu.
+  ///
+  ///\note j must be less than GetNDiscreteVariations(column), this is not
+  /// checked.
+  double GetDiscreteResponse(size_t column, size_t j, size_t eu) const {
+    Slot const *s = FindSlot(column, eu);
+    return s ? fCoeffs[s->offset + j] : fColumns[column].Default;
+  }
+
+  ///\brief Gets the multiplicatively combined response at variation j of the
+  /// resolved parameters for event unit eu.
+  double GetDiscreteResponse(resolved_param_list_t const &columns, size_t j,
+                             size_t eu) const {
+    double response_weight = 1;
+    Slot const *s = fUnitSlots.data() + fUnitSlotOffsets[eu];
+    Slot const *e = fUnitSlots.data() + fUnitSlotOffsets[eu + 1];
+    for (size_t column : columns) {
+      while ((s != e) && (s->column < column)) {
+        ++s;
+      }
+      if (s == e) {
+        break;
+      }
+      if (s->column == column) {
+        response_weight *= fCoeffs[s->offset + j];
+      }
+    }
+    return response_weight;
+  }
+
+  ///\brief Fills out[0 ... GetNEventUnits()) with the combined response at
+  /// variation j of each event unit.
+  void GetDiscreteResponses(resolved_param_list_t const &columns, size_t j,
+                            double *out) const {
+    std::fill(out, out + fNEventUnits, 1.0);
+    for (size_t column : columns) {
+      Entry const *en = fColumnEntries.data() + fColumnEntryOffsets[column];
+      Entry const *ee = fColumnEntries.data() + fColumnEntryOffsets[column + 1];
+      for (; en != ee; ++en) {
+        out[en->eu] *= fCoeffs[en->offset + j];
+      }
+    }
+  }
+
+private:
+  struct Column {
+    paramId_t pid;
+    bool IsSpline;
+    bool IsWeight;
+    ///\brief Whether the header could not be used to interpret responses.
+    bool Unusable;
+    size_t NResponses;
+    SplineKnots Knots;
+    InterpolationScheme Scheme;
+    double LowLimit;
+    double UpLimit;
+    ///\brief Response of event units that have no response to this parameter.
+    double Default;
+    ///\brief Offset of the shared responses of a parameter that does not
+    /// differ event by event.
+    size_t GlobalOffset;
+    ///\brief Offset of the default responses used for failed validations.
+    size_t ErrorOffset;
+  };
+  struct Slot {
+    size_t column;
+    size_t offset;
+  };
+  struct Entry {
+    size_t eu;
+    size_t offset;
+  };
+
+  Slot const *FindSlot(size_t column, size_t eu) const {
+    Slot const *e = fUnitSlots.data() + fUnitSlotOffsets[eu + 1];
+    Slot const *s = std::lower_bound(
+        fUnitSlots.data() + fUnitSlotOffsets[eu], e, column,
+        [](Slot const &sl, size_t c) { return sl.column < c; });
+    return ((s != e) && (s->column == column)) ? s : nullptr;
+  }
+
+  ///\brief Validates and appends the responses for a column, returning their
+  /// offset.
+  size_t AppendResponses(Column &, SystParamHeader const &,
+                         std::vector<double> const &, size_t eu);
+  size_t GetErrorOffset(Column &);
+
+  ///\brief Reacts to a failed check according to fPedantry.
+  void Fail(std::string const &msg) const;
+
+  param_header_map_t fHeaders;
+  ParamValidationAndErrorResponse fChkErr;
+  size_t fNEventUnits;
+  size_t fNFailedValidations;
+
+  std::vector<Column> fColumns;
+  ///\brief Parameter ids of each column, sorted.
+  std::vector<paramId_t> fColumnParamIds;
+
+  ///\brief Spline coefficients, kNSplineCoeffs per knot, or discrete
+  /// responses, for every entry.
+  std::vector<double> fCoeffs;
+
+  ///\brief Per event unit slots, sorted by column.
+  std::vector<Slot> fUnitSlots;
+  std::vector<size_t> fUnitSlotOffsets;
+  ///\brief Per column entries, sorted by event unit.
+  std::vector<Entry> fColumnEntries;
+  std::vector<size_t> fColumnEntryOffsets;
+
+  std::vector<double> fScratch;
+  ///\brief The spline interval, and offset into it, of each scanned value.
+  mutable std::vector<size_t> fScanKnots;
+  mutable std::vector<double> fScanDx;
+};
+
+} // namespace systtools
+
+#endif
@@ -1,4 +1,5 @@
 #include "systematicstools/interface/ISystProviderTool.hh"
+#include "systematicstools/interface/Profiler.hh"
 #include "systematicstools/utility/CovMatThrower.hh"
 #include "systematicstools/utility/append_event_response.hh"
 #include "systematicstools/utility/configure_syst_providers.hh"
@@ -25,10 +26,14 @@
 
 #include <chrono>
 #include <sstream>
+#include <string_view>
 
 using namespace systtools;
 using namespace fhiclsimple;
 
+NEW_SYSTTOOLS_EXCEPT(invalid_covariance_input);
+NEW_SYSTTOOLS_EXCEPT(invalid_child_response);
+
 namespace {
 
 struct Config {
@@ -106,21 +111,18 @@ CorrelatedMultisimProvider::ConfigureFromFHICL(ParameterSet const &params,
       }
     }
     if (pid == kParamUnhandled<paramId_t>) {
-      std::cout
+      throw parameter_name_not_handled()
           << "[ERROR]: Could not find a child provider that handles parameter "
-          << std::quoted(pname) << std::endl;
-      throw;
+          << std::quoted(pname);
     } else {
       CorrelatedThrows.push_back(
           std::pair<paramId_t, std::vector<double>>{pid, {}});
       if (CorrelatedParameters.find(pid) != CorrelatedParameters.end()) {
-        std::cout
+        throw systParamId_collision()
             << "[ERROR]: Already have added " << pid
             << " to the set of known parameters. Is " << pname
             << " specified twice? Parameters with identical prettyNames under "
-               "different provider instances cannot be disambiguated."
-            << std::endl;
-        throw;
+               "different provider instances cannot be disambiguated.";
       }
       CorrelatedParameters.insert(pid);
     }
@@ -139,18 +141,17 @@ CorrelatedMultisimProvider::ConfigureFromFHICL(ParameterSet const &params,
   TFile *fin = TFile::Open(cfg().inputRootFile().c_str(), "READ");
 
   if (!fin || !fin->IsOpen()) {
-    std::cout << "[ERROR]: Failed to open "
-              << std::quoted(cfg().inputRootFile()) << " for reading."
-              << std::endl;
-    throw;
+    throw invalid_covariance_input()
+        << "[ERROR]: Failed to open " << std::quoted(cfg().inputRootFile())
+        << " for reading.";
   }
 
   TMatrixD *covmat =
       dynamic_cast<TMatrixD *>(fin->Get(cfg().covmatName().c_str()));
   if (!covmat) {
-    std::cout << "[ERROR]: Failed to read " << std::quoted(cfg().covmatName())
-              << " from " << std::quoted(cfg().inputRootFile()) << std::endl;
-    throw;
+    throw invalid_covariance_input()
+        << "[ERROR]: Failed to read " << std::quoted(cfg().covmatName())
+        << " from " << std::quoted(cfg().inputRootFile());
   }
 
   RNgine = std::make_unique<CLHEP::MTwistEngine>(fSeedSuggestion);
@@ -207,41 +208,26 @@ bool CorrelatedMultisimProvider::Configure() {
   for (auto hdr : fMetaData) {
     bool foundToolType = false;
 
-    for (size_t opt_it = 0; opt_it < hdr.opts.size(); ++opt_it) {
-      auto const &opt = hdr.opts[opt_it];
-      if (opt.find("CorrMSProviderHint=") == 0) {
-        auto const &splitHint = ParseToVect<std::string>(opt, "=");
-        if (splitHint.size() != 2) {
-          std::cout
-              << "[ERROR]: CorrelatedMultisimProvider found a parameter "
-                 "provider hint: "
-              << std::quoted(opt) << ", expected to find one of the form: "
-              << std::quoted(
-                     "CorrMSProviderHint=<tool_type>::<optional unique_name>")
-              << std::endl;
-          throw;
-        }
-        auto const &nameHint =
-            ParseToVect<std::string>(splitHint.back(), "::", true);
-        if (nameHint.size() != 2) {
-          std::cout
-              << "[ERROR]: CorrelatedMultisimProvider found a parameter "
-                 "provider hint: "
-              << std::quoted(opt) << ", expected to find one of the form: "
-              << std::quoted(
-                     "CorrMSProviderHint=<tool_type>::<optional unique_name>")
-              << std::endl;
-          throw;
-        }
-        // Remove the name hint option before passing it onwards.
-        std::vector<std::string>::iterator del_it = hdr.opts.begin();
-        std::advance(del_it, opt_it);
-        hdr.opts.erase(del_it);
-        child_syst_provider_parameters[{nameHint.front(), nameHint.back()}]
-            .push_back(hdr);
-        foundToolType = true;
-        break;
+    std::string_view hint;
+    if (hdr.opts.FindKV("CorrMSProviderHint", hint)) {
+      // The tool type may be empty, but the name after "::" may not.
+      size_t sep = hint.find("::");
+      if ((sep == std::string_view::npos) || ((sep + 2) == hint.size()) ||
+          (hint.find("::", sep + 2) != std::string_view::npos)) {
+        throw incorrectly_configured()
+            << "[ERROR]: CorrelatedMultisimProvider found a parameter "
+               "provider hint: "
+            << std::quoted(std::string(hint))
+            << ", expected to find one of the form: "
+            << std::quoted(
+                   "CorrMSProviderHint=<tool_type>::<optional unique_name>");
       }
+      std::pair<std::string, std::string> nameHint{
+          std::string(hint.substr(0, sep)), std::string(hint.substr(sep + 2))};
+      // Remove the name hint option before passing it onwards.
+      hdr.opts.EraseKV("CorrMSProviderHint");
+      child_syst_provider_parameters[nameHint].push_back(hdr);
+      foundToolType = true;
     }
     if (!foundToolType) {
       std::cout << "[ERROR]: Failed to find tool_type on child parameter named "
@@ -282,11 +268,13 @@ CorrelatedMultisimProvider::GetEventResponse(art::Event &e) {
   bool first = true;
   for (auto &sp : child_providers) {
     std::unique_ptr<systtools::EventResponse> syst_resp =
-        sp.second->GetEventResponse(e);
+        systtools::ProfileEventResponse(
+            sp.second->GetFullyQualifiedName(),
+            [&]() { return sp.second->GetEventResponse(e); });
     if (!syst_resp) {
-      std::cout << "[ERROR]: Got null syst response from provider "
-                << sp.second->GetFullyQualifiedName() << std::endl;
-      throw;
+      throw invalid_child_response()
+          << "[ERROR]: Got null syst response from provider "
+          << sp.second->GetFullyQualifiedName();
     }
     if (first) {
       er = std::move(syst_resp);
@@ -102,7 +102,7 @@ SystMetaData ExampleISystProvider::BuildSystMetaData(ParameterSet const &params,
 
   if (!sph.differsEventByEvent) {
     // Need to add global responses
-    for (double var : sph.paramVariations) {
+    for (double var : sph.paramVariations.get()) {
       sph.responses.push_back(GetResponse(var, sph));
     }
   }
@@ -130,3 +130,33 @@ bool ExampleISystProvider::SetupResponseCalculator(
 
   return true;
 }
+
+// Needs no input variables, every event unit is treated alike.
+void ExampleISystProvider::SetEventUnitSchema(EventUnitSchema const &) {
+  CheckHaveMetaData();
+}
+
+event_unit_response_t
+ExampleISystProvider::GetEventUnitResponse(EventUnitRecord const &eu) {
+  if (!applyToAll) {
+    // Re-seed from the event key so that the subset of responding event units
+    // does not depend on the order in which they are processed.
+    std::seed_seq seed{uint32_t(fSeedSuggestion), eu.key.run, eu.key.subrun,
+                       eu.key.event, eu.key.unit};
+    RNgine->seed(seed);
+    RNJesus->reset();
+    if ((*RNJesus)(*RNgine) < 0) {
+      return {};
+    }
+  }
+
+  for (SystParamHeader const &sph : GetSystMetaData()) {
+    if (!sph.differsEventByEvent) {
+      continue;
+    }
+    ResponseBuilder.Add(sph, sph.paramVariations.size(), [&](size_t v_it) {
+      return GetResponse(sph.paramVariations[v_it], sph);
+    });
+  }
+  return ResponseBuilder.Release();
+}
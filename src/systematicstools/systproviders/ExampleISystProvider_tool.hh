@@ -10,15 +10,23 @@ class ExampleISystProvider : public systtools::ISystProviderTool {
 public:
   explicit ExampleISystProvider(fhicl::ParameterSet const &);
 
+  size_t GetNParametersFromToolConfig(fhicl::ParameterSet const &) {
+    return 1;
+  }
   systtools::SystMetaData BuildSystMetaData(fhicl::ParameterSet const &,
                                           systtools::paramId_t);
   fhicl::ParameterSet GetExtraToolOptions();
   bool SetupResponseCalculator(fhicl::ParameterSet const &);
 
+  void SetEventUnitSchema(systtools::EventUnitSchema const &);
+  systtools::event_unit_response_t
+  GetEventUnitResponse(systtools::EventUnitRecord const &);
+
   std::string AsString();
 
 private:
   bool applyToAll;
   std::unique_ptr<std::mt19937_64> RNgine;
   std::unique_ptr<std::normal_distribution<double>> RNJesus;
+  systtools::SparseEventUnitResponseBuilder ResponseBuilder;
 };
@@ -0,0 +1,60 @@
+#include "systematicstools/utility/AllocationCounter.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<size_t> gNAllocations(0);
+std::atomic<size_t> gNDeallocations(0);
+std::atomic<size_t> gNBytesAllocated(0);
+
+void *CountedAlloc(size_t sz) {
+  gNAllocations.fetch_add(1, std::memory_order_relaxed);
+  gNBytesAllocated.fetch_add(sz, std::memory_order_relaxed);
+  if (void *p = std::malloc(sz ? sz : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void CountedFree(void *p) {
+  if (p) {
+    gNDeallocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::free(p);
+}
+} // namespace
+
+namespace systtools {
+
+AllocationCounts GetAllocationCounts() {
+  return {gNAllocations.load(std::memory_order_relaxed),
+          gNDeallocations.load(std::memory_order_relaxed),
+          gNBytesAllocated.load(std::memory_order_relaxed)};
+}
+
+} // namespace systtools
+
+void *operator new(size_t sz) { return CountedAlloc(sz); }
+void *operator new[](size_t sz) { return CountedAlloc(sz); }
+void *operator new(size_t sz, std::nothrow_t const &) noexcept {
+  try {
+    return CountedAlloc(sz);
+  } catch (std::bad_alloc const &) {
+    return nullptr;
+  }
+}
+void *operator new[](size_t sz, std::nothrow_t const &) noexcept {
+  return operator new(sz, std::nothrow);
+}
+void operator delete(void *p) noexcept { CountedFree(p); }
+void operator delete[](void *p) noexcept { CountedFree(p); }
+void operator delete(void *p, size_t) noexcept { CountedFree(p); }
+void operator delete[](void *p, size_t) noexcept { CountedFree(p); }
+void operator delete(void *p, std::nothrow_t const &) noexcept {
+  CountedFree(p);
+}
+void operator delete[](void *p, std::nothrow_t const &) noexcept {
+  CountedFree(p);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+namespace systtools {
+
+///\brief Process-wide heap allocation counts.
+struct AllocationCounts {
+  size_t NAllocations;
+  size_t NDeallocations;
+  size_t NBytesAllocated;
+
+  AllocationCounts operator-(AllocationCounts const &other) const {
+    return {NAllocations - other.NAllocations,
+            NDeallocations - other.NDeallocations,
+            NBytesAllocated - other.NBytesAllocated};
+  }
+};
+
+///\brief Gets the number of calls to the global operator new and delete, and
+/// the number of bytes requested, since the start of the process.
+///
+/// Counting is enabled by linking an executable against the
+/// systtools::alloccounter library, which replaces the global allocation
+/// functions with counting versions. It must not be linked into libraries.
+/// The difference of two calls gives the allocations made in between:
+///
+///   AllocationCounts start = GetAllocationCounts();
+///   cache.CacheEvents(events, er);
+///   AllocationCounts used = GetAllocationCounts() - start;
+AllocationCounts GetAllocationCounts();
+
+} // namespace systtools
@@ -0,0 +1,106 @@
+#include "systematicstools/utility/Diagnostics.hh"
+
+#include <iomanip>
+#include <iostream>
+
+namespace systtools {
+
+std::string to_str(DiagLevel l) {
+  switch (l) {
+  case DiagLevel::kDebug: {
+    return "DEBUG";
+  }
+  case DiagLevel::kInfo: {
+    return "INFO";
+  }
+  case DiagLevel::kWarn: {
+    return "WARN";
+  }
+  case DiagLevel::kError: {
+    return "ERROR";
+  }
+  }
+  return "UNKNOWN";
+}
+
+Diagnostics &Diagnostics::Get() {
+  static Diagnostics d;
+  return d;
+}
+
+Diagnostics::Diagnostics()
+    : fOutputLevel(DiagLevel::kInfo), fMessageLimit(5),
+      fPrintSummaryAtExit(true), fStream(&std::cout) {}
+
+Diagnostics::~Diagnostics() {
+  if (!fPrintSummaryAtExit) {
+    return;
+  }
+  bool suppressed = false;
+  for (auto const &t : fTypes) {
+    if (t.second->GetCount() > t.second->GetNEmitted()) {
+      suppressed = true;
+      break;
+    }
+  }
+  if (suppressed) {
+    PrintSummary(*fStream);
+  }
+}
+
+DiagnosticType &Diagnostics::GetType(std::string const &name,
+                                     DiagLevel level) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  std::unique_ptr<DiagnosticType> &t = fTypes[name];
+  if (!t) {
+    t = std::make_unique<DiagnosticType>(name, level);
+  }
+  return *t;
+}
+
+void Diagnostics::SetStream(std::ostream &os) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  fStream = &os;
+}
+
+void Diagnostics::Emit(DiagnosticType &t, std::string const &msg) {
+  std::lock_guard<std::mutex> lock(fMutex);
+  size_t n = t.fNEmitted.fetch_add(1, std::memory_order_relaxed) + 1;
+  (*fStream) << "[" << to_str(t.GetLevel()) << "]: " << msg << "\n";
+  if (n == GetMessageLimit()) {
+    (*fStream) << "[" << to_str(t.GetLevel()) << "]: Further "
+               << std::quoted(t.GetName())
+               << " messages will be counted, but not written.\n";
+  }
+}
+
+void Diagnostics::PrintSummary(std::ostream &os) const {
+  std::lock_guard<std::mutex> lock(fMutex);
+  os << "[INFO]: Diagnostics summary:\n";
+  for (auto const &t : fTypes) {
+    if (!t.second->GetCount()) {
+      continue;
+    }
+    os << "  " << std::setw(6) << to_str(t.second->GetLevel()) << " "
+       << std::setw(48) << std::left << t.first << std::right
+       << std::setw(12) << t.second->GetCount() << " occurrences, "
+       << t.second->GetNEmitted() << " written.\n";
+  }
+  os << std::flush;
+}
+
+std::string Diagnostics::GetSummary() const {
+  std::stringstream ss;
+  PrintSummary(ss);
+  return ss.str();
+}
+
+void Diagnostics::Reset() {
+  std::lock_guard<std::mutex> lock(fMutex);
+  for (auto &t : fTypes) {
+    t.second->fCount.store(0, std::memory_order_relaxed);
+    t.second->fNEmitted.store(0, std::memory_order_relaxed);
+  }
+}
+
+} // namespace systtools
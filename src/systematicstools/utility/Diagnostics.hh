@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace systtools {
+
+enum class DiagLevel { kDebug = 0, kInfo = 1, kWarn = 2, kError = 3 };
+
+std::string to_str(DiagLevel);
+
+///\brief The lowest diagnostic level that is compiled in.
+///
+/// SYSTTOOLS_DIAG statements below this level compile to nothing. Define as 0
+/// to compile in debug messages, e.g. -DSYSTTOOLS_DIAG_COMPILED_LEVEL=0.
+#ifndef SYSTTOOLS_DIAG_COMPILED_LEVEL
+#define SYSTTOOLS_DIAG_COMPILED_LEVEL 1
+#endif
+
+///\brief Aggregated occurrence count of a single type of diagnostic message.
+class DiagnosticType {
+public:
+  DiagnosticType(std::string const &name, DiagLevel level)
+      : fName(name), fLevel(level), fCount(0), fNEmitted(0) {}
+
+  std::string const &GetName() const { return fName; }
+  DiagLevel GetLevel() const { return fLevel; }
+  size_t GetCount() const { return fCount.load(std::memory_order_relaxed); }
+  size_t GetNEmitted() const {
+    return fNEmitted.load(std::memory_order_relaxed);
+  }
+
+  ///\brief Counts an occurrence and returns whether its message should be
+  /// built and passed to Diagnostics::Emit.
+  inline bool Count();
+
+private:
+  friend class Diagnostics;
+
+  std::string fName;
+  DiagLevel fLevel;
+  std::atomic<size_t> fCount;
+  std::atomic<size_t> fNEmitted;
+};
+
+///\brief Process-wide sink for diagnostic messages.
+///
+/// Every occurrence of a message type is counted, but only the first
+/// GetMessageLimit() occurrences at or above GetOutputLevel() are written to
+/// the output stream, without flushing. Types with suppressed occurrences are
+/// listed by PrintSummary, which is also called at exit unless disabled by
+/// SetPrintSummaryAtExit(false).
+///
+/// Messages are usually posted with SYSTTOOLS_DIAG, which only formats the
+/// message when it is going to be written.
+class Diagnostics {
+public:
+  static Diagnostics &Get();
+  ~Diagnostics();
+
+  ///\brief Gets the counter for message type name, creating it if required.
+  ///
+  ///\note The returned reference is valid for the lifetime of the process.
+  DiagnosticType &GetType(std::string const &name, DiagLevel level);
+
+  void SetOutputLevel(DiagLevel l) {
+    fOutputLevel.store(l, std::memory_order_relaxed);
+  }
+  DiagLevel GetOutputLevel() const {
+    return fOutputLevel.load(std::memory_order_relaxed);
+  }
+  ///\brief Maximum number of messages written per message type, 0 disables
+  /// all output.
+  void SetMessageLimit(size_t n) {
+    fMessageLimit.store(n, std::memory_order_relaxed);
+  }
+  size_t GetMessageLimit() const {
+    return fMessageLimit.load(std::memory_order_relaxed);
+  }
+  ///\brief Sets the output stream, defaults to std::cout.
+  void SetStream(std::ostream &os);
+  void SetPrintSummaryAtExit(bool p) { fPrintSummaryAtExit = p; }
+
+  ///\brief Writes a message of type t to the output stream.
+  void Emit(DiagnosticType &t, std::string const &msg);
+
+  ///\brief Writes the occurrence count of every message type that has been
+  /// posted.
+  void PrintSummary(std::ostream &os) const;
+  std::string GetSummary() const;
+  ///\brief Resets all occurrence counts.
+  void Reset();
+
+private:
+  Diagnostics();
+
+  std::atomic<DiagLevel> fOutputLevel;
+  std::atomic<size_t> fMessageLimit;
+  bool fPrintSummaryAtExit;
+  std::ostream *fStream;
+
+  mutable std::mutex fMutex;
+  std::map<std::string, std::unique_ptr<DiagnosticType>> fTypes;
+};
+
+inline bool DiagnosticType::Count() {
+  size_t n = fCount.fetch_add(1, std::memory_order_relaxed);
+  Diagnostics const &d = Diagnostics::Get();
+  return (fLevel >= d.GetOutputLevel()) && (n < d.GetMessageLimit());
+}
+
+} // namespace systtools
+
+///\brief Posts a diagnostic message of type TYPE at level LEVEL.
+///
+/// MSG is a stream expression, e.g.
+///
+///   SYSTTOOLS_DIAG(kWarn, "UnconfiguredParameter",
+///                  "Parameter " << pid << " is not configured.");
+///
+/// Statements below SYSTTOOLS_DIAG_COMPILED_LEVEL compile to nothing,
+/// otherwise each occurrence costs one relaxed atomic increment, and MSG is
+/// only formatted if it is going to be written.
+#define SYSTTOOLS_DIAG(LEVEL, TYPE, MSG)                                       \
+  do {                                                                         \
+    if (int(systtools::DiagLevel::LEVEL) >= SYSTTOOLS_DIAG_COMPILED_LEVEL) {   \
+      static systtools::DiagnosticType &systtools_diag_type =                 \
+          systtools::Diagnostics::Get().GetType(TYPE,                          \
+                                                systtools::DiagLevel::LEVEL); \
+      if (systtools_diag_type.Count()) {                                       \
+        std::stringstream systtools_diag_ss;                                   \
+        systtools_diag_ss << MSG;                                              \
+        systtools::Diagnostics::Get().Emit(systtools_diag_type,                \
+                                           systtools_diag_ss.str());           \
+      }                                                                        \
+    }                                                                          \
+  } while (false)
@@ -0,0 +1,131 @@
+#include "systematicstools/utility/EventUnitReader.hh"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+
+namespace systtools {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'Y', 'S', 'T', 'E', 'U', '0', '1'};
+
+// Names longer than this are assumed to be corruption.
+constexpr uint32_t kMaxNameLength = 4096;
+
+template <typename T> void WritePOD(std::ostream &os, T const &v) {
+  os.write(reinterpret_cast<char const *>(&v), sizeof(T));
+}
+
+template <typename T> bool ReadPOD(std::istream &is, T &v) {
+  return bool(is.read(reinterpret_cast<char *>(&v), sizeof(T)));
+}
+
+} // namespace
+
+constexpr size_t IEventUnitReader::kUnknownNEventUnits;
+
+BinaryEventUnitWriter::BinaryEventUnitWriter(std::ostream &os,
+                                             EventUnitSchema const &schema)
+    : fOS(os), fNVariables(schema.size()) {
+  fOS.write(kMagic, sizeof(kMagic));
+  WritePOD(fOS, uint32_t(schema.size()));
+  for (std::string const &name : schema.GetNames()) {
+    WritePOD(fOS, uint32_t(name.size()));
+    fOS.write(name.data(), name.size());
+  }
+}
+
+void BinaryEventUnitWriter::Write(EventUnitRecord const &eu) {
+  if (eu.values.size() != fNVariables) {
+    throw invalid_event_unit_input()
+        << "[ERROR]: Attempted to write event unit " << to_str(eu.key)
+        << " with " << eu.values.size() << " variables, but the schema has "
+        << fNVariables;
+  }
+  WritePOD(fOS, eu.key);
+  fOS.write(reinterpret_cast<char const *>(eu.values.data()),
+            fNVariables * sizeof(double));
+}
+
+BinaryEventUnitReader::BinaryEventUnitReader(std::string const &file_name)
+    : fOwnedIS(std::make_unique<std::ifstream>(file_name, std::ios::binary)),
+      fIS(fOwnedIS.get()) {
+  if (!(*fIS)) {
+    throw invalid_event_unit_input()
+        << "[ERROR]: Failed to open event unit input file: "
+        << std::quoted(file_name);
+  }
+  ReadHeader();
+}
+
+BinaryEventUnitReader::BinaryEventUnitReader(std::istream &is) : fIS(&is) {
+  ReadHeader();
+}
+
+void BinaryEventUnitReader::ReadHeader() {
+  char magic[sizeof(kMagic)];
+  if (!fIS->read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kMagic, sizeof(kMagic))) {
+    throw invalid_event_unit_input()
+        << "[ERROR]: Event unit input does not start with the expected "
+           "magic, it was not written by BinaryEventUnitWriter.";
+  }
+  uint32_t NVariables;
+  if (!ReadPOD(*fIS, NVariables)) {
+    throw invalid_event_unit_input()
+        << "[ERROR]: Event unit input is truncated in the header.";
+  }
+  std::vector<std::string> names;
+  for (uint32_t v_it = 0; v_it < NVariables; ++v_it) {
+    uint32_t len;
+    if (!ReadPOD(*fIS, len) || (len > kMaxNameLength)) {
+      throw invalid_event_unit_input()
+          << "[ERROR]: Event unit input has a corrupt name for variable "
+          << v_it;
+    }
+    std::string name(len, '\0');
+    if (!fIS->read(&name[0], len)) {
+      throw invalid_event_unit_input()
+          << "[ERROR]: Event unit input is truncated in the header.";
+    }
+    names.push_back(std::move(name));
+  }
+  fSchema = EventUnitSchema(std::move(names));
+
+  // The number of records follows from the stream length, when it is
+  // seekable.
+  std::streampos start = fIS->tellg();
+  if ((start != std::streampos(-1)) && fIS->seekg(0, std::ios::end)) {
+    std::streampos end = fIS->tellg();
+    size_t RecordSize = sizeof(EventKey) + (fSchema.size() * sizeof(double));
+    fNEventUnits = size_t(end - start) / RecordSize;
+    fIS->seekg(start);
+  }
+  fIS->clear();
+}
+
+size_t BinaryEventUnitReader::ReadBatch(std::vector<EventUnitRecord> &batch,
+                                        size_t NMax) {
+  batch.resize(NMax);
+  size_t NRead = 0;
+  for (; NRead < NMax; ++NRead) {
+    EventUnitRecord &eu = batch[NRead];
+    if (!ReadPOD(*fIS, eu.key)) {
+      break;
+    }
+    eu.values.resize(fSchema.size());
+    if (!fIS->read(reinterpret_cast<char *>(eu.values.data()),
+                   fSchema.size() * sizeof(double))) {
+      throw invalid_event_unit_input()
+          << "[ERROR]: Event unit input is truncated in the record for "
+          << to_str(eu.key);
+    }
+  }
+  batch.resize(NRead);
+  return NRead;
+}
+
+} // namespace systtools
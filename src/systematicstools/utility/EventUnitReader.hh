@@ -0,0 +1,79 @@
+#pragma once
+
+#include "systematicstools/interface/EventUnitRecord.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include <cstddef>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when an event unit input cannot be opened or read.
+NEW_SYSTTOOLS_EXCEPT(invalid_event_unit_input);
+
+///\brief Sequential source of event units for standalone drivers, e.g.
+/// systtools_run.
+class IEventUnitReader {
+public:
+  static constexpr size_t kUnknownNEventUnits =
+      std::numeric_limits<size_t>::max();
+
+  virtual EventUnitSchema const &GetSchema() const = 0;
+
+  ///\brief The total number of event units, if known before reading, or
+  /// kUnknownNEventUnits.
+  virtual size_t GetNEventUnits() const { return kUnknownNEventUnits; }
+
+  ///\brief Reads up to NMax event units into batch, re-using its storage.
+  ///
+  /// Returns the number read, and batch is resized to that. Returns 0 once
+  /// the input is exhausted.
+  virtual size_t ReadBatch(std::vector<EventUnitRecord> &batch,
+                           size_t NMax) = 0;
+
+  virtual ~IEventUnitReader() {}
+};
+
+///\brief Writes event units to the native, binary stand-in input format.
+///
+/// The stream starts with an 8 byte magic, "SYSTEU01", the number of
+/// variables, and the name of each, followed by one record per event unit of
+/// its EventKey and a double per variable. Values are written in host byte
+/// order.
+class BinaryEventUnitWriter {
+public:
+  BinaryEventUnitWriter(std::ostream &os, EventUnitSchema const &schema);
+
+  void Write(EventUnitRecord const &eu);
+
+private:
+  std::ostream &fOS;
+  size_t fNVariables;
+};
+
+///\brief Reads event units written by BinaryEventUnitWriter.
+class BinaryEventUnitReader : public IEventUnitReader {
+public:
+  BinaryEventUnitReader(std::string const &file_name);
+  BinaryEventUnitReader(std::istream &is);
+
+  EventUnitSchema const &GetSchema() const { return fSchema; }
+  size_t GetNEventUnits() const { return fNEventUnits; }
+
+  size_t ReadBatch(std::vector<EventUnitRecord> &batch, size_t NMax);
+
+private:
+  void ReadHeader();
+
+  std::unique_ptr<std::istream> fOwnedIS;
+  std::istream *fIS;
+  EventUnitSchema fSchema;
+  size_t fNEventUnits = kUnknownNEventUnits;
+};
+
+} // namespace systtools
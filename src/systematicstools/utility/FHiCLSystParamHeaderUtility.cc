@@ -12,10 +12,28 @@
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <string_view>
 #include <vector>
 
 namespace systtools {
 
+namespace {
+
+std::vector<double> ParseDescriptorValues(std::string_view values,
+                                          std::string const &descriptor) {
+  std::vector<double> outV;
+  std::string_view bad_token;
+  if (!TryParseToVect(values, ",", outV, false, true, &bad_token)) {
+    throw invalid_FHiCL_variation_descriptor()
+        << "[ERROR]: When parsing " << std::quoted(descriptor)
+        << ", failed to parse " << std::quoted(std::string(bad_token))
+        << " as a number.";
+  }
+  return outV;
+}
+
+} // namespace
+
 bool ParseFHiCLVariationDescriptor(fhicl::ParameterSet const &paramset,
                                    std::string const &CV_key,
                                    std::string const &vardescriptor_key,
@@ -35,16 +53,16 @@ bool ParseFHiCLVariationDescriptor(fhicl::ParameterSet const &paramset,
 
   if (var_descriptor.size()) {
     char fchar = var_descriptor.front();
-    std::string var_descriptor_trimmed =
-        var_descriptor.substr(1, var_descriptor.length() - 2);
-    trim(var_descriptor_trimmed);
+    std::string_view var_descriptor_trimmed =
+        TrimView(std::string_view(var_descriptor)
+                     .substr(1, var_descriptor.length() - 2));
     if (fchar == '(') { // Spline knots
       std::vector<double> range_step_values =
-          ParseToVect<double>(var_descriptor_trimmed, ",");
+          ParseDescriptorValues(var_descriptor_trimmed, var_descriptor);
       if (range_step_values.size() != 3) {
         throw invalid_FHiCL_variation_descriptor()
             << "[ERROR]: When parsing spline knot descriptor found "
-            << std::quoted(var_descriptor_trimmed)
+            << std::quoted(std::string(var_descriptor_trimmed))
             << ", but the descriptor must be in the format: "
                "(<start>,<end>,<step>).";
       }
@@ -56,10 +74,11 @@ bool ParseFHiCLVariationDescriptor(fhicl::ParameterSet const &paramset,
       }
       hdr.isSplineable = true;
     } else if (fchar == '[') { // Discrete tweaks
-      hdr.paramVariations = ParseToVect<double>(var_descriptor_trimmed, ",");
+      hdr.paramVariations =
+          ParseDescriptorValues(var_descriptor_trimmed, var_descriptor);
     } else if (fchar == '{') { // OneSigmaShifts
       std::vector<double> sigShifts =
-          ParseToVect<double>(var_descriptor_trimmed, ",");
+          ParseDescriptorValues(var_descriptor_trimmed, var_descriptor);
       if (sigShifts.size() == 1) {
         hdr.oneSigmaShifts[0] = -sigShifts.front();
         hdr.oneSigmaShifts[1] = sigShifts.front();
@@ -69,7 +88,7 @@ bool ParseFHiCLVariationDescriptor(fhicl::ParameterSet const &paramset,
       } else {
         throw invalid_FHiCL_variation_descriptor()
             << "[ERROR]: When parsing sigma shifts found "
-            << std::quoted(var_descriptor_trimmed)
+            << std::quoted(std::string(var_descriptor_trimmed))
             << ", but expected {sigma_both_natural_units}, or "
                "{sigma_low_natural_units, sigma_up_natural_units}.";
       }
@@ -98,6 +117,8 @@ bool ParseFHiCLVariationDescriptor(fhicl::ParameterSet const &paramset,
   } else { // Just use the central value every time
     hdr.isCorrection = true;
   }
+  // Knots are usually shared by many parameters.
+  hdr.paramVariations.Intern();
   return true;
 }
 
@@ -147,6 +168,7 @@ bool MakeFHiCLDefinedRandomVariations(fhicl::ParameterSet const &paramset,
         fabs(thr) * ((thr < 0) ? hdr.oneSigmaShifts[0] : hdr.oneSigmaShifts[1]);
     hdr.paramVariations.push_back(cv + shift);
   }
+  hdr.paramVariations.Intern();
 
   return true;
 }
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Bytes of dynamically allocated memory owned by an object, broken down
+/// by component, e.g. "headers", "maps", "splines", "event units".
+///
+/// MemoryFootprint methods and functions count the memory owned by an object,
+/// but not sizeof the object itself, which is counted by whatever contains it.
+/// Container sizes are estimated from their capacity, and so do not include
+/// allocator overheads.
+struct MemoryBreakdown {
+  std::map<std::string, size_t> Components;
+
+  void Add(std::string const &component, size_t bytes) {
+    Components[component] += bytes;
+  }
+  MemoryBreakdown &operator+=(MemoryBreakdown const &other) {
+    for (auto const &c : other.Components) {
+      Components[c.first] += c.second;
+    }
+    return *this;
+  }
+
+  size_t Get(std::string const &component) const {
+    auto it = Components.find(component);
+    return (it == Components.end()) ? 0 : it->second;
+  }
+  size_t Total() const {
+    size_t total = 0;
+    for (auto const &c : Components) {
+      total += c.second;
+    }
+    return total;
+  }
+
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << *this;
+    return ss.str();
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, MemoryBreakdown const &mb) {
+    for (auto const &c : mb.Components) {
+      os << "  " << std::setw(24) << std::left << c.first << std::right
+         << std::setw(16) << c.second << " B\n";
+    }
+    return os << "  " << std::setw(24) << std::left << "total" << std::right
+              << std::setw(16) << mb.Total() << " B" << std::endl;
+  }
+};
+
+///\brief Helpers for estimating the memory owned by standard containers.
+namespace footprint {
+
+///\brief Estimated per-node overhead of std::map and std::set: three pointers
+/// and the node colour.
+constexpr size_t kTreeNodeOverhead = 4 * sizeof(void *);
+
+template <typename T> inline size_t HeapBytes(std::vector<T> const &v) {
+  return v.capacity() * sizeof(T);
+}
+
+///\brief Zero for strings that fit in the small-string buffer.
+inline size_t HeapBytes(std::string const &s) {
+  char const *obj = reinterpret_cast<char const *>(&s);
+  bool is_local = (s.data() >= obj) && (s.data() < (obj + sizeof(s)));
+  return is_local ? 0 : (s.capacity() + 1);
+}
+
+inline size_t HeapBytes(std::vector<std::string> const &v) {
+  size_t bytes = v.capacity() * sizeof(std::string);
+  for (auto const &s : v) {
+    bytes += HeapBytes(s);
+  }
+  return bytes;
+}
+
+///\brief The memory used by the nodes of a std::map, not including memory
+/// owned by the keys and values.
+template <typename K, typename V, typename C, typename A>
+inline size_t NodeBytes(std::map<K, V, C, A> const &m) {
+  typedef typename std::map<K, V, C, A>::value_type value_type;
+  return m.size() * (kTreeNodeOverhead + sizeof(value_type));
+}
+
+} // namespace footprint
+
+} // namespace systtools
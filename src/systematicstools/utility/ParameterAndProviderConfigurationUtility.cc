@@ -53,4 +53,25 @@ param_header_map_t BuildParameterHeaders(fhicl::ParameterSet const &paramset,
 
   return headers;
 }
+
+param_header_map_t SelectProviderHeaders(param_header_map_t const &headers,
+                                         std::string const &ProviderFQName) {
+  param_header_map_t selected;
+  for (auto const &hdr_it : headers) {
+    if (hdr_it.second.ProviderFQName == ProviderFQName) {
+      selected.emplace_hint(selected.end(), hdr_it);
+    }
+  }
+  if (!selected.size()) {
+    throw invalid_parameter_name()
+        << "[ERROR]: No parameter headers are handled by a provider named "
+        << std::quoted(ProviderFQName);
+  }
+  return selected;
+}
+
+paramId_t GetNextFreeParamId(param_header_map_t const &headers) {
+  return headers.size() ? (headers.rbegin()->first + 1) : 0;
+}
+
 } // namespace systtools
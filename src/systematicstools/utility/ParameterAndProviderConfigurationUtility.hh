@@ -8,17 +8,55 @@
 
 #include "fhiclcpp/ParameterSet.h"
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
 #include <functional>
+#include <future>
 #include <memory>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace systtools {
 
 ///\brief Exception thrown when two ISystProviderTools have identical fully
 /// qualified (tool_name + instance_name) names.
 NEW_SYSTTOOLS_EXCEPT(ISystProvider_FQName_collision);
+///\brief Exception thrown when an ISystProviderTool builds a different number
+/// of parameters than it reported with GetNParametersFromToolConfig.
+NEW_SYSTTOOLS_EXCEPT(ISystProvider_parameter_count_mismatch);
+
+namespace detail {
+
+///\brief A generator of the seeds suggested to each configured provider,
+/// itself seeded from the clock.
+inline std::function<uint64_t()> MakeSeedSuggester() {
+  std::mt19937_64 generator(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+  std::uniform_int_distribution<uint64_t> distribution(0, 1E6);
+  return std::bind(distribution, generator);
+}
+
+///\brief Checks that no provider in providers already uses FQName.
+///
+///\note throws ISystProvider_FQName_collision if one does.
+template <typename T>
+void CheckFQNameUnused(std::vector<std::unique_ptr<T>> const &providers,
+                       std::string const &FQName) {
+  for (auto const &prov : providers) {
+    if (prov->GetFullyQualifiedName() == FQName) {
+      throw ISystProvider_FQName_collision()
+          << "[ERROR]:\t Provider with that name already exists, please "
+             "correct provider set (Hint: Use the 'unique_name' property "
+             "of the tool configuration table to disambiguate multiple "
+             "uses of the same tool).";
+    }
+  }
+}
+
+} // namespace detail
 
 ///\brief Builds map of SystProvider instance names and handled parameters from
 /// a ParameterHeaders FHiCL document.
@@ -29,6 +67,21 @@ param_header_map_t
 BuildParameterHeaders(fhicl::ParameterSet const &paramset,
                       std::string const &key = "syst_providers");
 
+///\brief Selects the headers of the parameters handled by a single
+/// ISystProviderTool instance.
+///
+/// Useful for writing the responses of one provider to a separate tree, see
+/// interpreters/ChunkedPrecalculatedResponseReader.hh
+param_header_map_t SelectProviderHeaders(param_header_map_t const &headers,
+                                         std::string const &ProviderFQName);
+
+///\brief Gets the first paramId_t not used by any header in headers.
+///
+/// Used as the syst_param_id argument of
+/// ConfigureISystProvidersFromToolConfig when configuring additional providers
+/// for an existing set of responses.
+paramId_t GetNextFreeParamId(param_header_map_t const &headers);
+
 ///\brief Builds map of SystProvider instances and handled parameters from a
 /// set of pre-configured providers
 ///
@@ -69,11 +122,7 @@ std::vector<std::unique_ptr<T>> ConfigureISystProvidersFromToolConfig(
     std::function<std::unique_ptr<T>(fhicl::ParameterSet const &)> InstanceBuilder,
     std::string const &key = "syst_providers", paramId_t syst_param_id = 0) {
 
-  // Instantiate RNGs for seed suggestion.
-  std::mt19937_64 generator(
-      std::chrono::steady_clock::now().time_since_epoch().count());
-  std::uniform_int_distribution<uint64_t> distribution(0, 1E6);
-  auto RNJesus = std::bind(distribution, generator);
+  auto RNJesus = detail::MakeSeedSuggester();
 
   std::vector<std::unique_ptr<T>> providers;
 
@@ -94,21 +143,98 @@ std::vector<std::unique_ptr<T>> ConfigureISystProvidersFromToolConfig(
     // build unique name
     std::string FQName = is->GetFullyQualifiedName();
 
-    // check that this unique name hasn't been used before.
-    for (auto const &prov : providers) {
-      if (prov->GetFullyQualifiedName() == FQName) {
-        throw ISystProvider_FQName_collision()
-            << "[ERROR]:\t Provider with that name already exists, please "
-               "correct provider set (Hint: Use the 'unique_name' property "
-               "of the tool configuration table to disambiguate multiple "
-               "uses of the same tool).";
-      }
-    }
+    detail::CheckFQNameUnused(providers, FQName);
     providers.emplace_back(std::move(is));
   }
   return providers;
 }
 
+///\brief As ConfigureISystProvidersFromToolConfig, but configures providers
+/// concurrently on up to NThreads threads.
+///
+/// Each provider is first asked for the number of parameters that it will
+/// build, with ISystProviderTool::GetNParametersFromToolConfig, so that
+/// parameter Ids can be assigned before any provider is configured. Providers
+/// that report a count are configured concurrently, those that cannot are
+/// configured in sequence, as Ids after them are only known once they have
+/// been configured. Seeds are suggested in the same order, and the assigned
+/// Ids are identical to those from ConfigureISystProvidersFromToolConfig.
+///
+/// NThreads = 0 uses std::thread::hardware_concurrency.
+///
+///\note throws ISystProvider_parameter_count_mismatch if a provider builds a
+/// different number of parameters than it reported.
+template <typename T = systtools::ISystProviderTool>
+std::vector<std::unique_ptr<T>>
+ConfigureISystProvidersFromToolConfigConcurrently(
+    fhicl::ParameterSet const &paramset,
+    std::function<std::unique_ptr<T>(fhicl::ParameterSet const &)> InstanceBuilder,
+    std::string const &key = "syst_providers", paramId_t syst_param_id = 0,
+    size_t NThreads = 0) {
+
+  auto RNJesus = detail::MakeSeedSuggester();
+
+  if (!NThreads) {
+    NThreads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  std::vector<std::unique_ptr<T>> providers;
+  std::vector<size_t> NParams;
+  std::deque<std::future<void>> configuring;
+
+  for (auto const &provkey : paramset.get<std::vector<std::string>>(key)) {
+    auto const &provider_cfg = paramset.get<fhicl::ParameterSet>(provkey);
+
+    std::unique_ptr<T> is = InstanceBuilder(provider_cfg);
+    is->SuggestSeed(RNJesus());
+
+    // build unique name
+    std::string FQName = is->GetFullyQualifiedName();
+
+    detail::CheckFQNameUnused(providers, FQName);
+
+    size_t NParam = is->GetNParametersFromToolConfig(provider_cfg);
+    T *prov = is.get();
+    providers.emplace_back(std::move(is));
+    NParams.push_back(NParam);
+
+    if (NParam == ISystProviderTool::kUnknownNParameters) {
+      // The next free Id is only known after configuration.
+      prov->ConfigureFromToolConfig(provider_cfg, syst_param_id);
+      syst_param_id += prov->GetSystMetaData().size();
+      continue;
+    }
+
+    while (configuring.size() >= NThreads) {
+      configuring.front().get();
+      configuring.pop_front();
+    }
+    configuring.push_back(std::async(
+        std::launch::async, [prov, provider_cfg, syst_param_id]() {
+          prov->ConfigureFromToolConfig(provider_cfg, syst_param_id);
+        }));
+    syst_param_id += NParam;
+  }
+
+  while (configuring.size()) {
+    configuring.front().get();
+    configuring.pop_front();
+  }
+
+  for (size_t p_it = 0; p_it < providers.size(); ++p_it) {
+    size_t NBuilt = providers[p_it]->GetSystMetaData().size();
+    if ((NParams[p_it] != ISystProviderTool::kUnknownNParameters) &&
+        (NParams[p_it] != NBuilt)) {
+      throw ISystProvider_parameter_count_mismatch()
+          << "[ERROR]: Provider "
+          << std::quoted(providers[p_it]->GetFullyQualifiedName())
+          << " reported that it would build " << NParams[p_it]
+          << " parameters, but built " << NBuilt;
+    }
+  }
+  return providers;
+}
+
 ///\brief Configures the set of ISystProviders from a Parameter Headers
 /// document.
 ///
@@ -141,16 +267,7 @@ std::vector<std::unique_ptr<T>> ConfigureISystProvidersFromParameterHeaders(
     // build unique name
     std::string FQName = is->GetFullyQualifiedName();
 
-    // check that this unique name hasn't been used before.
-    for (auto const &prov : providers) {
-      if (prov->GetFullyQualifiedName() == FQName) {
-        throw ISystProvider_FQName_collision()
-            << "[ERROR]:\t Provider with that name already exists, please "
-               "correct provider set (Hint: Use the 'unique_name' property "
-               "of the tool configuration table to disambiguate multiple "
-               "uses of the same tool).";
-      }
-    }
+    detail::CheckFQNameUnused(providers, FQName);
     providers.emplace_back(std::move(is));
   }
   return providers;
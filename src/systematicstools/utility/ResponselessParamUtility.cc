@@ -36,10 +36,13 @@ void FinalizeAndValidateDependentParameters(
     }
   }
 
-  resp_hdr.paramVariations.clear();
+  std::vector<double> indices;
   for (size_t i = 0; i < NVariations; ++i) {
-    resp_hdr.paramVariations.push_back(i);
+    indices.push_back(i);
   }
+  // Every response parameter with the same number of universes shares these.
+  resp_hdr.paramVariations = std::move(indices);
+  resp_hdr.paramVariations.Intern();
 }
 
 } // namespace systtools
@@ -0,0 +1,241 @@
+#include "systematicstools/utility/SyntheticResponseGenerator.hh"
+
+#include "systematicstools/utility/ResponselessParamUtility.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <thread>
+
+namespace systtools {
+
+namespace {
+
+///\brief SplitMix64, small and fast to seed, so that every event unit can
+/// have its own stream.
+struct SplitMix64 {
+  uint64_t state;
+
+  explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+  uint64_t operator()() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  ///\brief Uniform in [0, 1).
+  double Uniform() { return double((*this)() >> 11) * 0x1.0p-53; }
+  ///\brief Uniform in [-w, w).
+  double Symmetric(double w) { return w * (2 * Uniform() - 1); }
+};
+
+uint64_t StreamSeed(uint64_t seed, uint64_t stream) {
+  // Decorrelate neighbouring streams by passing the index through the mixer.
+  return SplitMix64(seed ^ SplitMix64(stream)())();
+}
+
+} // namespace
+
+SystMetaData BuildSyntheticSystMetaData(SyntheticHeaderConfig const &cfg) {
+  SystMetaData md;
+  SplitMix64 rng(StreamSeed(cfg.Seed, 0));
+  paramId_t pid = cfg.FirstParamId;
+
+  auto NewHeader = [&](std::string const &type, size_t i) {
+    md.emplace_back();
+    md.back().prettyName = "synthetic_" + type + "_" + std::to_string(i);
+    md.back().systParamId = pid++;
+    md.back().centralParamValue = 0;
+    return &md.back();
+  };
+  // All spline and global parameters share the same knots.
+  SharedVector<double> knots;
+  for (size_t k_it = 0; k_it < cfg.NKnots; ++k_it) {
+    knots.push_back((cfg.NKnots > 1) ? (-3.0 + 6.0 * k_it / (cfg.NKnots - 1))
+                                     : 0);
+  }
+  knots.Intern();
+  auto Throws = [&]() {
+    // Sum of uniforms, approximately gaussian with unit variance.
+    std::vector<double> throws;
+    for (size_t t_it = 0; t_it < cfg.NThrows; ++t_it) {
+      double t = 0;
+      for (size_t s_it = 0; s_it < 12; ++s_it) {
+        t += rng.Uniform();
+      }
+      throws.push_back(t - 6);
+    }
+    return throws;
+  };
+
+  for (size_t p_it = 0; p_it < cfg.NSplineParams; ++p_it) {
+    SystParamHeader *hdr = NewHeader("spline", p_it);
+    hdr->isSplineable = true;
+    hdr->oneSigmaShifts = {{-1, 1}};
+    hdr->paramVariations = knots;
+  }
+  for (size_t p_it = 0; p_it < cfg.NMultisimParams; ++p_it) {
+    SystParamHeader *hdr = NewHeader("multisim", p_it);
+    hdr->isRandomlyThrown = true;
+    hdr->oneSigmaShifts = {{-1, 1}};
+    hdr->paramVariations = Throws();
+  }
+  for (size_t p_it = 0; p_it < cfg.NCorrectionParams; ++p_it) {
+    SystParamHeader *hdr = NewHeader("correction", p_it);
+    hdr->isCorrection = true;
+    hdr->centralParamValue = 1;
+  }
+  for (size_t p_it = 0; p_it < cfg.NGlobalParams; ++p_it) {
+    SystParamHeader *hdr = NewHeader("global", p_it);
+    hdr->isSplineable = true;
+    hdr->differsEventByEvent = false;
+    hdr->oneSigmaShifts = {{-1, 1}};
+    hdr->paramVariations = knots;
+    double a = rng.Symmetric(0.1);
+    for (double x : hdr->paramVariations.get()) {
+      hdr->responses.push_back(std::exp(a * x));
+    }
+  }
+  if (cfg.NResponselessParams) {
+    std::string response_name = NewHeader("response", 0)->prettyName;
+    md.back().isRandomlyThrown = true;
+    paramId_t response_pid = md.back().systParamId;
+
+    std::vector<std::string> dependent_names;
+    for (size_t p_it = 0; p_it < cfg.NResponselessParams; ++p_it) {
+      SystParamHeader *hdr = NewHeader("responseless", p_it);
+      hdr->isRandomlyThrown = true;
+      hdr->isResponselessParam = true;
+      hdr->responseParamId = response_pid;
+      hdr->oneSigmaShifts = {{-1, 1}};
+      hdr->paramVariations = Throws();
+      dependent_names.push_back(hdr->prettyName);
+    }
+    FinalizeAndValidateDependentParameters(md, response_name,
+                                           dependent_names);
+  }
+
+  if (!Validate(md, false)) {
+    throw invalid_SystMetaData()
+        << "[ERROR]: Synthetic parameter headers failed validation.";
+  }
+  return md;
+}
+
+param_header_map_t
+BuildSyntheticParameterHeaders(SyntheticHeaderConfig const &cfg) {
+  param_header_map_t headers;
+  for (auto const &hdr : BuildSyntheticSystMetaData(cfg)) {
+    headers.emplace(param_header_map_t::key_type{hdr.systParamId},
+                    param_header_map_t::mapped_type{cfg.ProviderFQName, hdr});
+  }
+  return headers;
+}
+
+SyntheticResponseGenerator::SyntheticResponseGenerator(
+    SystMetaData const &md, SyntheticResponseConfig const &cfg)
+    : fConfig(cfg) {
+  Build(md);
+}
+
+SyntheticResponseGenerator::SyntheticResponseGenerator(
+    param_header_map_t const &headers, SyntheticResponseConfig const &cfg)
+    : fConfig(cfg) {
+  SystMetaData md;
+  for (auto const &hdr_it : headers) {
+    md.push_back(hdr_it.second.Header);
+  }
+  Build(md);
+}
+
+void SyntheticResponseGenerator::Build(SystMetaData const &md) {
+  // The responses of a response parameter depend on the variations of all of
+  // its responseless parameters.
+  std::map<paramId_t, std::vector<double>> responseless_x;
+  for (auto const &hdr : md) {
+    if (!hdr.isResponselessParam) {
+      continue;
+    }
+    std::vector<double> &x = responseless_x[hdr.responseParamId];
+    x.resize(std::max(x.size(), hdr.paramVariations.size()), 0);
+    for (size_t v_it = 0; v_it < hdr.paramVariations.size(); ++v_it) {
+      x[v_it] += hdr.paramVariations[v_it];
+    }
+  }
+
+  for (auto const &hdr : md) {
+    if (!hdr.differsEventByEvent || hdr.isResponselessParam) {
+      continue;
+    }
+    Param p{hdr.systParamId, {}};
+    if (hdr.isCorrection) {
+      p.x.push_back(hdr.centralParamValue);
+    } else if (responseless_x.count(hdr.systParamId)) {
+      p.x = responseless_x[hdr.systParamId];
+    } else {
+      p.x = hdr.paramVariations;
+    }
+    fParams.push_back(std::move(p));
+  }
+}
+
+void SyntheticResponseGenerator::GenerateEventUnit(
+    size_t eu, event_unit_response_t &eur) const {
+  SplitMix64 rng(StreamSeed(fConfig.Seed, eu + 1));
+
+  size_t NResponses = 0;
+  for (Param const &p : fParams) {
+    if (rng.Uniform() >= fConfig.ParamOccupancy) {
+      continue;
+    }
+    if (NResponses == eur.size()) {
+      eur.emplace_back();
+    }
+    ParamResponses &pr = eur[NResponses++];
+    pr.pid = p.pid;
+    pr.responses.resize(p.x.size());
+    double a = rng.Symmetric(fConfig.ResponseSpread);
+    for (size_t r_it = 0; r_it < p.x.size(); ++r_it) {
+      // exp(u) to second order, which is positive for all u and much cheaper.
+      double u = a * p.x[r_it];
+      pr.responses[r_it] = 1 + u * (1 + 0.5 * u);
+    }
+  }
+  eur.resize(NResponses);
+}
+
+void SyntheticResponseGenerator::Generate(size_t NUnits, size_t first_unit,
+                                          EventResponse &er) const {
+  er.resize(NUnits);
+
+  size_t NThreads = fConfig.NThreads ? fConfig.NThreads
+                                     : std::thread::hardware_concurrency();
+  NThreads = std::min(std::max(NThreads, size_t(1)),
+                      NUnits / std::max(fConfig.MinUnitsPerThread, size_t(1)));
+
+  auto GenerateRange = [&](size_t begin, size_t end) {
+    for (size_t eu_it = begin; eu_it < end; ++eu_it) {
+      GenerateEventUnit(first_unit + eu_it, er[eu_it]);
+    }
+  };
+
+  if (NThreads < 2) {
+    GenerateRange(0, NUnits);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  size_t NPerThread = (NUnits + NThreads - 1) / NThreads;
+  for (size_t t_it = 0; t_it < NThreads; ++t_it) {
+    size_t begin = std::min(NUnits, t_it * NPerThread);
+    size_t end = std::min(NUnits, begin + NPerThread);
+    threads.emplace_back(GenerateRange, begin, end);
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+} // namespace systtools
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "systematicstools/interface/EventResponse_product.hh"
+#include "systematicstools/interface/SystMetaData.hh"
+#include "systematicstools/interface/types.hh"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Describes the mix of parameter headers built by
+/// BuildSyntheticSystMetaData.
+///
+/// Parameter Ids are assigned contiguously from FirstParamId, in the order:
+/// spline, multisim, correction, global, and then, if NResponselessParams is
+/// non-zero, a single multisim response parameter followed by the
+/// responseless parameters that express their response through it.
+struct SyntheticHeaderConfig {
+  size_t NSplineParams = 10;
+  ///\brief Randomly thrown, non-splineable parameters.
+  size_t NMultisimParams = 2;
+  size_t NCorrectionParams = 1;
+  ///\brief Splineable parameters that do not differ event by event, their
+  /// responses are stored in the header.
+  size_t NGlobalParams = 1;
+  size_t NResponselessParams = 0;
+  ///\brief Spline knots, evenly spaced in [-3, 3].
+  size_t NKnots = 7;
+  ///\brief Throws per multisim and responseless parameter.
+  size_t NThrows = 100;
+  paramId_t FirstParamId = 0;
+  std::string ProviderFQName = "synthetic";
+  uint64_t Seed = 0;
+};
+
+///\brief Builds a set of synthetic parameter headers.
+///
+///\note Throws invalid_SystMetaData if the result fails Validate, which
+/// indicates a bug in the generator.
+SystMetaData BuildSyntheticSystMetaData(SyntheticHeaderConfig const &);
+
+///\brief Builds a set of synthetic parameter headers, owned by
+/// SyntheticHeaderConfig::ProviderFQName.
+param_header_map_t
+BuildSyntheticParameterHeaders(SyntheticHeaderConfig const &);
+
+struct SyntheticResponseConfig {
+  ///\brief Probability that an event-by-event parameter has a response for an
+  /// event unit, i.e. the mean fraction of parameters affecting each unit.
+  double ParamOccupancy = 1;
+  ///\brief Responses to a parameter value x are exp(a * x), to second order,
+  /// with a drawn uniformly from [-ResponseSpread, ResponseSpread] for each
+  /// event unit and parameter.
+  double ResponseSpread = 0.1;
+  uint64_t Seed = 0;
+  ///\brief Maximum number of threads used by Generate, 0 uses
+  /// std::thread::hardware_concurrency.
+  size_t NThreads = 0;
+  ///\brief Minimum number of event units generated per thread.
+  size_t MinUnitsPerThread = 4096;
+};
+
+///\brief Generates synthetic EventResponses to an existing set of parameter
+/// headers, for benchmarking and scale testing.
+///
+/// Every event unit is generated from its own random stream, seeded from
+/// SyntheticResponseConfig::Seed and its index, so the response for an event
+/// unit does not depend on the range it was generated in, or on the number of
+/// threads used. Large datasets can be generated in independent chunks.
+///
+/// Responses are only generated for parameters that differ event by event and
+/// are not responseless. Weight responses are always positive.
+class SyntheticResponseGenerator {
+public:
+  SyntheticResponseGenerator(SystMetaData const &,
+                             SyntheticResponseConfig const & = {});
+  SyntheticResponseGenerator(param_header_map_t const &,
+                             SyntheticResponseConfig const & = {});
+
+  ///\brief Generates event units [first_unit, first_unit + NUnits).
+  EventResponse Generate(size_t NUnits, size_t first_unit = 0) const {
+    EventResponse er;
+    Generate(NUnits, first_unit, er);
+    return er;
+  }
+  ///\brief Generates event units [first_unit, first_unit + NUnits) into er,
+  /// re-using its storage where possible.
+  void Generate(size_t NUnits, size_t first_unit, EventResponse &er) const;
+
+  ///\brief Generates event unit eu into eur.
+  void GenerateEventUnit(size_t eu, event_unit_response_t &eur) const;
+
+private:
+  void Build(SystMetaData const &);
+
+  struct Param {
+    paramId_t pid;
+    ///\brief The parameter value of each response.
+    std::vector<double> x;
+  };
+
+  SyntheticResponseConfig fConfig;
+  std::vector<Param> fParams;
+};
+
+} // namespace systtools
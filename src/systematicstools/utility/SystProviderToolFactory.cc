@@ -0,0 +1,63 @@
+#include "systematicstools/utility/SystProviderToolFactory.hh"
+
+#include <iomanip>
+#include <map>
+#include <mutex>
+
+namespace systtools {
+
+namespace {
+
+struct SystProviderToolRegistry {
+  std::mutex mutex;
+  std::map<std::string, SystProviderToolBuilder> builders;
+};
+
+SystProviderToolRegistry &GetRegistry() {
+  static SystProviderToolRegistry registry;
+  return registry;
+}
+
+} // namespace
+
+void RegisterSystProviderTool(std::string const &tool_type,
+                              SystProviderToolBuilder builder) {
+  SystProviderToolRegistry &reg = GetRegistry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.builders[tool_type] = std::move(builder);
+}
+
+std::vector<std::string> GetRegisteredSystProviderTools() {
+  SystProviderToolRegistry &reg = GetRegistry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::vector<std::string> tool_types;
+  for (auto const &b : reg.builders) {
+    tool_types.push_back(b.first);
+  }
+  return tool_types;
+}
+
+std::unique_ptr<ISystProviderTool>
+MakeSystProviderTool(fhicl::ParameterSet const &ps) {
+  std::string tool_type = ps.get<std::string>("tool_type");
+
+  SystProviderToolBuilder builder;
+  {
+    SystProviderToolRegistry &reg = GetRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto it = reg.builders.find(tool_type);
+    if (it == reg.builders.end()) {
+      auto ex = unknown_syst_provider_tool_type();
+      ex << "[ERROR]: No syst provider tool registered with tool_type: "
+         << std::quoted(tool_type) << ", registered tool_types are: {";
+      for (auto const &b : reg.builders) {
+        ex << " " << std::quoted(b.first);
+      }
+      throw ex << " }.";
+    }
+    builder = it->second;
+  }
+  return builder(ps);
+}
+
+} // namespace systtools
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "systematicstools/interface/ISystProviderTool.hh"
+
+#include "systematicstools/utility/exceptions.hh"
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Exception raised when a provider is requested with a tool_type that
+/// has not been registered.
+NEW_SYSTTOOLS_EXCEPT(unknown_syst_provider_tool_type);
+
+typedef std::function<std::unique_ptr<ISystProviderTool>(
+    fhicl::ParameterSet const &)>
+    SystProviderToolBuilder;
+
+///\brief Registers a builder for ISystProviderTool instances with the given
+/// tool_type, for use outside of art, replacing any previous registration.
+void RegisterSystProviderTool(std::string const &tool_type,
+                              SystProviderToolBuilder builder);
+
+///\brief Registers T, which must be constructible from a
+/// fhicl::ParameterSet, as tool_type.
+template <typename T>
+void RegisterSystProviderTool(std::string const &tool_type) {
+  RegisterSystProviderTool(tool_type, [](fhicl::ParameterSet const &ps) {
+    return std::unique_ptr<ISystProviderTool>(std::make_unique<T>(ps));
+  });
+}
+
+std::vector<std::string> GetRegisteredSystProviderTools();
+
+///\brief Instantiates the registered tool named by the tool_type key of ps.
+///
+/// Can be passed as the InstanceBuilder of
+/// ConfigureISystProvidersFromToolConfig and
+/// ConfigureISystProvidersFromParameterHeaders.
+///
+///\note throws unknown_syst_provider_tool_type if no such tool is registered.
+std::unique_ptr<ISystProviderTool>
+MakeSystProviderTool(fhicl::ParameterSet const &ps);
+
+} // namespace systtools
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "systematicstools/utility/EventUnitReader.hh"
+
+#include "TFile.h"
+#include "TLeaf.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace systtools {
+
+///\brief Reads event units from the scalar leaves of a ROOT TTree.
+///
+/// Each requested variable is read from the first element of the leaf of the
+/// same name, whatever its type. If the tree has run, subrun, and event
+/// leaves, they are used for the EventKey of each entry, with consecutive
+/// entries from the same event numbered as successive units. Otherwise the
+/// entry number is used as the event number.
+///
+///\note Only the branches of the requested variables and keys are read.
+class TTreeEventUnitReader : public IEventUnitReader {
+public:
+  TTreeEventUnitReader(std::string const &file_name,
+                       std::string const &tree_name,
+                       std::vector<std::string> const &variables)
+      : fSchema(variables) {
+    // Owned from here, so that it is closed if construction fails.
+    fFile.reset(TFile::Open(file_name.c_str()));
+    if (!fFile || !fFile->IsOpen()) {
+      throw invalid_event_unit_input()
+          << "[ERROR]: Failed to open input file named: "
+          << std::quoted(file_name);
+    }
+    fFile->GetObject(tree_name.c_str(), fTree);
+    if (!fTree) {
+      throw invalid_event_unit_input()
+          << "[ERROR]: Failed to get TTree named: " << std::quoted(tree_name)
+          << " from file named: " << std::quoted(file_name);
+    }
+
+    fTree->SetBranchStatus("*", false);
+    for (std::string const &var : variables) {
+      fLeaves.push_back(EnableLeaf(var));
+      if (!fLeaves.back()) {
+        throw invalid_event_unit_input()
+            << "[ERROR]: TTree " << std::quoted(tree_name)
+            << " has no leaf named " << std::quoted(var);
+      }
+    }
+    fRunLeaf = EnableLeaf("run");
+    fSubRunLeaf = EnableLeaf("subrun");
+    fEventLeaf = EnableLeaf("event");
+    if (!fRunLeaf || !fSubRunLeaf || !fEventLeaf) {
+      fRunLeaf = fSubRunLeaf = fEventLeaf = nullptr;
+    }
+  }
+  TTreeEventUnitReader(TTreeEventUnitReader const &) = delete;
+  TTreeEventUnitReader &operator=(TTreeEventUnitReader const &) = delete;
+
+  EventUnitSchema const &GetSchema() const { return fSchema; }
+  size_t GetNEventUnits() const { return size_t(fTree->GetEntries()); }
+
+  size_t ReadBatch(std::vector<EventUnitRecord> &batch, size_t NMax) {
+    size_t NEntries = GetNEventUnits();
+    size_t NRead = std::min(NMax, NEntries - fNextEntry);
+    batch.resize(NRead);
+    for (size_t e_it = 0; e_it < NRead; ++e_it, ++fNextEntry) {
+      fTree->GetEntry(fNextEntry);
+      EventUnitRecord &eu = batch[e_it];
+      eu.key = GetKey();
+      eu.values.resize(fLeaves.size());
+      for (size_t v_it = 0; v_it < fLeaves.size(); ++v_it) {
+        eu.values[v_it] = fLeaves[v_it]->GetValue(0);
+      }
+    }
+    return NRead;
+  }
+
+private:
+  TLeaf *EnableLeaf(std::string const &name) {
+    TLeaf *leaf = fTree->GetLeaf(name.c_str());
+    if (leaf) {
+      fTree->SetBranchStatus(name.c_str(), true);
+    }
+    return leaf;
+  }
+
+  EventKey GetKey() {
+    if (!fEventLeaf) {
+      return EventKey{0, 0, uint32_t(fNextEntry), 0};
+    }
+    EventKey key{uint32_t(fRunLeaf->GetValue(0)),
+                 uint32_t(fSubRunLeaf->GetValue(0)),
+                 uint32_t(fEventLeaf->GetValue(0)), 0};
+    if (fNextEntry && (key.run == fLastKey.run) &&
+        (key.subrun == fLastKey.subrun) && (key.event == fLastKey.event)) {
+      key.unit = fLastKey.unit + 1;
+    }
+    fLastKey = key;
+    return key;
+  }
+
+  ///\brief Closed on destruction, which also deletes fTree.
+  std::unique_ptr<TFile> fFile;
+  TTree *fTree = nullptr;
+  EventUnitSchema fSchema;
+  std::vector<TLeaf *> fLeaves;
+  TLeaf *fRunLeaf = nullptr;
+  TLeaf *fSubRunLeaf = nullptr;
+  TLeaf *fEventLeaf = nullptr;
+  size_t fNextEntry = 0;
+  EventKey fLastKey{0, 0, 0, 0};
+};
+
+} // namespace systtools
@@ -2,50 +2,229 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
 #include <iostream>
 #include <locale>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace systtools {
 
-template <typename T> inline T str2T(std::string const &str) {
-  std::istringstream stream(str);
-  T d;
-  stream >> d;
+///\brief Removes leading and trailing whitespace from a view.
+inline std::string_view TrimView(std::string_view s) {
+  size_t first = 0;
+  while ((first < s.size()) && std::isspace((unsigned char)s[first])) {
+    ++first;
+  }
+  size_t last = s.size();
+  while ((last > first) && std::isspace((unsigned char)s[last - 1])) {
+    --last;
+  }
+  return s.substr(first, last - first);
+}
 
-  if (stream.fail()) {
-    std::cerr << "[WARN]: Failed to parse string: " << str
-              << " as requested type." << std::endl;
-    return T();
+namespace detail {
+template <typename T>
+inline char const *FromChars(char const *first, char const *last, T &value) {
+  if constexpr (std::is_floating_point<T>::value) {
+#ifdef __cpp_lib_to_chars
+    auto res = std::from_chars(first, last, value);
+    return (res.ec == std::errc()) ? res.ptr : first;
+#else
+    // Without floating point from_chars, copy to a terminated stack buffer
+    // for strtod.
+    char buf[64];
+    size_t n = std::min(size_t(last - first), sizeof(buf) - 1);
+    std::copy(first, first + n, buf);
+    buf[n] = '\0';
+    char *end = nullptr;
+    errno = 0;
+    long double v = std::strtold(buf, &end);
+    if ((end == buf) || (errno == ERANGE)) {
+      return first;
+    }
+    value = T(v);
+    return first + (end - buf);
+#endif
+  } else {
+    auto res = std::from_chars(first, last, value);
+    return (res.ec == std::errc()) ? res.ptr : first;
   }
+}
 
-  return d;
+///\brief Parses the number at the start of str, which must not start with
+/// whitespace, into value, returning the end of the number, or nullptr,
+/// leaving value untouched, if str does not start with one.
+template <typename T>
+inline char const *ParseLeadingNumber(std::string_view str, T &value) {
+  if ((str.size() > 1) && (str.front() == '+') && (str[1] != '-') &&
+      (str[1] != '+')) {
+    str.remove_prefix(1);
+  }
+  T parsed = T();
+  char const *end = FromChars(str.data(), str.data() + str.size(), parsed);
+  if (end == str.data()) {
+    return nullptr;
+  }
+  value = parsed;
+  return end;
 }
 
-template <> inline bool str2T<bool>(std::string const &str) {
-  if ((str == "true") || (str == "True") || (str == "TRUE") || (str == "1")) {
+inline bool ParseBoolWord(std::string_view str, bool &value) {
+  if ((str == "true") || (str == "True") || (str == "TRUE") ||
+      (str == "1")) {
+    value = true;
     return true;
   }
-
   if ((str == "false") || (str == "False") || (str == "FALSE") ||
       (str == "0")) {
-    return false;
+    value = false;
+    return true;
   }
+  return false;
+}
+} // namespace detail
 
-  std::istringstream stream(str);
-  bool d;
-  stream >> d;
+///\brief Parses a single value from a string, without allocating for
+/// arithmetic types.
+///
+/// Leading and trailing whitespace is ignored, as is a leading `+` on numbers.
+/// Returns false, leaving value untouched, if str does not hold exactly one
+/// value of type T. As for stream extraction, std::string values are the
+/// first whitespace-delimited word, and bools may also be given as
+/// true/false.
+template <typename T> inline bool ParseValue(std::string_view str, T &value) {
+  if constexpr (std::is_same<T, bool>::value) {
+    return detail::ParseBoolWord(TrimView(str), value);
+  } else if constexpr (std::is_arithmetic<T>::value) {
+    str = TrimView(str);
+    T parsed = T();
+    if (detail::ParseLeadingNumber(str, parsed) != (str.data() + str.size())) {
+      return false;
+    }
+    value = parsed;
+    return true;
+  } else if constexpr (std::is_same<T, std::string>::value ||
+                       std::is_same<T, std::string_view>::value) {
+    str = TrimView(str);
+    size_t end = 0;
+    while ((end < str.size()) && !std::isspace((unsigned char)str[end])) {
+      ++end;
+    }
+    if (!end) {
+      return false;
+    }
+    value = T(str.substr(0, end));
+    return true;
+  } else {
+    std::istringstream stream{std::string(str)};
+    stream >> value;
+    return !stream.fail();
+  }
+}
 
-  if (stream.fail()) {
+///\brief Parses the value at the start of a string, as stream extraction
+/// does, warning and returning a default constructed T if there is none.
+///
+/// Unlike ParseValue, anything following the value is ignored, so "1.5abc"
+/// gives 1.5 as a double, and "1.5" gives 1 as an int. Use ParseValue to
+/// reject such input.
+template <typename T> inline T str2T(std::string_view str) {
+  T d = T();
+  bool parsed;
+  if constexpr (std::is_same<T, bool>::value) {
+    // Stream extraction of bools reads a number, which must be 0 or 1.
+    str = TrimView(str);
+    parsed = detail::ParseBoolWord(str, d);
+    long l = -1;
+    if (!parsed && detail::ParseLeadingNumber(str, l)) {
+      parsed = ((l == 0) || (l == 1));
+      d = (l == 1);
+    }
+  } else if constexpr (std::is_arithmetic<T>::value) {
+    parsed = detail::ParseLeadingNumber(TrimView(str), d);
+  } else {
+    parsed = ParseValue(str, d);
+  }
+  if (!parsed) {
     std::cerr << "[WARN]: Failed to parse string: " << str
               << " as requested type." << std::endl;
+    return T();
+  }
+  return d;
+}
+
+///\brief Iterates over the delim-separated tokens of a string without
+/// copying them.
+///
+/// Empty tokens are skipped unless PushEmpty, except that a trailing
+/// delimiter never produces an empty token. The views refer to the input, so
+/// it must outlive the Tokenizer and the tokens.
+class Tokenizer {
+public:
+  Tokenizer(std::string_view inp, std::string_view delim,
+            bool PushEmpty = false, bool trimInput = true)
+      : fInp(trimInput ? TrimView(inp) : inp), fDelim(delim),
+        fPushEmpty(PushEmpty) {}
+
+  bool Next(std::string_view &token) {
+    while (!fAtEnd) {
+      size_t next = fDelim.size() ? fInp.find(fDelim, fPos)
+                                  : std::string_view::npos;
+      if (next == std::string_view::npos) {
+        fAtEnd = true;
+        if (fPos == fInp.size()) {
+          return false;
+        }
+      }
+      size_t prev = fPos;
+      fPos = fAtEnd ? fInp.size() : (next + fDelim.size());
+      if (fPushEmpty || (next != prev)) {
+        token = fInp.substr(prev, next - prev);
+        return true;
+      }
+    }
     return false;
   }
 
-  return d;
+private:
+  std::string_view fInp;
+  std::string_view fDelim;
+  bool fPushEmpty;
+  size_t fPos = 0;
+  bool fAtEnd = false;
+};
+
+///\brief Parses each delim-separated token of inp as a T, appending them to
+/// outV.
+///
+/// Returns false at the first token that fails to parse, setting bad_token
+/// to it if given.
+template <typename T>
+inline bool TryParseToVect(std::string_view inp, std::string_view delim,
+                           std::vector<T> &outV, bool PushEmpty = false,
+                           bool trimInput = true,
+                           std::string_view *bad_token = nullptr) {
+  Tokenizer tokens(inp, delim, PushEmpty, trimInput);
+  std::string_view token;
+  while (tokens.Next(token)) {
+    T value = T();
+    if (!ParseValue(token, value)) {
+      if (bad_token) {
+        *bad_token = token;
+      }
+      return false;
+    }
+    outV.push_back(std::move(value));
+  }
+  return true;
 }
+
 template <typename T>
 inline void AppendVect(std::vector<T> &target, std::vector<T> const &toApp) {
   for (size_t i = 0; i < toApp.size(); ++i) {
@@ -74,30 +253,14 @@ static inline void trim(std::string &s) {
 }
 
 template <typename T>
-inline std::vector<T>
-ParseToVect(std::string const &inp, std::string const &delim,
-            bool PushEmpty = false, bool trimInput = true) {
-  std::string inpCpy = inp;
-  if (trimInput) {
-    trim(inpCpy);
-  }
-  size_t nextOccurence = 0;
-  size_t prevOccurence = 0;
+inline std::vector<T> ParseToVect(std::string_view inp, std::string_view delim,
+                                  bool PushEmpty = false,
+                                  bool trimInput = true) {
   std::vector<T> outV;
-  bool AtEnd = false;
-  while (!AtEnd) {
-    nextOccurence = inpCpy.find(delim, prevOccurence);
-    if (nextOccurence == std::string::npos) {
-      if (prevOccurence == inpCpy.length()) {
-        break;
-      }
-      AtEnd = true;
-    }
-    if (PushEmpty || (nextOccurence != prevOccurence)) {
-      outV.push_back(str2T<T>(
-          inpCpy.substr(prevOccurence, (nextOccurence - prevOccurence))));
-    }
-    prevOccurence = nextOccurence + delim.size();
+  Tokenizer tokens(inp, delim, PushEmpty, trimInput);
+  std::string_view token;
+  while (tokens.Next(token)) {
+    outV.push_back(str2T<T>(token));
   }
   return outV;
 }